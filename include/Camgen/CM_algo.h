@@ -12,8 +12,12 @@
 #ifndef CAMGEN_CM_ALGO_H_
 #define CAMGEN_CM_ALGO_H_
 
+#include <map>
+#include <set>
 #include <Camgen/process.h>
 #include <Camgen/license_print.h>
+#include <Camgen/mt_utils.h>
+#include <Camgen/bin_io.h>
 #include <Camgen/def_args.h>
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -22,7 +26,10 @@
  * of process trees, which can be selected via the set_process member function,  *
  * and then evaluated by calling evaluate(). It allows access to the external    *
  * particle's phase space by calling get_phase_space(), swapping degrees of      *
- * freedom, counting diagrams and memory usage etc.                              *
+ * freedom, counting diagrams and memory usage etc. By default, all algorithms   *
+ * of the same type share the static current data of the current tree; calling  *
+ * localise() or copy-constructing an algorithm moves the currents to private    *
+ * storage, so that distinct copies can be evaluated concurrently.              *
  *                                                                               *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
@@ -58,6 +65,12 @@ namespace Camgen
 
 	    typedef typename tree_type::current_tree_type current_tree_type;
 
+	    /* Current type and current iterator definitions: */
+
+	    typedef typename tree_type::current_type current_type;
+	    typedef typename tree_type::current_iterator current_iterator;
+	    typedef typename tree_type::const_current_iterator const_current_iterator;
+
 	    /* Tree iterator type definitions: */
 
 	    typedef typename std::list<tree_type>::iterator tree_iterator;
@@ -95,6 +108,7 @@ namespace Camgen
 		N_final=std::min(n,N_external-1);
 		tree_type::initialise(N_final);
 		reset_ordering();
+		register_instance();
 	    }
 
 	    /// Constructor specifying the process.
@@ -113,6 +127,65 @@ namespace Camgen
 		tree_type::initialise(N_final);
 		reset_ordering();
 		process_type::add_process(processes,str);
+		register_instance();
+	    }
+
+	    /// Copy constructor.
+	    /// The copy refers to its own instance-local copy of the current
+	    /// data (see localise()), so that it can be evaluated in a different
+	    /// thread than the argument algorithm. Note that the phase space
+	    /// objects of the copy are newly allocated.
+
+	    CM_algorithm(const CM_algorithm<model_t,N_in,N_out>& other)
+	    {
+		copy(other);
+		register_instance();
+	    }
+
+	    /// Destructor.
+
+	    ~CM_algorithm()
+	    {
+		scoped_lock lock(build_mutex);
+		instances.erase(this);
+	    }
+
+	    /// Assignment operator, turning the algorithm into an instance-local
+	    /// copy of the argument.
+
+	    CM_algorithm<model_t,N_in,N_out>& operator = (const CM_algorithm<model_t,N_in,N_out>& other)
+	    {
+		if(this!=&other)
+		{
+		    copy(other);
+		}
+		return *this;
+	    }
+
+	    /// Moves the current data of the process trees to private storage.
+	    /// After this call, the amplitude evaluation does not modify data
+	    /// shared with other algorithm instances, and distinct localised
+	    /// algorithms may be evaluated concurrently. Phase space addresses
+	    /// obtained before the call are no longer used by the algorithm.
+
+	    void localise()
+	    {
+		if(local_currents.empty())
+		{
+		    scoped_lock lock(build_mutex);
+		    local_currents.assign(current_tree_type::begin(),current_tree_type::end());
+		    for(tree_iterator it=trees.begin();it!=trees.end();++it)
+		    {
+			it->relocate(current_tree_type::begin(),local_currents.begin());
+		    }
+		}
+	    }
+
+	    /// Returns whether the algorithm owns instance-local current data.
+
+	    bool is_local() const
+	    {
+		return !local_currents.empty();
 	    }
 
 	    /// Subprocess insertion method.
@@ -279,11 +352,14 @@ namespace Camgen
 		    if(process_it!=processes.end())
 		    {
 			tree_it=process_it->insert_tree(trees,tree_it);
+			allocate_currents(tree_it);
 			tree_it->build();
 			tree_it->clean();
 			tree_it->set_Fermi_signs();
 			tree_it->initialise_currents();
 			tree_it->assign_momenta();
+			tree_it->compile();
+			localise_tree(tree_it);
 			return process_it;
 		    }
 
@@ -305,11 +381,14 @@ namespace Camgen
 		if(process_it != processes.end())
 		{
 		    tree_it=process_it->insert_tree(trees,trees.end());
+		    allocate_currents(tree_it);
 		    tree_it->build();
 		    tree_it->clean();
 		    tree_it->set_Fermi_signs();
 		    tree_it->initialise_currents();
 		    tree_it->assign_momenta();
+		    tree_it->compile();
+		    localise_tree(tree_it);
 		}
 
 		/* Else, set the tree iterator outside the list: */
@@ -381,11 +460,14 @@ namespace Camgen
 		    if(process_it!=processes.end())
 		    {
 			tree_it=process_it->insert_tree(trees,tree_it);
+			allocate_currents(tree_it);
 			tree_it->build();
 			tree_it->clean();
 			tree_it->set_Fermi_signs();
 			tree_it->initialise_currents();
 			tree_it->assign_momenta();
+			tree_it->compile();
+			localise_tree(tree_it);
 			return process_it;
 		    }
 
@@ -403,11 +485,14 @@ namespace Camgen
 		if(process_it != processes.end())
 		{
 		    tree_it=process_it->insert_tree(trees,trees.end());
+		    allocate_currents(tree_it);
 		    tree_it->build();
 		    tree_it->clean();
 		    tree_it->set_Fermi_signs();
 		    tree_it->initialise_currents();
 		    tree_it->assign_momenta();
+		    tree_it->compile();
+		    localise_tree(tree_it);
 		}
 
 		/* Else, set the tree iterator outside the list: */
@@ -465,19 +550,21 @@ namespace Camgen
 
 	    bool reset_process()
 	    {
-		tree_it=trees.begin();
 		process_it=processes.begin();
-		return (tree_it!=trees.end());
+		tree_it=(process_it==processes.end())?trees.end():(process_it->get_tree());
+		return (process_it!=processes.end());
 	    }
 
 	    /// Moves to the next process in the list. Returns a boolean
-	    /// denoting whether this is the final process.
+	    /// denoting whether this is the final process. The vertex tree is
+	    /// the one of the process, which may be shared with other processes
+	    /// (see share_equivalent_trees).
 
 	    bool next_process()
 	    {
-		++tree_it;
 		++process_it;
-		return (tree_it!=trees.end());
+		tree_it=(process_it==processes.end())?trees.end():(process_it->get_tree());
+		return (process_it!=processes.end());
 	    }
 
 	    /// Returns whether the process is valid.
@@ -543,6 +630,7 @@ namespace Camgen
 
 	    void init_construct()
 	    {
+		allocate_currents(tree_it);
 		tree_it->init_build();
 	    }
 
@@ -559,46 +647,355 @@ namespace Camgen
 	    {
 		if(tree_it!=trees.end())
 		{
+		    delocalise_tree(tree_it);
+		    allocate_currents(tree_it);
 		    tree_it->build();
 		    tree_it->clean();
 		    tree_it->set_Fermi_signs();
 		    tree_it->initialise_currents();
 		    tree_it->assign_momenta();
+		    tree_it->compile();
 		    tree_it->compute_coupling_flags();
+		    localise_tree(tree_it);
 		}
 	    }
 
 	    /// Constructs the vertex trees of all subprocesses.
+	    /// The trees are built concurrently by the given number of threads
+	    /// (if 0, the number of hardware threads), after the currents they
+	    /// can produce have been allocated. Without thread support, the
+	    /// trees are built serially.
 
-	    void construct_trees()
+	    void construct_trees(size_type n_threads=0)
 	    {
 		for(tree_iterator it=trees.begin();it!=trees.end();++it)
 		{
-		    it->build();
-		    it->clean();
+		    delocalise_tree(it);
+		}
+		allocate_currents(trees.begin(),trees.end());
+		if(n_threads==0)
+		{
+		    n_threads=hardware_threads();
+		}
+		build_queue queue(trees.begin(),trees.end());
+		std::vector<build_job*>jobs(std::max(std::min(n_threads,(size_type)trees.size()),(size_type)1));
+		for(size_type i=0;i<jobs.size();++i)
+		{
+		    jobs[i]=new build_job(&queue);
+		}
+		run_parallel(jobs);
+		for(size_type i=0;i<jobs.size();++i)
+		{
+		    delete jobs[i];
 		}
 		for(tree_iterator it=trees.begin();it != trees.end();++it)
 		{
 		    it->set_Fermi_signs();
 		    it->initialise_currents();
 		    it->assign_momenta();
+		    it->compile();
 		    it->compute_coupling_flags();
+		    localise_tree(it);
 		}
 		tree_it=trees.begin();
 	    }
 
+	    /// Constructs the vertex trees of all subprocesses, reading them
+	    /// from the argument cache file if it was written for the same model
+	    /// and subprocess list. Otherwise, the trees are constructed and
+	    /// the cache file is (re)written. Returns true if the trees were
+	    /// read from the cache.
+
+	    bool construct_trees(const std::string& cache)
+	    {
+		if(load_trees(cache))
+		{
+		    return true;
+		}
+		construct_trees();
+		save_trees(cache);
+		return false;
+	    }
+
+	    /// Writes the constructed vertex trees of all subprocesses to a
+	    /// binary cache file, keyed by a hash of the model structure and
+	    /// the subprocess flavours. Trees shared between subprocesses are
+	    /// stored once. Returns false if the file could not be written.
+
+	    bool save_trees(const std::string& filename) const
+	    {
+		std::ofstream ofs(filename.c_str(),std::ios::out|std::ios::binary|std::ios::trunc);
+		if(!ofs.is_open())
+		{
+		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"could not open tree cache file "<<filename<<endlog;
+		    return false;
+		}
+		std::map<const typename tree_type::vertex_type*,unsigned>vertex_indices;
+		for(size_type i=0;i<model_wrapper<model_t>::vertices();++i)
+		{
+		    vertex_indices[model_wrapper<model_t>::get_vertex(i)]=i;
+		}
+		std::map<const tree_type*,unsigned>tree_indices;
+		for(const_tree_iterator it=trees.begin();it!=trees.end();++it)
+		{
+		    unsigned n=tree_indices.size();
+		    tree_indices[&(*it)]=n;
+		}
+		write_binary(ofs,std::string(tree_cache_tag));
+		write_binary(ofs,tree_cache_version);
+		write_binary(ofs,model_wrapper<model_t>::structure_hash());
+		write_binary(ofs,(unsigned)N_in);
+		write_binary(ofs,(unsigned)N_out);
+		write_binary(ofs,(unsigned)N_final);
+		write_binary(ofs,(unsigned)processes.size());
+		for(const_process_iterator it=processes.begin();it!=processes.end();++it)
+		{
+		    for(size_type i=0;i<N_external;++i)
+		    {
+			write_binary(ofs,(unsigned)(it->get_flavours()[i]));
+		    }
+		    write_binary(ofs,tree_indices[&(*(it->get_tree()))]);
+		}
+		write_binary(ofs,(unsigned)trees.size());
+		for(const_tree_iterator it=trees.begin();it!=trees.end();++it)
+		{
+		    it->write_cache(ofs,vertex_indices);
+		}
+		return ofs.good();
+	    }
+
+	    /// Reads the vertex trees of all subprocesses from a cache file
+	    /// written by save_trees, replacing their construction. The
+	    /// subprocesses should be loaded, and the file is only accepted if
+	    /// it was written for the same model structure, final current and
+	    /// subprocess list; in that case the function returns true. The
+	    /// file is memory-mapped where the platform supports it.
+
+	    bool load_trees(const std::string& filename)
+	    {
+		mapped_file file(filename);
+		if(!file.is_open())
+		{
+		    return false;
+		}
+		binary_reader r(file);
+		std::string tag;
+		unsigned version,n_in,n_out,n_final,n_processes,n_trees;
+		long long unsigned hash;
+		if(!r.read(tag) or tag!=tree_cache_tag or !r.read(version) or version!=tree_cache_version)
+		{
+		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"file "<<filename<<" is not a tree cache of this version"<<endlog;
+		    return false;
+		}
+		if(!r.read(hash) or hash!=model_wrapper<model_t>::structure_hash() or !r.read(n_in) or n_in!=N_in or !r.read(n_out) or n_out!=N_out or !r.read(n_final) or n_final!=N_final or !r.read(n_processes) or n_processes!=processes.size())
+		{
+		    return false;
+		}
+
+		/* Match the cached subprocesses by flavours: */
+
+		std::map<std::vector<size_type>,process_iterator>process_map;
+		std::vector<size_type>flavours(N_external);
+		for(process_iterator it=processes.begin();it!=processes.end();++it)
+		{
+		    for(size_type i=0;i<N_external;++i)
+		    {
+			flavours[i]=it->get_flavours()[i];
+		    }
+		    process_map[flavours]=it;
+		}
+		std::vector<process_iterator>cached_processes(n_processes);
+		std::vector<unsigned>cached_tree_indices(n_processes);
+		for(unsigned k=0;k<n_processes;++k)
+		{
+		    for(size_type i=0;i<N_external;++i)
+		    {
+			unsigned f;
+			if(!r.read(f))
+			{
+			    return false;
+			}
+			flavours[i]=f;
+		    }
+		    typename std::map<std::vector<size_type>,process_iterator>::iterator it=process_map.find(flavours);
+		    if(!r.read(cached_tree_indices[k]) or it==process_map.end())
+		    {
+			return false;
+		    }
+		    cached_processes[k]=it->second;
+		    process_map.erase(it);
+		}
+		if(!r.read(n_trees))
+		{
+		    return false;
+		}
+
+		/* Assign each cached tree to a subprocess with matching external
+		 * currents and request the cached currents: */
+
+		std::vector<tree_iterator>cached_trees(n_trees,trees.end());
+		std::vector<const char*>positions(n_trees);
+		{
+		    scoped_lock lock(build_mutex);
+		    for(unsigned t=0;t<n_trees;++t)
+		    {
+			positions[t]=r.position();
+			for(unsigned k=0;k<n_processes;++k)
+			{
+			    if(cached_tree_indices[k]==t)
+			    {
+				binary_reader r2(r);
+				if(cached_processes[k]->get_tree()->read_cache(r2,false))
+				{
+				    cached_trees[t]=cached_processes[k]->get_tree();
+				    r=r2;
+				    break;
+				}
+			    }
+			}
+			if(cached_trees[t]==trees.end())
+			{
+			    log(log_level::warning)<<CAMGEN_STREAMLOC<<"corrupt tree cache file "<<filename<<endlog;
+			    return false;
+			}
+		    }
+		    allocate_requested_currents();
+		}
+
+		/* Let the subprocesses refer to the cached trees and remove the
+		 * redundant ones: */
+
+		std::set<const tree_type*>used;
+		for(unsigned t=0;t<n_trees;++t)
+		{
+		    used.insert(&(*cached_trees[t]));
+		}
+		for(unsigned k=0;k<n_processes;++k)
+		{
+		    if(cached_tree_indices[k]<n_trees)
+		    {
+			cached_processes[k]->set_tree(cached_trees[cached_tree_indices[k]]);
+		    }
+		}
+		for(tree_iterator it=trees.begin();it!=trees.end();)
+		{
+		    if(used.find(&(*it))==used.end())
+		    {
+			it=trees.erase(it);
+		    }
+		    else
+		    {
+			++it;
+		    }
+		}
+
+		/* Insert the interactions and initialise the trees: */
+
+		bool success=true;
+		for(unsigned t=0;t<n_trees;++t)
+		{
+		    delocalise_tree(cached_trees[t]);
+		    binary_reader r2(positions[t],file.data()+file.size());
+		    success&=cached_trees[t]->read_cache(r2,true);
+		}
+		for(tree_iterator it=trees.begin();it!=trees.end();++it)
+		{
+		    it->set_Fermi_signs();
+		    it->initialise_currents();
+		    it->assign_momenta();
+		    it->compile();
+		    it->compute_coupling_flags();
+		    localise_tree(it);
+		}
+		tree_it=(process_it==processes.end())?trees.end():(process_it->get_tree());
+		return success;
+	    }
+
 	    /// Removes current process from tree.
 
 	    tree_iterator remove_process()
 	    {
-		if(tree_it!=trees.end())
+		if(process_it!=processes.end())
 		{
-		    processes.erase(process_it);
-		    trees.erase(tree_it);
+		    tree_iterator it=process_it->get_tree();
+		    process_it=processes.erase(process_it);
+		    bool shared=false;
+		    for(const_process_iterator p=processes.begin();p!=processes.end();++p)
+		    {
+			if(p->get_tree()==it)
+			{
+			    shared=true;
+			    break;
+			}
+		    }
+		    if(!shared and it!=trees.end())
+		    {
+			trees.erase(it);
+		    }
+		    tree_it=(process_it==processes.end())?trees.end():(process_it->get_tree());
 		}
 		return tree_it;
 	    }
 
+	    /// Lets subprocesses whose vertex trees only differ by a relabelling
+	    /// of equivalent flavours (equal masses, widths and couplings, e.g.
+	    /// massless quark generations with diagonal mixing) share a single
+	    /// tree and removes the redundant trees. The tree of a subprocess
+	    /// then evaluates its amplitude with the external legs in the order
+	    /// of the subprocess, but its external particles are the ones of the
+	    /// first subprocess in the equivalence class. Since the analysis
+	    /// compares the current parameter values, it should be invoked
+	    /// after the trees have been constructed with the final model
+	    /// parameters. Returns the number of removed trees.
+
+	    size_type share_equivalent_trees()
+	    {
+		std::vector<tree_iterator>representatives;
+		std::map<const tree_type*,tree_iterator>replacements;
+		for(tree_iterator it=trees.begin();it!=trees.end();++it)
+		{
+		    bool shared=false;
+		    for(size_type i=0;i<representatives.size();++i)
+		    {
+			if(representatives[i]->is_equivalent(*it))
+			{
+			    replacements[&(*it)]=representatives[i];
+			    shared=true;
+			    break;
+			}
+		    }
+		    if(!shared and !(it->is_empty()))
+		    {
+			representatives.push_back(it);
+		    }
+		}
+		if(replacements.empty())
+		{
+		    return 0;
+		}
+		for(process_iterator it=processes.begin();it!=processes.end();++it)
+		{
+		    typename std::map<const tree_type*,tree_iterator>::iterator it2=replacements.find(&(*(it->get_tree())));
+		    if(it2!=replacements.end())
+		    {
+			it->set_tree(it2->second);
+		    }
+		}
+		for(tree_iterator it=trees.begin();it!=trees.end();)
+		{
+		    if(replacements.find(&(*it))!=replacements.end())
+		    {
+			it=trees.erase(it);
+		    }
+		    else
+		    {
+			++it;
+		    }
+		}
+		tree_it=(process_it==processes.end())?trees.end():(process_it->get_tree());
+		return replacements.size();
+	    }
+
 	    /// Removes subprocesses with empty vertex trees.
 
 	    void remove_empty_processes()
@@ -626,9 +1023,13 @@ namespace Camgen
 	    size_type count_nonempty_processes() const
 	    {
 		size_type n=0;
-		for(const_tree_iterator it=trees.begin();it!=trees.end();++it)
+		if(trees.empty())
+		{
+		    return n;
+		}
+		for(const_process_iterator it=processes.begin();it!=processes.end();++it)
 		{
-		    if(!(it->is_empty()))
+		    if(!(it->get_tree()->is_empty()))
 		    {
 			++n;
 		    }
@@ -753,6 +1154,21 @@ namespace Camgen
 		return (r_value_type)0;
 	    }
 
+	    /// Evaluates the summed amplitude like evaluate_sum, and stores the
+	    /// amplitudes of all summed helicity and colour configurations in
+	    /// the argument, where the dofs of the first particle run fastest.
+
+	    r_value_type evaluate_sum(std::vector<value_type>& amplitudes)
+	    {
+		if(tree_it != trees.end())
+		{
+		    tree_it->reset();
+		    return tree_it->evaluate(summed_spins,summed_cols,amplitudes);
+		}
+		amplitudes.clear();
+		return (r_value_type)0;
+	    }
+
 	    /// Returns phase space object address of the i-th external particle
 	    /// in the current subprocess.
 
@@ -917,12 +1333,22 @@ namespace Camgen
 
 	    void refresh()
 	    {
+		bool local=is_local();
+		for(tree_iterator it=trees.begin();it!=trees.end();++it)
+		{
+		    delocalise_tree(it);
+		}
+		local_currents.clear();
 		current_tree_type::refresh();
 		for(tree_iterator it=trees.begin();it!=trees.end();++it)
 		{
 		    it->clear();
 		}
 		construct_trees();
+		if(local)
+		{
+		    localise();
+		}
 	    }
 
 	    /// Clears all data.
@@ -931,6 +1357,7 @@ namespace Camgen
 	    {
 		trees.clear();
 		processes.clear();
+		local_currents.clear();
 	    }
 
 	protected:
@@ -974,6 +1401,238 @@ namespace Camgen
 
 	    std::bitset<N_external>summed_cols;
 
+	    /* Instance-local copy of the current data, empty unless the
+	     * algorithm has been localised: */
+
+	    std::vector<current_type>local_currents;
+
+	    /* Copies the argument algorithm's processes and trees, relocating the
+	     * latter to an instance-local copy of the current data: */
+
+	    void copy(const CM_algorithm<model_t,N_in,N_out>& other)
+	    {
+		trees=other.trees;
+		processes=other.processes;
+		sorted_by_flavour=other.sorted_by_flavour;
+		sorted_by_pdg_id=other.sorted_by_pdg_id;
+		ordering=other.ordering;
+		summed_spins=other.summed_spins;
+		summed_cols=other.summed_cols;
+
+		/* Map the other's trees to the copied ones and reset the
+		 * iterators: */
+
+		std::map<const tree_type*,tree_iterator>tree_map;
+		tree_it=trees.end();
+		const_tree_iterator it1=other.trees.begin();
+		for(tree_iterator it2=trees.begin();it2!=trees.end();++it1,++it2)
+		{
+		    tree_map[&(*it1)]=it2;
+		    if(it1==other.tree_it)
+		    {
+			tree_it=it2;
+		    }
+		}
+		process_it=processes.end();
+		const_process_iterator it3=other.processes.begin();
+		for(process_iterator it4=processes.begin();it4!=processes.end();++it3,++it4)
+		{
+		    typename std::map<const tree_type*,tree_iterator>::iterator it5=tree_map.find(&(*(it3->get_tree())));
+		    it4->set_tree((it5==tree_map.end())?trees.end():(it5->second));
+		    if(it3==other.process_it)
+		    {
+			process_it=it4;
+		    }
+		}
+
+		/* Copy the current data and relocate the trees: */
+
+		scoped_lock lock(build_mutex);
+		if(other.is_local())
+		{
+		    local_currents=other.local_currents;
+		    for(tree_iterator it=trees.begin();it!=trees.end();++it)
+		    {
+			it->relocate(other.local_currents.begin(),local_currents.begin());
+		    }
+		}
+		else
+		{
+		    local_currents.assign(current_tree_type::begin(),current_tree_type::end());
+		    for(tree_iterator it=trees.begin();it!=trees.end();++it)
+		    {
+			it->relocate(current_tree_type::begin(),local_currents.begin());
+		    }
+		}
+	    }
+
+	    /* Makes a tree constructed upon the static current data refer to the
+	     * instance-local copy, copying the currents initialised during the
+	     * construction: */
+
+	    void localise_tree(tree_iterator it)
+	    {
+		if(!local_currents.empty())
+		{
+		    scoped_lock lock(build_mutex);
+
+		    /* Append the currents allocated in the static data since the
+		     * localisation, relocating the localised trees if the local
+		     * copy is reallocated: */
+
+		    if(local_currents.size()<current_tree_type::size())
+		    {
+			if(local_currents.capacity()<current_tree_type::size())
+			{
+			    std::vector<current_type>old;
+			    current_tree_type::reallocate(local_currents,current_tree_type::size(),old);
+			    for(tree_iterator t=trees.begin();t!=trees.end();++t)
+			    {
+				if(t->refers_to(old.begin(),old.end()))
+				{
+				    t->relocate(old.begin(),local_currents.begin());
+				}
+			    }
+			}
+			local_currents.insert(local_currents.end(),current_tree_type::begin()+local_currents.size(),current_tree_type::end());
+		    }
+		    current_iterator c=current_tree_type::begin();
+		    for(size_type i=0;i<local_currents.size();++i,++c)
+		    {
+			if(c->is_initialised() and !(local_currents[i].is_initialised()))
+			{
+			    local_currents[i]=*c;
+			}
+		    }
+		    it->relocate(current_tree_type::begin(),local_currents.begin());
+		}
+	    }
+
+	    /* Makes a tree refer to the static current data again, prior to
+	     * (re)construction: */
+
+	    void delocalise_tree(tree_iterator it)
+	    {
+		if(!local_currents.empty())
+		{
+		    it->relocate(local_currents.begin(),current_tree_type::begin());
+		}
+	    }
+
+	    /* Lets the trees in the argument range request the currents they
+	     * can produce from the current tree, and allocates them. If this
+	     * reallocates the static current data, all trees of all algorithm
+	     * instances referring to it are relocated: */
+
+	    void allocate_currents(tree_iterator first,tree_iterator last)
+	    {
+		scoped_lock lock(build_mutex);
+		for(tree_iterator it=first;it!=last;++it)
+		{
+		    it->request_currents();
+		}
+		allocate_requested_currents();
+	    }
+
+	    void allocate_currents(tree_iterator it)
+	    {
+		tree_iterator last=it;
+		allocate_currents(it,++last);
+	    }
+
+	    /* Allocates the currents requested from the current tree,
+	     * relocating the trees of all instances if the static current data
+	     * moves. The build mutex should be locked by the caller: */
+
+	    static void allocate_requested_currents()
+	    {
+		std::vector<current_type>old;
+		if(current_tree_type::allocate(old))
+		{
+		    for(typename std::set<CM_algorithm<model_t,N_in,N_out>*>::iterator a=instances.begin();a!=instances.end();++a)
+		    {
+			for(tree_iterator it=(*a)->trees.begin();it!=(*a)->trees.end();++it)
+			{
+			    if(it->refers_to(old.begin(),old.end()))
+			    {
+				it->relocate(old.begin(),current_tree_type::begin());
+			    }
+			}
+		    }
+		}
+	    }
+
+	    /* Queue of trees to be built by the construction threads: */
+
+	    class build_queue
+	    {
+		public:
+
+		    build_queue(tree_iterator first,tree_iterator last):next(first),end(last){}
+
+		    /* Returns the next tree to build, or the end of the range if
+		     * all trees were taken: */
+
+		    tree_iterator pop()
+		    {
+			scoped_lock lock(queue_mutex);
+			return (next==end)?end:(next++);
+		    }
+
+		    /* End of the tree range: */
+
+		    tree_iterator last() const
+		    {
+			return end;
+		    }
+
+		private:
+
+		    tree_iterator next,end;
+		    mutex queue_mutex;
+	    };
+
+	    /* Construction thread job, building and cleaning trees from the
+	     * queue until it is empty. The build marks of the currents are
+	     * thread-local, so only the queue is shared: */
+
+	    class build_job
+	    {
+		public:
+
+		    build_job(build_queue* queue_):queue(queue_){}
+
+		    void operator()()
+		    {
+			for(tree_iterator it=queue->pop();it!=queue->last();it=queue->pop())
+			{
+			    it->build();
+			    it->clean();
+			}
+		    }
+
+		private:
+
+		    build_queue* queue;
+	    };
+
+	    /* Adds the algorithm to the instance register: */
+
+	    void register_instance()
+	    {
+		scoped_lock lock(build_mutex);
+		instances.insert(this);
+	    }
+
+	    /* Lock guarding the static current data when copying it: */
+
+	    static mutex build_mutex;
+
+	    /* Register of all algorithm instances, whose trees may refer to the
+	     * static current data: */
+
+	    static std::set<CM_algorithm<model_t,N_in,N_out>*>instances;
+
 	    /* Function setting the ordering to its default value, denoting an
 	     * ordered process: */
 
@@ -988,11 +1647,20 @@ namespace Camgen
 	    /* Final particle in current tree: */
 
 	    static std::size_t N_final;
+
+	    /* Tree cache file tag and format version: */
+
+	    static const std::string tree_cache_tag;
+	    static const unsigned tree_cache_version;
     };
     template<class model_t,std::size_t N_in,std::size_t N_out>const std::size_t CM_algorithm<model_t,N_in,N_out>::N_incoming;
     template<class model_t,std::size_t N_in,std::size_t N_out>const std::size_t CM_algorithm<model_t,N_in,N_out>::N_outgoing;
     template<class model_t,std::size_t N_in,std::size_t N_out>const std::size_t CM_algorithm<model_t,N_in,N_out>::N_external;
     template<class model_t,std::size_t N_in,std::size_t N_out>std::size_t CM_algorithm<model_t,N_in,N_out>::N_final=0;
+    template<class model_t,std::size_t N_in,std::size_t N_out>const std::string CM_algorithm<model_t,N_in,N_out>::tree_cache_tag("CAMGEN tree cache");
+    template<class model_t,std::size_t N_in,std::size_t N_out>const unsigned CM_algorithm<model_t,N_in,N_out>::tree_cache_version=1;
+    template<class model_t,std::size_t N_in,std::size_t N_out>mutex CM_algorithm<model_t,N_in,N_out>::build_mutex;
+    template<class model_t,std::size_t N_in,std::size_t N_out>std::set<CM_algorithm<model_t,N_in,N_out>*>CM_algorithm<model_t,N_in,N_out>::instances;
 }
 
 #include <Camgen/undef_args.h>
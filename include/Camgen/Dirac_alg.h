@@ -14,6 +14,7 @@
 #include <Camgen/spacetime.h>
 #include <Camgen/debug.h>
 #include <Camgen/logstream.h>
+#include <Camgen/mt_utils.h>
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * 
  * Base class of Dirac algebras. The Dirac matrices are implemented using the    *
@@ -4108,7 +4109,7 @@ namespace Camgen
 	    
 	    /* A Dirac matrix to store temporary slashed-vectors: */
 	    
-	    static value_type Vslash[Dirac_dim<dim>::value][Dirac_dim<dim>::value];
+	    static CAMGEN_THREAD_LOCAL value_type Vslash[Dirac_dim<dim>::value][Dirac_dim<dim>::value];
 	
 	private:
 
@@ -4210,7 +4211,7 @@ namespace Camgen
     template<class value_t,class type,std::size_t dim>typename Dirac_algebra<value_t,type,dim,true>::value_type Dirac_algebra<value_t,type,dim,true>::Cc_g[dim][Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{{0}}};
     template<class value_t,class type,std::size_t dim>typename Dirac_algebra<value_t,type,dim,true>::value_type Dirac_algebra<value_t,type,dim,true>::D_matrix[Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{0}};
     template<class value_t,class type,std::size_t dim>typename Dirac_algebra<value_t,type,dim,true>::value_type Dirac_algebra<value_t,type,dim,true>::C_matrix[Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{0}};
-    template<class value_t,class type,std::size_t dim>typename Dirac_algebra<value_t,type,dim,true>::value_type Dirac_algebra<value_t,type,dim,true>::Vslash[Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{0}};
+    template<class value_t,class type,std::size_t dim>CAMGEN_THREAD_LOCAL typename Dirac_algebra<value_t,type,dim,true>::value_type Dirac_algebra<value_t,type,dim,true>::Vslash[Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{0}};
     template<class value_t,class type,std::size_t dim>typename Dirac_algebra<value_t,type,dim,true>::value_type Dirac_algebra<value_t,type,dim,true>::g_5[Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{0}};
     template<class value_t,class type,std::size_t dim>typename Dirac_algebra<value_t,type,dim,true>::value_type Dirac_algebra<value_t,type,dim,true>::g_5_C[Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{0}};
     template<class value_t,class type,std::size_t dim>typename Dirac_algebra<value_t,type,dim,true>::value_type Dirac_algebra<value_t,type,dim,true>::Cc_g_5[Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{0}};
@@ -5849,7 +5850,7 @@ namespace Camgen
 	    
 	    /* A Dirac matrix to store temporary slashed-vectors: */
 	    
-	    static value_type Vslash[Dirac_dim<dim>::value][Dirac_dim<dim>::value];
+	    static CAMGEN_THREAD_LOCAL value_type Vslash[Dirac_dim<dim>::value][Dirac_dim<dim>::value];
 	
 	private:
 
@@ -5951,7 +5952,7 @@ namespace Camgen
     template<class value_t,class type,std::size_t dim>typename Dirac_algebra<value_t,type,dim,false>::value_type Dirac_algebra<value_t,type,dim,false>::Cc_g[dim][Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{{0}}};
     template<class value_t,class type,std::size_t dim>typename Dirac_algebra<value_t,type,dim,false>::value_type Dirac_algebra<value_t,type,dim,false>::D_matrix[Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{0}};
     template<class value_t,class type,std::size_t dim>typename Dirac_algebra<value_t,type,dim,false>::value_type Dirac_algebra<value_t,type,dim,false>::C_matrix[Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{0}};
-    template<class value_t,class type,std::size_t dim>typename Dirac_algebra<value_t,type,dim,false>::value_type Dirac_algebra<value_t,type,dim,false>::Vslash[Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{0}};
+    template<class value_t,class type,std::size_t dim>CAMGEN_THREAD_LOCAL typename Dirac_algebra<value_t,type,dim,false>::value_type Dirac_algebra<value_t,type,dim,false>::Vslash[Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{0}};
     template<class value_t,class type,std::size_t dim>typename Dirac_algebra<value_t,type,dim,false>::value_type Dirac_algebra<value_t,type,dim,false>::g_comms[dim][dim][Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{{{0}}}};
     template<class value_t,class type,std::size_t dim>typename Dirac_algebra<value_t,type,dim,false>::value_type Dirac_algebra<value_t,type,dim,false>::g_comms_C[dim][dim][Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{{{0}}}};
     template<class value_t,class type,std::size_t dim>typename Dirac_algebra<value_t,type,dim,false>::value_type Dirac_algebra<value_t,type,dim,false>::Cc_g_comms[dim][dim][Dirac_dim<dim>::value][Dirac_dim<dim>::value]={{{{0}}}};
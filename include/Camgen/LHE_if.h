@@ -14,12 +14,25 @@
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * Les-Houches event format output interface for process/event generators in *
- * Camgen.                                                                   *
+ * Camgen. The event record is copied at filling time and formatted into a   *
+ * large character buffer, which is written to the file in bulk. In the      *
+ * asynchronous mode, the records are passed through a ring buffer to a      *
+ * background thread performing the formatting and writing. If compression   *
+ * is switched on, the buffer chunks are gzip-compressed concurrently by a   *
+ * pool of worker threads. The event file reader gives indexed access to the *
+ * particles and weights of existing event files, and writes copies with     *
+ * additional weights in LHE version 3 rwgt-blocks.                          *
  *                                                                           *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
-#include <Camgen/if_output.h>
+#include <sstream>
+#include <Camgen/if_base.h>
+#include <Camgen/fmt_buffer.h>
+#include <Camgen/async_writer.h>
+#include <Camgen/gz_writer.h>
 
 namespace Camgen
 {
@@ -29,6 +42,17 @@ namespace Camgen
     {
 	typedef interface_base<model_t> base_type;
 
+	/* Copy of the event record: */
+
+	struct event_record
+	{
+	    int n_in,n_out;
+	    double w,mu_F,alpha,alpha_s;
+	    std::vector<int>ids,c,cbar;
+	    std::vector<double>p;
+	};
+	friend class async_writer<event_record,LHE_interface<model_t> >;
+
 	public:
 
 	    /* Type definitions: */
@@ -61,7 +85,7 @@ namespace Camgen
 
 	    /// Constructor.
 
-	    LHE_interface(generator_type* gen,const std::string& file_name_,int weight_switch_,unsigned proc_id_=1):base_type(gen),file_name(file_name_),proc_id(proc_id_),weight_switch(weight_switch_)
+	    LHE_interface(generator_type* gen,const std::string& file_name_,int weight_switch_,unsigned proc_id_=1):base_type(gen),file_name(file_name_),proc_id(proc_id_),weight_switch(weight_switch_),buffer(buffer_size+buffer_size/8),writer(this),compressor(NULL)
 	    {
 		open_file();
 		write_init();
@@ -69,7 +93,7 @@ namespace Camgen
 
 	    /// Constructor with description.
 
-	    LHE_interface(generator_type* gen,const std::string& file_name_,int weight_switch_,const std::string& descr_,unsigned proc_id_=1):base_type(gen),file_name(file_name_),proc_id(proc_id_),weight_switch(weight_switch_),description(descr_)
+	    LHE_interface(generator_type* gen,const std::string& file_name_,int weight_switch_,const std::string& descr_,unsigned proc_id_=1):base_type(gen),file_name(file_name_),proc_id(proc_id_),weight_switch(weight_switch_),description(descr_),buffer(buffer_size+buffer_size/8),writer(this),compressor(NULL)
 	    {
 		open_file();
 		write_init();
@@ -77,14 +101,80 @@ namespace Camgen
 
 	    /// Destructor.
 
-	    ~LHE_interface(){}
+	    ~LHE_interface()
+	    {
+		write();
+	    }
+
+	    /// Switches on asynchronous output: filling copies the event record
+	    /// into a ring buffer, from which a background thread formats and
+	    /// writes the events. Returns false if Camgen is built without thread
+	    /// support, in which case the calling thread writes the events.
+
+	    bool set_async()
+	    {
+		return writer.start();
+	    }
+
+	    /// Returns whether the events are written asynchronously.
+
+	    bool async() const
+	    {
+		return writer.running();
+	    }
+
+	    /// Switches on gzip compression: the event file, with extension
+	    /// .LHE.gz, is written as a sequence of independently compressed
+	    /// chunks, which are compressed concurrently by the argument number
+	    /// of worker threads (by default the number of hardware threads).
+	    /// Should be called before the first event is filled, returns false
+	    /// otherwise or if Camgen was configured without zlib.
+
+	    bool set_compression(int level=6,size_type threads=0)
+	    {
+#if HAVE_ZLIB_H_
+		if(compressor!=NULL or this->input_events()!=0 or !ofs.is_open())
+		{
+		    return false;
+		}
+		ofs.close();
+		std::remove((file_name+".LHE").c_str());
+		std::string fname=file_name+".LHE.gz";
+		ofs.open(fname.c_str(),std::ios::out|std::ios::binary);
+		if(!ofs.is_open())
+		{
+		    return false;
+		}
+		compressor=new gzip_chunk_writer(&ofs,level,threads);
+		return true;
+#else
+		return false;
+#endif
+	    }
+
+	    /// Returns whether the event file is compressed.
+
+	    bool compressed() const
+	    {
+		return compressor!=NULL;
+	    }
 
 	    /// Writes and closes the datafile.
 
 	    bool write()
 	    {
+		writer.stop();
 		if(ofs.is_open())
 		{
+		    flush_buffer();
+#if HAVE_ZLIB_H_
+		    if(compressor!=NULL)
+		    {
+			compressor->finish();
+			delete compressor;
+			compressor=NULL;
+		    }
+#endif
 		    ofs.close();
 		}
 		return !(ofs.is_open());
@@ -98,54 +188,43 @@ namespace Camgen
 		{
 		    return false;
 		}
-		std::vector<int>c,cbar;
-		this->gen->fill_colours(c,cbar);
-		size_type nin=this->gen->n_in();
-		size_type npart=nin+this->gen->n_out();
-		if(c.size()!=npart)
+		event_record& r=writer.next();
+		this->gen->fill_colours(r.c,r.cbar);
+		r.n_in=this->gen->n_in();
+		r.n_out=this->gen->n_out();
+		size_type npart=r.n_in+r.n_out;
+		if(r.c.size()!=npart)
 		{
 		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"colour vectors were incorrectly filled--automatic resizing performed"<<endlog;
-		    c.resize(npart,0);
-		    cbar.resize(npart,0);
-		}
-		ofs<<"<event>"<<std::endl;
-		value_type w=(weight_switch==3)?1:this->gen->w();
-		ofs<<npart<<"\t1\t"<<w<<"\t"<<this->gen->mu_F()<<"\t"<<model_t::alpha<<"\t"<<model_t::alpha_s<<std::endl;
-		for(unsigned i=0;i<nin;++i)
-		{
-		    ofs<<std::setw(4)<<this->gen->id_in(i);
-		    ofs<<std::setw(6)<<-1;
-		    ofs<<std::setw(6)<<0;
-		    ofs<<std::setw(6)<<0;
-		    ofs<<std::setw(6)<<c[i];
-		    ofs<<std::setw(6)<<cbar[i];
-		    ofs<<std::setw(20)<<this->gen->p_in(i,1);
-		    ofs<<std::setw(20)<<this->gen->p_in(i,2);
-		    ofs<<std::setw(20)<<this->gen->p_in(i,3);
-		    ofs<<std::setw(20)<<this->gen->p_in(i,0);
-		    ofs<<std::setw(20)<<this->gen->m_in(i);
-		    ofs<<std::setw(6)<<"0.";
-		    ofs<<std::setw(6)<<"9.";
-		    ofs<<std::endl;
-		}
-		for(unsigned i=0;i<this->gen->n_out();++i)
-		{
-		    ofs<<std::setw(4)<<this->gen->id_out(i);
-		    ofs<<std::setw(6)<<1;
-		    ofs<<std::setw(6)<<1;
-		    ofs<<std::setw(6)<<2;
-		    ofs<<std::setw(6)<<c[i+nin];
-		    ofs<<std::setw(6)<<cbar[i+nin];
-		    ofs<<std::setw(20)<<this->gen->p_out(i,1);
-		    ofs<<std::setw(20)<<this->gen->p_out(i,2);
-		    ofs<<std::setw(20)<<this->gen->p_out(i,3);
-		    ofs<<std::setw(20)<<this->gen->p_out(i,0);
-		    ofs<<std::setw(20)<<this->gen->m_out(i);
-		    ofs<<std::setw(6)<<"0.";
-		    ofs<<std::setw(6)<<"9.";
-		    ofs<<std::endl;
-		}
-		ofs<<"</event>"<<std::endl;
+		    r.c.resize(npart,0);
+		    r.cbar.resize(npart,0);
+		}
+		r.w=(weight_switch==3)?1:this->gen->w();
+		r.mu_F=this->gen->mu_F();
+		r.alpha=model_t::alpha;
+		r.alpha_s=model_t::alpha_s;
+		r.ids.resize(npart);
+		r.p.resize(5*npart);
+		for(int i=0;i<r.n_in;++i)
+		{
+		    r.ids[i]=this->gen->id_in(i);
+		    r.p[5*i]=this->gen->p_in(i,1);
+		    r.p[5*i+1]=this->gen->p_in(i,2);
+		    r.p[5*i+2]=this->gen->p_in(i,3);
+		    r.p[5*i+3]=this->gen->p_in(i,0);
+		    r.p[5*i+4]=this->gen->m_in(i);
+		}
+		for(int i=0;i<r.n_out;++i)
+		{
+		    size_type j=r.n_in+i;
+		    r.ids[j]=this->gen->id_out(i);
+		    r.p[5*j]=this->gen->p_out(i,1);
+		    r.p[5*j+1]=this->gen->p_out(i,2);
+		    r.p[5*j+2]=this->gen->p_out(i,3);
+		    r.p[5*j+3]=this->gen->p_out(i,0);
+		    r.p[5*j+4]=this->gen->m_out(i);
+		}
+		writer.push();
 		return true;
 	    }
 
@@ -181,34 +260,624 @@ namespace Camgen
 		{
 		    return;
 		}
-		ofs<<"<LesHouchesEvents version=\"1.0\">"<<std::endl;
-		ofs<<"<!--"<<std::endl;
-		ofs<<"File written by Camgen "<<VERSION<<" on "<<__DATE__<<" at "<<__TIME__<<std::endl;
-		ofs<<"-->"<<std::endl;
+		std::ostringstream os;
+		os.precision(10);
+		os.setf(std::ios::scientific,std::ios::floatfield);
+		os<<"<LesHouchesEvents version=\"1.0\">"<<std::endl;
+		os<<"<!--"<<std::endl;
+		os<<"File written by Camgen "<<VERSION<<" on "<<__DATE__<<" at "<<__TIME__<<std::endl;
+		os<<"-->"<<std::endl;
 		if(description.size()>0)
 		{
-		    ofs<<"# "<<description<<std::endl;
+		    os<<"# "<<description<<std::endl;
 		}
-		ofs<<"<init>"<<std::endl;
-		ofs<<"\t"<<this->gen->beam_id(-1)<<"\t"<<this->gen->beam_id(-2);
-		ofs<<"\t"<<this->gen->beam_energy(-1)<<"\t"<<this->gen->beam_energy(-2);
-		ofs<<"\t"<<this->gen->pdfg(-1)<<"\t"<<this->gen->pdfg(-2);
-		ofs<<"\t"<<this->gen->pdfs(-1)<<"\t"<<this->gen->pdfs(-2)<<std::endl;
+		os<<"<init>"<<std::endl;
+		os<<"\t"<<this->gen->beam_id(-1)<<"\t"<<this->gen->beam_id(-2);
+		os<<"\t"<<this->gen->beam_energy(-1)<<"\t"<<this->gen->beam_energy(-2);
+		os<<"\t"<<this->gen->pdfg(-1)<<"\t"<<this->gen->pdfg(-2);
+		os<<"\t"<<this->gen->pdfs(-1)<<"\t"<<this->gen->pdfs(-2)<<std::endl;
 		int ws(weight_switch);
 		if(std::abs(ws)>4)
 		{
 		    ws=-4;
 		}
 		MC_integral<value_type>sigma=this->gen->xsec();
-		ofs<<"\t"<<ws<<"\t 1 \t"<<sigma.value<<"\t"<<sigma.error<<"\t"<<this->gen->max_w()<<"\t"<<proc_id<<std::endl;
-		ofs<<"</init>"<<std::endl;
+		os<<"\t"<<ws<<"\t 1 \t"<<sigma.value<<"\t"<<sigma.error<<"\t"<<this->gen->max_w()<<"\t"<<proc_id<<std::endl;
+		os<<"</init>"<<std::endl;
+		buffer.put(os.str());
 	    }
 
 	private:
 
+	    /* Size of the formatting buffer written to the file at once: */
+
+	    static const size_type buffer_size=1<<20;
+
 	    /* Output file stream: */
 
 	    std::ofstream ofs;
+
+	    /* Formatting buffer: */
+
+	    format_buffer buffer;
+
+	    /* Event record writer: */
+
+	    async_writer<event_record,LHE_interface<model_t> >writer;
+
+	    /* Compressed chunk writer: */
+
+	    gzip_chunk_writer* compressor;
+
+	    /* Writes the formatting buffer to the file or hands it to the
+	     * compressor: */
+
+	    void flush_buffer()
+	    {
+#if HAVE_ZLIB_H_
+		if(compressor!=NULL)
+		{
+		    std::vector<char>data;
+		    buffer.swap(data);
+		    compressor->write(data);
+		    buffer.swap(data);
+		    buffer.clear();
+		    return;
+		}
+#endif
+		buffer.write(ofs);
+	    }
+
+	    /* Formats the event record into the buffer: */
+
+	    void consume(const event_record& r)
+	    {
+		buffer.put("<event>\n");
+		buffer.put_int(r.n_in+r.n_out);
+		buffer.put("\t1\t");
+		buffer.put_scientific(r.w);
+		buffer.put('\t');
+		buffer.put_scientific(r.mu_F);
+		buffer.put('\t');
+		buffer.put_scientific(r.alpha);
+		buffer.put('\t');
+		buffer.put_scientific(r.alpha_s);
+		buffer.put('\n');
+		for(int i=0;i<r.n_in+r.n_out;++i)
+		{
+		    bool in=(i<r.n_in);
+		    buffer.put_int(r.ids[i],4);
+		    buffer.put_int(in?-1:1,6);
+		    buffer.put_int(in?0:1,6);
+		    buffer.put_int(in?0:2,6);
+		    buffer.put_int(r.c[i],6);
+		    buffer.put_int(r.cbar[i],6);
+		    for(int k=0;k<5;++k)
+		    {
+			buffer.put_scientific(r.p[5*i+k],10,20);
+		    }
+		    buffer.put("0.",6);
+		    buffer.put("9.",6);
+		    buffer.put('\n');
+		}
+		buffer.put("</event>\n");
+		if(buffer.size()>=buffer_size)
+		{
+		    flush_buffer();
+		}
+	    }
+    };
+
+    /// Les-Houches event file reader. The file is read into memory and the
+    /// incoming and outgoing particles of the events, which should have
+    /// equal multiplicities, are accessible by index. If Camgen was
+    /// configured with zlib, gzip-compressed files can be read as well.
+
+    class LHE_file_reader
+    {
+	public:
+
+	    /* Type definitions: */
+
+	    typedef std::size_t size_type;
+
+	    /// Constructor.
+
+	    LHE_file_reader():n_in(0),n_out(0),header_end(0),opened(false){}
+
+	    /// Constructor reading the argument file.
+
+	    LHE_file_reader(const std::string& filename):n_in(0),n_out(0),header_end(0),opened(false)
+	    {
+		open(filename);
+	    }
+
+	    /// Reads the argument file. Returns false if the file could not be
+	    /// opened or does not contain valid events.
+
+	    bool open(const std::string& filename)
+	    {
+		close();
+		if(!read_file(filename))
+		{
+		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"failed to read file "<<filename<<endlog;
+		    close();
+		    return false;
+		}
+		if(!parse())
+		{
+		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"invalid event file "<<filename<<endlog;
+		    close();
+		    return false;
+		}
+		opened=true;
+		return true;
+	    }
+
+	    /// Discards the file contents.
+
+	    void close()
+	    {
+		text.clear();
+		n_in=n_out=header_end=0;
+		event_begin.clear();
+		event_end.clear();
+		proc_ids.clear();
+		ws.clear();
+		scales.clear();
+		alphas.clear();
+		alphas_s.clear();
+		ids.clear();
+		cs.clear();
+		cbars.clear();
+		momenta.clear();
+		weight_ids.clear();
+		rwgt.clear();
+		opened=false;
+	    }
+
+	    /// Returns whether a valid file was read.
+
+	    bool is_open() const
+	    {
+		return opened;
+	    }
+
+	    /// Returns the number of events.
+
+	    size_type events() const
+	    {
+		return event_begin.size();
+	    }
+
+	    /// Returns the number of incoming particles.
+
+	    size_type n_incoming() const
+	    {
+		return n_in;
+	    }
+
+	    /// Returns the number of outgoing particles.
+
+	    size_type n_outgoing() const
+	    {
+		return n_out;
+	    }
+
+	    /// Returns the process id of event i.
+
+	    int process_id(size_type i) const
+	    {
+		return proc_ids[i];
+	    }
+
+	    /// Returns the weight of event i.
+
+	    double weight(size_type i) const
+	    {
+		return ws[i];
+	    }
+
+	    /// Returns the scale of event i.
+
+	    double mu_F(size_type i) const
+	    {
+		return scales[i];
+	    }
+
+	    /// Returns the QED coupling of event i.
+
+	    double alpha(size_type i) const
+	    {
+		return alphas[i];
+	    }
+
+	    /// Returns the strong coupling of event i.
+
+	    double alpha_s(size_type i) const
+	    {
+		return alphas_s[i];
+	    }
+
+	    /// Returns the id of the k-th particle in event i, where the
+	    /// incoming particles precede the outgoing ones.
+
+	    int id(size_type i,size_type k) const
+	    {
+		return ids[i*(n_in+n_out)+k];
+	    }
+
+	    /// Returns the colour line of the k-th particle in event i.
+
+	    int c(size_type i,size_type k) const
+	    {
+		return cs[i*(n_in+n_out)+k];
+	    }
+
+	    /// Returns the anticolour line of the k-th particle in event i.
+
+	    int cbar(size_type i,size_type k) const
+	    {
+		return cbars[i*(n_in+n_out)+k];
+	    }
+
+	    /// Returns the mu-th component of the k-th momentum in event i,
+	    /// where the energy is the zeroth component.
+
+	    double p(size_type i,size_type k,size_type mu) const
+	    {
+		return momenta[4*(i*(n_in+n_out)+k)+mu];
+	    }
+
+	    /// Returns the number of additional weights per event.
+
+	    size_type weights() const
+	    {
+		return weight_ids.size();
+	    }
+
+	    /// Returns the id of the j-th additional weight.
+
+	    const std::string& weight_id(size_type j) const
+	    {
+		return weight_ids[j];
+	    }
+
+	    /// Returns the j-th additional weight of event i.
+
+	    double weight(size_type i,size_type j) const
+	    {
+		return rwgt[i*weight_ids.size()+j];
+	    }
+
+	    /// Writes a copy of the event file with additional weights, where
+	    /// the j-th weight has the id names[j] and the values weights[j],
+	    /// one per event. The weights are declared in the header and
+	    /// appended to the rwgt-block of each event, following the LHE
+	    /// version 3 conventions. Returns false if the argument sizes do not
+	    /// match or the file could not be written.
+
+	    bool write_weights(const std::string& filename,const std::vector<std::string>& names,const std::vector< std::vector<double> >& weights) const
+	    {
+		if(!opened or names.size()!=weights.size())
+		{
+		    return false;
+		}
+		for(size_type j=0;j<weights.size();++j)
+		{
+		    if(weights[j].size()!=events())
+		    {
+			return false;
+		    }
+		}
+		std::ofstream ofs(filename.c_str(),std::ios::out|std::ios::binary);
+		if(!ofs.is_open())
+		{
+		    return false;
+		}
+		std::string header(text,0,header_end);
+		size_type pos=header.find("version=\"1.0\"");
+		if(pos!=std::string::npos)
+		{
+		    header.replace(pos,13,"version=\"3.0\"");
+		}
+		std::string group("<weightgroup name=\"Camgen\">\n");
+		for(size_type j=0;j<names.size();++j)
+		{
+		    group+="<weight id=\""+names[j]+"\"> </weight>\n";
+		}
+		group+="</weightgroup>\n";
+		if((pos=header.find("</initrwgt>"))!=std::string::npos)
+		{
+		    header.insert(pos,group);
+		}
+		else if((pos=header.find("</header>"))!=std::string::npos)
+		{
+		    header.insert(pos,"<initrwgt>\n"+group+"</initrwgt>\n");
+		}
+		else
+		{
+		    header.insert(header.find("<init>"),"<header>\n<initrwgt>\n"+group+"</initrwgt>\n</header>\n");
+		}
+		ofs.write(header.data(),header.size());
+		format_buffer buffer;
+		for(size_type i=0;i<events();++i)
+		{
+		    size_type first=event_begin[i],last=event_end[i];
+		    size_type block=text.find("</rwgt>",first);
+		    bool insert=(block<last);
+		    ofs.write(text.data()+first,(insert?block:last)-first);
+		    if(!insert)
+		    {
+			buffer.put("<rwgt>\n");
+		    }
+		    for(size_type j=0;j<names.size();++j)
+		    {
+			buffer.put("<wgt id=\"");
+			buffer.put(names[j]);
+			buffer.put("\"> ");
+			buffer.put_scientific(weights[j][i]);
+			buffer.put(" </wgt>\n");
+		    }
+		    if(!insert)
+		    {
+			buffer.put("</rwgt>\n");
+		    }
+		    buffer.write(ofs);
+		    if(insert)
+		    {
+			ofs.write(text.data()+block,last-block);
+		    }
+		    ofs.write("</event>\n",9);
+		}
+		ofs<<"</LesHouchesEvents>"<<std::endl;
+		ofs.close();
+		return !ofs.fail();
+	    }
+
+	private:
+
+	    /* File contents: */
+
+	    std::string text;
+
+	    /* Numbers of incoming and outgoing particles: */
+
+	    size_type n_in,n_out;
+
+	    /* End of the initialisation block: */
+
+	    size_type header_end;
+
+	    /* Positions of the event tags and the closing tags: */
+
+	    std::vector<size_type>event_begin,event_end;
+
+	    /* Event data: */
+
+	    std::vector<int>proc_ids;
+	    std::vector<double>ws,scales,alphas,alphas_s;
+
+	    /* Particle ids, colours and momenta: */
+
+	    std::vector<int>ids,cs,cbars;
+	    std::vector<double>momenta;
+
+	    /* Additional weight ids and values: */
+
+	    std::vector<std::string>weight_ids;
+	    std::vector<double>rwgt;
+
+	    /* Flag denoting whether a file was read: */
+
+	    bool opened;
+
+	    /* Reads the file contents: */
+
+	    bool read_file(const std::string& filename)
+	    {
+#if HAVE_ZLIB_H_
+		gzFile f=gzopen(filename.c_str(),"rb");
+		if(f==NULL)
+		{
+		    return false;
+		}
+		char chunk[1<<16];
+		int n;
+		while((n=gzread(f,chunk,sizeof(chunk)))>0)
+		{
+		    text.append(chunk,n);
+		}
+		gzclose(f);
+		return n==0;
+#else
+		std::ifstream ifs(filename.c_str(),std::ios::in|std::ios::binary);
+		if(!ifs.is_open())
+		{
+		    return false;
+		}
+		std::ostringstream os;
+		os<<ifs.rdbuf();
+		text=os.str();
+		return true;
+#endif
+	    }
+
+	    /* Reads an integer, advancing the position: */
+
+	    static bool read_int(const char*& s,long& n)
+	    {
+		char* e;
+		n=std::strtol(s,&e,10);
+		if(e==s)
+		{
+		    return false;
+		}
+		s=e;
+		return true;
+	    }
+
+	    /* Reads a floating-point number, advancing the position: */
+
+	    static bool read_double(const char*& s,double& x)
+	    {
+		char* e;
+		x=std::strtod(s,&e);
+		if(e==s)
+		{
+		    return false;
+		}
+		s=e;
+		return true;
+	    }
+
+	    /* Locates the initialisation block and the events: */
+
+	    bool parse()
+	    {
+		size_type pos=text.find("</init>");
+		if(text.find("<init>")==std::string::npos or pos==std::string::npos)
+		{
+		    return false;
+		}
+		header_end=text.find('\n',pos);
+		header_end=(header_end==std::string::npos)?text.size():(header_end+1);
+		pos=header_end;
+		while((pos=text.find("<event",pos))!=std::string::npos)
+		{
+		    size_type last=text.find("</event>",pos);
+		    if(last==std::string::npos or !parse_event(pos,last))
+		    {
+			return false;
+		    }
+		    event_begin.push_back(pos);
+		    event_end.push_back(last);
+		    pos=last+8;
+		}
+		return true;
+	    }
+
+	    /* Reads the event between the argument positions: */
+
+	    bool parse_event(size_type first,size_type last)
+	    {
+		size_type pos=text.find('>',first);
+		if(pos>=last)
+		{
+		    return false;
+		}
+		const char* s=text.c_str()+pos+1;
+		long nup,idprup;
+		double w,scale,a,as;
+		if(!read_int(s,nup) or !read_int(s,idprup) or !read_double(s,w) or !read_double(s,scale) or !read_double(s,a) or !read_double(s,as))
+		{
+		    return false;
+		}
+		size_type nin=0,nout=0,offset=ids.size();
+		for(long k=0;k<nup;++k)
+		{
+		    long idup,istup,moth1,moth2,col,acol;
+		    double q[5],vtim,spin;
+		    if(!read_int(s,idup) or !read_int(s,istup) or !read_int(s,moth1) or !read_int(s,moth2) or !read_int(s,col) or !read_int(s,acol))
+		    {
+			return false;
+		    }
+		    for(int mu=0;mu<5;++mu)
+		    {
+			if(!read_double(s,q[mu]))
+			{
+			    return false;
+			}
+		    }
+		    if(!read_double(s,vtim) or !read_double(s,spin))
+		    {
+			return false;
+		    }
+		    if(istup!=-1 and istup!=1)
+		    {
+			continue;
+		    }
+
+		    /* Incoming particles are inserted after the previous
+		     * incoming ones: */
+
+		    size_type n=(istup==-1)?(offset+nin):ids.size();
+		    ids.insert(ids.begin()+n,idup);
+		    cs.insert(cs.begin()+n,col);
+		    cbars.insert(cbars.begin()+n,acol);
+		    double p[4]={q[3],q[0],q[1],q[2]};
+		    momenta.insert(momenta.begin()+4*n,p,p+4);
+		    if(istup==-1)
+		    {
+			++nin;
+		    }
+		    else
+		    {
+			++nout;
+		    }
+		}
+		if(proc_ids.empty())
+		{
+		    n_in=nin;
+		    n_out=nout;
+		}
+		else if(nin!=n_in or nout!=n_out)
+		{
+		    return false;
+		}
+		proc_ids.push_back(idprup);
+		ws.push_back(w);
+		scales.push_back(scale);
+		alphas.push_back(a);
+		alphas_s.push_back(as);
+		return parse_weights(s-text.c_str(),last);
+	    }
+
+	    /* Reads the additional weights of the event between the argument
+	     * positions: */
+
+	    bool parse_weights(size_type first,size_type last)
+	    {
+		size_type n=0;
+		size_type pos=text.find("<rwgt>",first);
+		if(pos<last)
+		{
+		    while((pos=text.find("<wgt",pos))<last)
+		    {
+			size_type id=text.find("id=",pos);
+			if(id>=last)
+			{
+			    return false;
+			}
+			char quote=text[id+3];
+			size_type id_end=text.find(quote,id+4);
+			size_type tag_end=text.find('>',id_end);
+			if(tag_end>=last)
+			{
+			    return false;
+			}
+			std::string name(text,id+4,id_end-id-4);
+			if(proc_ids.size()==1)
+			{
+			    weight_ids.push_back(name);
+			}
+			else if(n>=weight_ids.size() or weight_ids[n]!=name)
+			{
+			    return false;
+			}
+			const char* s=text.c_str()+tag_end+1;
+			double x;
+			if(!read_double(s,x))
+			{
+			    return false;
+			}
+			rwgt.push_back(x);
+			++n;
+			pos=tag_end;
+		    }
+		}
+		return n==weight_ids.size();
+	    }
     };
 }
 
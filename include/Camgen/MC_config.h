@@ -29,7 +29,8 @@ namespace Camgen
 	    unused,
 	    uniform,
 	    longitudinal,
-	    summation
+	    summation,
+	    adaptive
 	};
     };
 
@@ -44,7 +45,8 @@ namespace Camgen
 	    unused,
 	    uniform,
 	    summation,
-	    flow_sampling
+	    flow_sampling,
+	    adaptive
 	};
     };
     
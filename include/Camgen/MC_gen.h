@@ -26,6 +26,133 @@
 
 namespace Camgen
 {
+    /// Weight sums of a Monte Carlo generator. Used to accumulate the cross
+    /// section statistics of concurrent generator copies, which can be merged
+    /// into the original generator afterwards.
+
+    template<class value_t>class MC_weight_sums
+    {
+	public:
+
+	    /* Type definitions: */
+
+	    typedef std::size_t size_type;
+	    typedef value_t value_type;
+
+	    /// Number of calls.
+
+	    size_type n_calls;
+
+	    /// Sums of the first to fourth powers of the weights.
+
+	    value_type wsum,w2sum,w3sum,w4sum;
+
+	    /// Maximal weight.
+
+	    value_type max_w;
+
+	    /// Weight histogram, NULL if absent.
+
+	    weight_histogrammer<value_t>* w_hist;
+
+	    /// Default constructor.
+
+	    MC_weight_sums():n_calls(0),wsum(0),w2sum(0),w3sum(0),w4sum(0),max_w(0),w_hist(NULL){}
+
+	    /// Copy constructor.
+
+	    MC_weight_sums(const MC_weight_sums<value_t>& other):n_calls(other.n_calls),wsum(other.wsum),w2sum(other.w2sum),w3sum(other.w3sum),w4sum(other.w4sum),max_w(other.max_w),w_hist(NULL)
+	    {
+		if(other.w_hist!=NULL)
+		{
+		    w_hist=new weight_histogrammer<value_t>(*other.w_hist);
+		}
+	    }
+
+	    /// Assignment operator.
+
+	    MC_weight_sums<value_t>& operator = (const MC_weight_sums<value_t>& other)
+	    {
+		if(this!=&other)
+		{
+		    n_calls=other.n_calls;
+		    wsum=other.wsum;
+		    w2sum=other.w2sum;
+		    w3sum=other.w3sum;
+		    w4sum=other.w4sum;
+		    max_w=other.max_w;
+		    if(w_hist!=NULL)
+		    {
+			delete w_hist;
+			w_hist=NULL;
+		    }
+		    if(other.w_hist!=NULL)
+		    {
+			w_hist=new weight_histogrammer<value_t>(*other.w_hist);
+		    }
+		}
+		return *this;
+	    }
+
+	    /// Destructor.
+
+	    ~MC_weight_sums()
+	    {
+		if(w_hist!=NULL)
+		{
+		    delete w_hist;
+		}
+	    }
+
+	    /// Sets up a weight histogram with the argument number of bins.
+
+	    void bin_weights(size_type bins)
+	    {
+		if(w_hist!=NULL)
+		{
+		    delete w_hist;
+		}
+		w_hist=new weight_histogrammer<value_t>(bins);
+	    }
+
+	    /// Adds a weight, skipping undefined or infinite values.
+
+	    void insert(const value_type& y)
+	    {
+		if(!(y==y and y!=std::numeric_limits<value_type>::infinity() and y!=-std::numeric_limits<value_type>::infinity()))
+		{
+		    return;
+		}
+		++n_calls;
+		max_w=std::max(y,max_w);
+		wsum+=y;
+		value_type y2=y*y;
+		w2sum+=y2;
+		w3sum+=(y2*y);
+		w4sum+=(y2*y2);
+		if(w_hist!=NULL)
+		{
+		    w_hist->insert(y);
+		}
+	    }
+
+	    /// Adds the argument sums.
+
+	    void merge(const MC_weight_sums<value_t>& other)
+	    {
+		n_calls+=other.n_calls;
+		wsum+=other.wsum;
+		w2sum+=other.w2sum;
+		w3sum+=other.w3sum;
+		w4sum+=other.w4sum;
+		max_w=std::max(max_w,other.max_w);
+		if(w_hist!=NULL and other.w_hist!=NULL)
+		{
+		    w_hist->merge(*other.w_hist);
+		}
+	    }
+    };
+
     template<class value_t>class MC_generator
     {
 	public:
@@ -152,6 +279,28 @@ namespace Camgen
 		up_to_date=false;
 	    }
 
+	    /// Adds the argument weight sums, e.g. accumulated by a concurrent
+	    /// copy of the generator, to the cross section data.
+
+	    virtual void add_weight_sums(const MC_weight_sums<value_t>& sums)
+	    {
+		if(sums.n_calls==0)
+		{
+		    return;
+		}
+		n_calls+=sums.n_calls;
+		wsum+=sums.wsum;
+		w2sum+=sums.w2sum;
+		w3sum+=sums.w3sum;
+		w4sum+=sums.w4sum;
+		max_w=std::max(max_w,sums.max_w);
+		if(w_hist!=NULL and sums.w_hist!=NULL)
+		{
+		    w_hist->merge(*sums.w_hist);
+		}
+		up_to_date=false;
+	    }
+
 	    /// Resets the the state of the MC generator. Resets adaptive
 	    /// channels weights and grids as well.
 
@@ -373,6 +522,13 @@ namespace Camgen
 		return sigma;
 	    }
 
+	    /// Returns the weight histogram (NULL if no histogram was built).
+
+	    const weight_histogrammer<value_t>* weight_histogram() const
+	    {
+		return w_hist;
+	    }
+
 	    /// Monte Carlo efficiency (in percentage).
 
 	    value_type efficiency() const
@@ -0,0 +1,670 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+/*! \file adapt_cols.h
+    \brief adaptive colour flow generator class template.
+ */
+
+#ifndef CAMGEN_ADAPT_COLS_H_
+#define CAMGEN_ADAPT_COLS_H_
+
+#include <cmath>
+#include <Camgen/qcd_cols.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Adaptive colour flow generator for QCD-like models in the colour flow        *
+ * representation. Like the colour_flow_QCD generator, only colour-conserving    *
+ * assignments are generated: every colour line is connected to an anticolour  *
+ * line by a permutation (the flow) and carries a uniformly drawn colour. In     *
+ * contrast, the flows are sampled with individual probabilities, which are     *
+ * adapted by the multichannel algorithm. The weight of a colour assignment     *
+ * sums the probabilities of all flows compatible with it. Flows that have been *
+ * compatible with sufficiently many events without ever yielding a nonzero     *
+ * integrand are discarded. For continuous colours, the generator reduces to   *
+ * the colour_flow_QCD generator.                                               *
+ *                                                                               *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+namespace Camgen
+{
+    /* Adaptive colour flow generator class template declaration. */
+
+    template<class value_t,std::size_t N_in,std::size_t N_out,std::size_t N_c,class rng_t,bool continuous_colours>class adaptive_colour_flows;
+
+    /* Adaptive colour flow generator specialisation for discrete colours. */
+
+    template<class value_t,std::size_t N_in,std::size_t N_out,std::size_t N_c,class rng_t>class adaptive_colour_flows<value_t,N_in,N_out,N_c,rng_t,false>: public colour_generator<value_t,N_in,N_out,false>
+    {
+	public:
+
+	    /* Useful type definitions: */
+	    /*--------------------------*/
+
+	    typedef value_t value_type;
+	    typedef colour_generator<value_t,N_in,N_out,false> base_type;
+	    typedef colour_flow_QCD<value_t,N_in,N_out,N_c,rng_t,false> flow_generator_type;
+	    typedef random_number_stream<value_type,rng_t> rn_stream;
+	    typedef typename base_type::size_type size_type;
+
+	    /* Public static data: */
+	    /*---------------------*/
+
+	    static const std::size_t N_tot=N_in+N_out;
+
+	    /* Public static functions: */
+	    /*--------------------------*/
+
+	    /* Factory method: */
+
+	    template<class model_t>static adaptive_colour_flows<value_t,N_in,N_out,N_c,rng_t,false>* create_instance(typename CM_algorithm<model_t,N_in,N_out>::tree_iterator it)
+	    {
+		adaptive_colour_flows<value_t,N_in,N_out,N_c,rng_t,false>* result=new adaptive_colour_flows<value_t,N_in,N_out,N_c,rng_t,false>(base_type::template make_colour_vector<model_t>(it),flow_generator_type::template make_type_vector<model_t>(it));
+		result->prefactor=base_type::template make_prefactor<model_t>(it);
+		return result;
+	    }
+
+	    /* Public constructors: */
+	    /*----------------------*/
+
+	    /* Standalone-mode constructor. Argument array entry 0 is
+	     * interpreted as a singlet, 1 or -1 as fundamental representation
+	     * particles, and 2 or -2 for adjoint representations. */
+
+	    adaptive_colour_flows(vector<int,N_tot>types):base_type(flow_generator_type::make_rank_vector(types),N_c),mixing(0.1),discard_threshold(100),flow(0),flow_sum(0)
+	    {
+		vector<std::vector<int>,N_tot>type_vector;
+		for(size_type i=0;i<N_tot;++i)
+		{
+		    if(types[i]==1 or types[i]==-1)
+		    {
+			type_vector[i].push_back(types[i]);
+		    }
+		}
+		init(type_vector);
+	    }
+
+	    /* Non-allocating constructor. */
+
+	    adaptive_colour_flows(const vector<std::vector<size_type>*,N_tot>& cols_,const vector<std::vector<int>,N_tot>& types):base_type(cols_,N_c),mixing(0.1),discard_threshold(100),flow(0),flow_sum(0)
+	    {
+		init(types);
+	    }
+
+	    /* Public modifiers: */
+	    /*-------------------*/
+
+	    /* Generation method. Selects a flow according to the current
+	     * probabilities, draws the line colours uniformly and computes the
+	     * weight from the flows compatible with the assignment. */
+
+	    bool generate()
+	    {
+		if(weight_factor==(value_type)0)
+		{
+		    this->weight()=(value_type)0;
+		    return false;
+		}
+		value_type r=rn_stream::throw_number();
+		flow=std::upper_bound(cumulants.begin(),cumulants.end(),r)-cumulants.begin();
+		if(flow>=alphas.size())
+		{
+		    flow=alphas.size()-1;
+		}
+		while(alphas[flow]==(value_type)0 and flow>0)
+		{
+		    --flow;
+		}
+		unrank(flow,permutation);
+		for(size_type i=0;i<colours.size();++i)
+		{
+		    size_type c=rn_stream::throw_dice(N_c);
+		    this->colour(colours[i].first,colours[i].second)=c;
+		    this->colour(anti_colours[permutation[i]].first,anti_colours[permutation[i]].second)=c;
+		    shuffled_anti_colours[i]=anti_colours[permutation[i]];
+		}
+		return compute_weight();
+	    }
+
+	    /* Event weight evaluation implementation. */
+
+	    bool evaluate_weight()
+	    {
+		if(weight_factor==(value_type)0)
+		{
+		    this->weight()=(value_type)0;
+		    return false;
+		}
+		if(!compute_weight())
+		{
+		    return false;
+		}
+		unrank(compatible_flows[0],permutation);
+		for(size_type i=0;i<colours.size();++i)
+		{
+		    shuffled_anti_colours[i]=anti_colours[permutation[i]];
+		}
+		return true;
+	    }
+
+	    /* Accumulates the multichannel weights of the flows compatible
+	     * with the last colour assignment: */
+
+	    void update()
+	    {
+		value_type f=this->integrand();
+		if(!this->valid(f) or flow_sum==(value_type)0)
+		{
+		    return;
+		}
+		value_type wf=this->weight()*f;
+		value_type w2=wf*wf/flow_sum;
+		for(size_type k=0;k<compatible_flows.size();++k)
+		{
+		    size_type n=compatible_flows[k];
+		    ++calls[n];
+		    w2sums[n]+=w2;
+		    if(f!=(value_type)0)
+		    {
+			nonzero[n]=true;
+		    }
+		}
+	    }
+
+	    /* Adapts the flow probabilities, discarding flows that never
+	     * contributed: */
+
+	    void adapt()
+	    {
+		value_type norm=0;
+		std::vector<value_type>betas(alphas.size(),(value_type)0);
+		for(size_type k=0;k<alphas.size();++k)
+		{
+		    if(!discarded[k] and !nonzero[k] and calls[k]>=discard_threshold)
+		    {
+			discarded[k]=true;
+		    }
+		    if(!discarded[k])
+		    {
+			betas[k]=alphas[k]*std::sqrt(w2sums[k]);
+			norm+=betas[k];
+		    }
+		}
+		if(norm==(value_type)0)
+		{
+		    return;
+		}
+		size_type n_active=std::count(discarded.begin(),discarded.end(),false);
+		for(size_type k=0;k<alphas.size();++k)
+		{
+		    alphas[k]=discarded[k]?(value_type)0:(mixing/n_active+((value_type)1-mixing)*betas[k]/norm);
+		    w2sums[k]=(value_type)0;
+		}
+		refresh_cumulants();
+	    }
+
+	    /* Resets the generator, including the adapted probabilities: */
+
+	    void reset()
+	    {
+		this->base_type::reset();
+		reset_flows();
+	    }
+
+	    /* Sets the fraction of uniformly distributed flows: */
+
+	    void set_mixing(const value_type& x)
+	    {
+		mixing=std::min(std::max(x,(value_type)0),(value_type)1);
+	    }
+
+	    /* Sets the minimal number of vanishing compatible events before
+	     * discarding a flow: */
+
+	    void set_discard_threshold(size_type n)
+	    {
+		discard_threshold=n;
+	    }
+
+	    /* Public const methods: */
+	    /*-----------------------*/
+
+	    /* Clone method: */
+
+	    adaptive_colour_flows<value_t,N_in,N_out,N_c,rng_t,false>* clone() const
+	    {
+		return new adaptive_colour_flows<value_t,N_in,N_out,N_c,rng_t,false>(*this);
+	    }
+
+	    /* Returns the number of colour flows: */
+
+	    size_type flows() const
+	    {
+		return alphas.size();
+	    }
+
+	    /* Returns the probability of the k-th flow: */
+
+	    const value_type& probability(size_type k) const
+	    {
+		return alphas[k];
+	    }
+
+	    /* Returns whether the k-th flow has been discarded: */
+
+	    bool is_discarded(size_type k) const
+	    {
+		return discarded[k];
+	    }
+
+	    /* Returns the number of discarded flows: */
+
+	    size_type discarded_flows() const
+	    {
+		return std::count(discarded.begin(),discarded.end(),true);
+	    }
+
+	    /* Serialization: */
+	    /*----------------*/
+
+	    /* Les Houches event file output. This will convert the
+	     * configuration to an infinite-colour output, starting from colour
+	     * number 501: */
+
+	    void LH_output(vector<int,N_tot>& cols,vector<int,N_tot>& anticols) const
+	    {
+		int n=501;
+		cols.assign(0);
+		anticols.assign(0);
+		for(size_type i=0;i<colours.size();++i)
+		{
+		    if(colours[i].first<2)
+		    {
+			cols[colours[i].first]=n;
+		    }
+		    else
+		    {
+			anticols[colours[i].first]=n;
+		    }
+		    if(shuffled_anti_colours[i].first<2)
+		    {
+			anticols[shuffled_anti_colours[i].first]=n;
+		    }
+		    else
+		    {
+			cols[shuffled_anti_colours[i].first]=n;
+		    }
+		    ++n;
+		}
+	    }
+
+	    /* Polymorphic type identifier: */
+
+	    std::string type() const
+	    {
+		return "adaptive";
+	    }
+
+	    /* Derived loading method: */
+
+	    std::istream& load_data(std::istream& is)
+	    {
+		size_type n;
+		is>>n;
+		if(n!=alphas.size())
+		{
+		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"incorrect number of colour flows read from input stream--aborting load"<<endlog;
+		    return is;
+		}
+		safe_read(is,mixing);
+		is>>discard_threshold;
+		for(size_type k=0;k<n;++k)
+		{
+		    bool q1,q2;
+		    safe_read(is,alphas[k]);
+		    is>>calls[k];
+		    safe_read(is,w2sums[k]);
+		    is>>q1>>q2;
+		    nonzero[k]=q1;
+		    discarded[k]=q2;
+		}
+		refresh_cumulants();
+		return is;
+	    }
+
+	    /* Derived saving method: */
+
+	    std::ostream& save_data(std::ostream& os) const
+	    {
+		os<<alphas.size()<<std::endl;
+		safe_write(os,mixing);
+		os<<"\t"<<discard_threshold<<std::endl;
+		for(size_type k=0;k<alphas.size();++k)
+		{
+		    safe_write(os,alphas[k]);
+		    os<<"\t"<<calls[k]<<"\t";
+		    safe_write(os,w2sums[k]);
+		    os<<"\t"<<nonzero[k]<<"\t"<<discarded[k]<<std::endl;
+		}
+		return os;
+	    }
+
+	private:
+
+	    /* Private data: */
+	    /*---------------*/
+
+	    /* Vector of particle numbers that carry colour: */
+
+	    std::vector< std::pair<size_type,int> >colours;
+
+	    /* Vector of particle numbers that carry anticolour: */
+
+	    std::vector< std::pair<size_type,int> >anti_colours;
+
+	    /* Anticolour partners of the colour lines in the last flow: */
+
+	    std::vector< std::pair<size_type,int> >shuffled_anti_colours;
+
+	    /* Weight numerator: */
+
+	    value_type weight_factor;
+
+	    /* Flow probabilities and their cumulative sums: */
+
+	    std::vector<value_type>alphas;
+	    std::vector<value_type>cumulants;
+
+	    /* Per-flow counts of compatible events and multichannel weight
+	     * sums: */
+
+	    std::vector<size_type>calls;
+	    std::vector<value_type>w2sums;
+
+	    /* Flags denoting flows compatible with a nonzero integrand, and
+	     * discarded flows: */
+
+	    std::vector<bool>nonzero;
+	    std::vector<bool>discarded;
+
+	    /* Uniform fraction of the probabilities: */
+
+	    value_type mixing;
+
+	    /* Minimal number of vanishing compatible events before
+	     * discarding: */
+
+	    size_type discard_threshold;
+
+	    /* Index of the last generated flow: */
+
+	    size_type flow;
+
+	    /* Flows compatible with the last colour assignment and the sum of
+	     * their probabilities: */
+
+	    std::vector<size_type>compatible_flows;
+	    value_type flow_sum;
+
+	    /* Permutation buffers: */
+
+	    std::vector<size_type>permutation;
+	    std::vector<bool>used;
+
+	    /* Private modifiers: */
+	    /*--------------------*/
+
+	    /* Collects the colour and anticolour lines and enumerates the
+	     * flows: */
+
+	    void init(const vector<std::vector<int>,N_tot>& types)
+	    {
+		size_type wf_denom(1);
+		for(size_type i=0;i<N_in;++i)
+		{
+		    if(this->colour_rank(i)==1)
+		    {
+			if(types[i][0]==1)
+			{
+			    colours.push_back(std::pair<size_type,int>(i,0));
+			}
+			if(types[i][0]==-1)
+			{
+			    anti_colours.push_back(std::pair<size_type,int>(i,0));
+			}
+		    }
+		    else if(this->colour_rank(i)==2)
+		    {
+			colours.push_back(std::pair<size_type,int>(i,0));
+			anti_colours.push_back(std::pair<size_type,int>(i,1));
+			wf_denom*=2;
+		    }
+		}
+		for(size_type i=N_in;i<N_tot;++i)
+		{
+		    if(this->colour_rank(i)==1)
+		    {
+			if(types[i][0]==1)
+			{
+			    anti_colours.push_back(std::pair<size_type,int>(i,0));
+			}
+			if(types[i][0]==-1)
+			{
+			    colours.push_back(std::pair<size_type,int>(i,0));
+			}
+		    }
+		    else if(this->colour_rank(i)==2)
+		    {
+			anti_colours.push_back(std::pair<size_type,int>(i,0));
+			colours.push_back(std::pair<size_type,int>(i,1));
+			wf_denom*=2;
+		    }
+		}
+		if(colours.size()!=anti_colours.size())
+		{
+		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"process allows no colour-conserving flows: all returned weight will be 0"<<endlog;
+		    weight_factor=(value_type)0;
+		    return;
+		}
+		size_type wf_num(1);
+		for(size_type i=0;i<colours.size();++i)
+		{
+		    wf_num*=N_c;
+		}
+		weight_factor=(value_type)wf_num/(value_type)wf_denom;
+		shuffled_anti_colours=anti_colours;
+		permutation.resize(colours.size());
+		used.resize(colours.size());
+		reset_flows();
+	    }
+
+	    /* Sets uniform flow probabilities and clears the statistics: */
+
+	    void reset_flows()
+	    {
+		size_type n=factorial(colours.size());
+		alphas.assign(n,(value_type)1/n);
+		calls.assign(n,0);
+		w2sums.assign(n,(value_type)0);
+		nonzero.assign(n,false);
+		discarded.assign(n,false);
+		flow=0;
+		refresh_cumulants();
+	    }
+
+	    /* Recomputes the cumulative probabilities: */
+
+	    void refresh_cumulants()
+	    {
+		cumulants.resize(alphas.size());
+		value_type s=0;
+		for(size_type k=0;k<alphas.size();++k)
+		{
+		    s+=alphas[k];
+		    cumulants[k]=s;
+		}
+		for(size_type k=0;k<alphas.size();++k)
+		{
+		    cumulants[k]/=s;
+		}
+	    }
+
+	    /* Collects the flows compatible with the current colour assignment
+	     * and assigns the weight. Returns false if there are none: */
+
+	    bool compute_weight()
+	    {
+		compatible_flows.clear();
+		flow_sum=(value_type)0;
+		used.assign(colours.size(),false);
+		collect_flows(0);
+		if(flow_sum==(value_type)0)
+		{
+		    this->weight()=(value_type)0;
+		    return false;
+		}
+		this->weight()=weight_factor/flow_sum;
+		return true;
+	    }
+
+	    /* Recursive enumeration of the anticolour lines matching the
+	     * colours of lines i and higher: */
+
+	    void collect_flows(size_type i)
+	    {
+		if(i==colours.size())
+		{
+		    size_type k=rank(permutation);
+		    compatible_flows.push_back(k);
+		    flow_sum+=alphas[k];
+		    return;
+		}
+		size_type c=this->colour(colours[i].first,colours[i].second);
+		for(size_type j=0;j<anti_colours.size();++j)
+		{
+		    if(!used[j] and this->colour(anti_colours[j].first,anti_colours[j].second)==c)
+		    {
+			used[j]=true;
+			permutation[i]=j;
+			collect_flows(i+1);
+			used[j]=false;
+		    }
+		}
+	    }
+
+	    /* Returns the lexicographic index of the argument permutation: */
+
+	    size_type rank(const std::vector<size_type>& p) const
+	    {
+		size_type k=0;
+		for(size_type i=0;i<p.size();++i)
+		{
+		    size_type d=0;
+		    for(size_type j=i+1;j<p.size();++j)
+		    {
+			if(p[j]<p[i])
+			{
+			    ++d;
+			}
+		    }
+		    k=k*(p.size()-i)+d;
+		}
+		return k;
+	    }
+
+	    /* Fills the argument with the k-th permutation in lexicographic
+	     * order: */
+
+	    void unrank(size_type k,std::vector<size_type>& p)
+	    {
+		size_type n=p.size();
+		std::vector<size_type>digits(n,0);
+		for(size_type i=n;i>0;--i)
+		{
+		    digits[i-1]=k%(n-i+1);
+		    k/=(n-i+1);
+		}
+		used.assign(n,false);
+		for(size_type i=0;i<n;++i)
+		{
+		    size_type d=digits[i];
+		    for(size_type j=0;j<n;++j)
+		    {
+			if(!used[j])
+			{
+			    if(d==0)
+			    {
+				p[i]=j;
+				used[j]=true;
+				break;
+			    }
+			    --d;
+			}
+		    }
+		}
+	    }
+    };
+    template<class value_t,std::size_t N_in,std::size_t N_out,std::size_t N_c,class rng_t>const std::size_t adaptive_colour_flows<value_t,N_in,N_out,N_c,rng_t,false>::N_tot;
+
+    /* Adaptive colour flow generator specialisation for continuous colours,
+     * which reduces to the colour_flow_QCD generator. */
+
+    template<class value_t,std::size_t N_in,std::size_t N_out,std::size_t N_c,class rng_t>class adaptive_colour_flows<value_t,N_in,N_out,N_c,rng_t,true>: public colour_flow_QCD<value_t,N_in,N_out,N_c,rng_t,true>
+    {
+	public:
+
+	    /* Useful type definitions: */
+	    /*--------------------------*/
+
+	    typedef value_t value_type;
+	    typedef colour_flow_QCD<value_t,N_in,N_out,N_c,rng_t,true> base_type;
+
+	    /* Public static data: */
+	    /*---------------------*/
+
+	    static const std::size_t N_tot=N_in+N_out;
+
+	    /* Public static functions: */
+	    /*--------------------------*/
+
+	    /* Factory method: */
+
+	    template<class model_t>static adaptive_colour_flows<value_t,N_in,N_out,N_c,rng_t,true>* create_instance(typename CM_algorithm<model_t,N_in,N_out>::tree_iterator it)
+	    {
+		adaptive_colour_flows<value_t,N_in,N_out,N_c,rng_t,true>* result=new adaptive_colour_flows<value_t,N_in,N_out,N_c,rng_t,true>(colour_generator<value_t,N_in,N_out,true>::template make_colour_tensor_vector<model_t>(it));
+		result->prefactor=colour_generator<value_t,N_in,N_out,true>::template make_prefactor<model_t>(it);
+		return result;
+	    }
+
+	    /* Public constructors: */
+	    /*----------------------*/
+
+	    /* Non-allocating constructor. */
+
+	    adaptive_colour_flows(const vector<tensor< std::complex<value_t> >*,N_tot>& cols_):base_type(cols_){}
+
+	    /* Public const methods: */
+	    /*-----------------------*/
+
+	    /* Clone method: */
+
+	    adaptive_colour_flows<value_t,N_in,N_out,N_c,rng_t,true>* clone() const
+	    {
+		return new adaptive_colour_flows<value_t,N_in,N_out,N_c,rng_t,true>(*this);
+	    }
+
+	    /* Polymorphic type identifier: */
+
+	    std::string type() const
+	    {
+		return "adaptive";
+	    }
+    };
+    template<class value_t,std::size_t N_in,std::size_t N_out,std::size_t N_c,class rng_t>const std::size_t adaptive_colour_flows<value_t,N_in,N_out,N_c,rng_t,true>::N_tot;
+}
+
+#endif /*CAMGEN_ADAPT_COLS_H_*/
+
@@ -0,0 +1,474 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+/*! \file adapt_hels.h
+    \brief adaptive helicity generator class template.
+ */
+
+#ifndef CAMGEN_ADAPT_HELS_H_
+#define CAMGEN_ADAPT_HELS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <Camgen/uni_hels.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Adaptive helicity generator. In the discrete case, all helicity              *
+ * configurations are enumerated and sampled with individual probabilities. The  *
+ * update() method accumulates the squared integrand per configuration, and      *
+ * adapt() sets the probabilities proportional to the root-mean-square           *
+ * integrand, mixed with a uniform fraction to keep every configuration         *
+ * reachable. Configurations that have been sampled sufficiently often and only *
+ * yielded vanishing integrands are discarded. For continuous helicities there   *
+ * is nothing to adapt, and the generator reduces to uniform phase sampling.     *
+ *                                                                               *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+namespace Camgen
+{
+    /* Adaptive helicity generator class template declaration. */
+
+    template<class value_t,std::size_t N_in,std::size_t N_out,class rng_t,bool q>class adaptive_helicities;
+
+    /* Adaptive helicity specialisation for discrete helicities. */
+
+    template<class value_t,std::size_t N_in,std::size_t N_out,class rng_t>class adaptive_helicities<value_t,N_in,N_out,rng_t,false>: public helicity_generator<value_t,N_in,N_out,false>
+    {
+	public:
+
+	    /* Type definitions: */
+	    /*-------------------*/
+
+	    typedef value_t value_type;
+	    typedef helicity_generator<value_t,N_in,N_out,false> base_type;
+	    typedef random_number_stream<value_t,rng_t> rn_stream;
+	    typedef typename base_type::size_type size_type;
+
+	    /* Public static data: */
+	    /*---------------------*/
+
+	    /* Static integer constants: */
+
+	    static const std::size_t N_tot=N_in+N_out;
+
+	    /* Public static methods: */
+	    /*------------------------*/
+
+	    /* Factory method: */
+
+	    template<class model_t>static adaptive_helicities<value_t,N_in,N_out,rng_t,false>* create_instance(typename CM_algorithm<model_t,N_in,N_out>::tree_iterator it)
+	    {
+		return new adaptive_helicities<value_t,N_in,N_out,rng_t,false>(base_type::template make_helicity_vector<model_t>(it),base_type::template make_max_helicity_vector<model_t>(it),base_type::template make_zero_helicity_bitset<model_t>(it));
+	    }
+
+	    /* Public constructors: */
+	    /*----------------------*/
+
+	    /* Non-allocating constructor (see helicity generator base class).
+	     * Initialises uniform configuration probabilities. */
+
+	    adaptive_helicities(const vector<int*,N_tot>& hels_,const vector<int,N_tot>& max_hels_,std::bitset<N_tot> zero_hels_):base_type(hels_,max_hels_,zero_hels_),mixing(0.1),discard_threshold(100),config(0)
+	    {
+		init();
+	    }
+
+	    /* Allocating constructor (see helicity generator base class).
+	     * Initialises uniform configuration probabilities. */
+
+	    adaptive_helicities(const vector<int,N_tot>& max_hels_,std::bitset<N_tot> zero_hels_):base_type(max_hels_,zero_hels_),mixing(0.1),discard_threshold(100),config(0)
+	    {
+		init();
+	    }
+
+	    /* Public modifiers: */
+	    /*-------------------*/
+
+	    /* Generation operator implementation. Selects a configuration
+	     * according to the current probabilities and assigns the inverse
+	     * probability to the weight. */
+
+	    bool generate()
+	    {
+		value_type r=rn_stream::throw_number();
+		config=std::upper_bound(cumulants.begin(),cumulants.end(),r)-cumulants.begin();
+		if(config>=alphas.size())
+		{
+		    config=alphas.size()-1;
+		}
+		while(alphas[config]==(value_type)0 and config>0)
+		{
+		    --config;
+		}
+		decode(config);
+		this->weight()=(value_type)1/alphas[config];
+		return true;
+	    }
+
+	    /* Weight evaluation method. Assigns the inverse probability of the
+	     * current helicity configuration to the weight. */
+
+	    bool evaluate_weight()
+	    {
+		config=encode();
+		if(alphas[config]==(value_type)0)
+		{
+		    this->weight()=(value_type)0;
+		    return false;
+		}
+		this->weight()=(value_type)1/alphas[config];
+		return true;
+	    }
+
+	    /* Accumulates the squared integrand for the last configuration: */
+
+	    void update()
+	    {
+		value_type f=this->integrand();
+		if(!this->valid(f))
+		{
+		    return;
+		}
+		++calls[config];
+		f2sums[config]+=(f*f);
+	    }
+
+	    /* Adapts the configuration probabilities to the accumulated
+	     * integrand statistics, discarding vanishing configurations: */
+
+	    void adapt()
+	    {
+		bool nonzero=false;
+		for(size_type k=0;k<alphas.size();++k)
+		{
+		    if(f2sums[k]>(value_type)0)
+		    {
+			nonzero=true;
+			break;
+		    }
+		}
+		if(!nonzero)
+		{
+		    return;
+		}
+		size_type n_active=0;
+		value_type norm=0;
+		std::vector<value_type>rms(alphas.size(),(value_type)0);
+		for(size_type k=0;k<alphas.size();++k)
+		{
+		    if(!discarded[k] and calls[k]>=discard_threshold and f2sums[k]==(value_type)0)
+		    {
+			discarded[k]=true;
+		    }
+		    if(discarded[k])
+		    {
+			continue;
+		    }
+		    ++n_active;
+		    if(calls[k]!=0)
+		    {
+			rms[k]=std::sqrt(f2sums[k]/calls[k]);
+			norm+=rms[k];
+		    }
+		}
+		for(size_type k=0;k<alphas.size();++k)
+		{
+		    if(discarded[k])
+		    {
+			alphas[k]=(value_type)0;
+		    }
+		    else
+		    {
+			alphas[k]=mixing/n_active+((value_type)1-mixing)*rms[k]/norm;
+		    }
+		}
+		refresh_cumulants();
+	    }
+
+	    /* Resets the generator, including the adapted probabilities: */
+
+	    void reset()
+	    {
+		this->base_type::reset();
+		init();
+	    }
+
+	    /* Sets the fraction of uniformly distributed configurations: */
+
+	    void set_mixing(const value_type& x)
+	    {
+		mixing=std::min(std::max(x,(value_type)0),(value_type)1);
+	    }
+
+	    /* Sets the minimal number of vanishing calls before discarding a
+	     * configuration: */
+
+	    void set_discard_threshold(size_type n)
+	    {
+		discard_threshold=n;
+	    }
+
+	    /* Public const methods: */
+	    /*-----------------------*/
+
+	    /* Clone method implementation: */
+
+	    adaptive_helicities<value_t,N_in,N_out,rng_t,false>* clone() const
+	    {
+		return new adaptive_helicities<value_t,N_in,N_out,rng_t,false>(*this);
+	    }
+
+	    /* Returns the number of helicity configurations: */
+
+	    size_type configurations() const
+	    {
+		return alphas.size();
+	    }
+
+	    /* Returns the probability of the k-th configuration: */
+
+	    const value_type& probability(size_type k) const
+	    {
+		return alphas[k];
+	    }
+
+	    /* Returns whether the k-th configuration has been discarded: */
+
+	    bool is_discarded(size_type k) const
+	    {
+		return discarded[k];
+	    }
+
+	    /* Returns the number of discarded configurations: */
+
+	    size_type discarded_configurations() const
+	    {
+		return std::count(discarded.begin(),discarded.end(),true);
+	    }
+
+	    /* Serialization: */
+	    /*----------------*/
+
+	    std::string type() const
+	    {
+		return "adaptive";
+	    }
+
+	    /* Derived loading method: */
+
+	    std::istream& load_data(std::istream& is)
+	    {
+		size_type n;
+		is>>n;
+		if(n!=alphas.size())
+		{
+		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"incorrect number of helicity configurations read from input stream--aborting load"<<endlog;
+		    return is;
+		}
+		safe_read(is,mixing);
+		is>>discard_threshold;
+		for(size_type k=0;k<n;++k)
+		{
+		    bool q;
+		    safe_read(is,alphas[k]);
+		    is>>calls[k];
+		    safe_read(is,f2sums[k]);
+		    is>>q;
+		    discarded[k]=q;
+		}
+		refresh_cumulants();
+		return is;
+	    }
+
+	    /* Derived saving method: */
+
+	    std::ostream& save_data(std::ostream& os) const
+	    {
+		os<<alphas.size()<<std::endl;
+		safe_write(os,mixing);
+		os<<"\t"<<discard_threshold<<std::endl;
+		for(size_type k=0;k<alphas.size();++k)
+		{
+		    safe_write(os,alphas[k]);
+		    os<<"\t"<<calls[k]<<"\t";
+		    safe_write(os,f2sums[k]);
+		    os<<"\t"<<discarded[k]<<std::endl;
+		}
+		return os;
+	    }
+
+	private:
+
+	    /* Numbers of helicity states per particle: */
+
+	    vector<size_type,N_tot>n_hels;
+
+	    /* Configuration probabilities and their cumulative sums: */
+
+	    std::vector<value_type>alphas;
+	    std::vector<value_type>cumulants;
+
+	    /* Per-configuration call counts and squared integrand sums: */
+
+	    std::vector<size_type>calls;
+	    std::vector<value_type>f2sums;
+
+	    /* Discarded configuration flags: */
+
+	    std::vector<bool>discarded;
+
+	    /* Uniform fraction of the probabilities: */
+
+	    value_type mixing;
+
+	    /* Minimal number of vanishing calls before discarding: */
+
+	    size_type discard_threshold;
+
+	    /* Index of the last generated configuration: */
+
+	    size_type config;
+
+	    /* Enumerates the configurations and sets uniform probabilities: */
+
+	    void init()
+	    {
+		size_type n=1;
+		for(size_type i=0;i<N_tot;++i)
+		{
+		    int j=this->maximal_helicity(i);
+		    n_hels[i]=(j==0)?1:(this->has_zero_helicity(i)?(2*j+1):(2*j));
+		    n*=n_hels[i];
+		}
+		alphas.assign(n,(value_type)1/n);
+		calls.assign(n,0);
+		f2sums.assign(n,(value_type)0);
+		discarded.assign(n,false);
+		config=0;
+		refresh_cumulants();
+	    }
+
+	    /* Recomputes the cumulative probabilities: */
+
+	    void refresh_cumulants()
+	    {
+		cumulants.resize(alphas.size());
+		value_type s=0;
+		for(size_type k=0;k<alphas.size();++k)
+		{
+		    s+=alphas[k];
+		    cumulants[k]=s;
+		}
+		for(size_type k=0;k<alphas.size();++k)
+		{
+		    cumulants[k]/=s;
+		}
+	    }
+
+	    /* Assigns the helicities of the k-th configuration, where the
+	     * first particle runs fastest: */
+
+	    void decode(size_type k)
+	    {
+		for(size_type i=0;i<N_tot;++i)
+		{
+		    int j=this->maximal_helicity(i);
+		    int l=k%n_hels[i];
+		    k/=n_hels[i];
+		    if(j==0)
+		    {
+			continue;
+		    }
+		    if(this->has_zero_helicity(i))
+		    {
+			this->helicity(i)=l-j;
+		    }
+		    else
+		    {
+			this->helicity(i)=(l<j)?(l-j):(l-j+1);
+		    }
+		}
+	    }
+
+	    /* Returns the index of the current helicity configuration: */
+
+	    size_type encode() const
+	    {
+		size_type k=0;
+		for(size_type i=N_tot;i>0;--i)
+		{
+		    int j=this->maximal_helicity(i-1);
+		    int h=this->helicity(i-1);
+		    int l=0;
+		    if(j!=0)
+		    {
+			l=(this->has_zero_helicity(i-1) or h<0)?(h+j):(h+j-1);
+		    }
+		    k=k*n_hels[i-1]+l;
+		}
+		return k;
+	    }
+    };
+    template<class value_t,std::size_t N_in,std::size_t N_out,class rng_t>const std::size_t adaptive_helicities<value_t,N_in,N_out,rng_t,false>::N_tot;
+
+    /* Adaptive helicity specialisation for continuous helicities, which
+     * reduces to uniform phase sampling. */
+
+    template<class value_t,std::size_t N_in,std::size_t N_out,class rng_t>class adaptive_helicities<value_t,N_in,N_out,rng_t,true>: public uniform_helicities<value_t,N_in,N_out,rng_t,true>
+    {
+	public:
+
+	    /* Type definitions: */
+	    /*-------------------*/
+
+	    typedef value_t value_type;
+	    typedef uniform_helicities<value_t,N_in,N_out,rng_t,true> base_type;
+
+	    /* Public static data: */
+	    /*---------------------*/
+
+	    static const std::size_t N_tot=N_in+N_out;
+
+	    /* Public static methods: */
+	    /*------------------------*/
+
+	    /* Factory method: */
+
+	    template<class model_t>static adaptive_helicities<value_t,N_in,N_out,rng_t,true>* create_instance(typename CM_algorithm<model_t,N_in,N_out>::tree_iterator it)
+	    {
+		return new adaptive_helicities<value_t,N_in,N_out,rng_t,true>(base_type::base_type::template make_helicity_vector<model_t>(it));
+	    }
+
+	    /* Public constructors: */
+	    /*----------------------*/
+
+	    /* Non-allocating constructor (see helicity generator base class). */
+
+	    adaptive_helicities(const vector<helicity_phases<value_type>*,N_tot>& hels_):base_type(hels_){}
+
+	    /* Public const methods: */
+	    /*-----------------------*/
+
+	    /* Clone method implementation: */
+
+	    adaptive_helicities<value_t,N_in,N_out,rng_t,true>* clone() const
+	    {
+		return new adaptive_helicities<value_t,N_in,N_out,rng_t,true>(*this);
+	    }
+
+	    /* Serialization: */
+	    /*----------------*/
+
+	    std::string type() const
+	    {
+		return "adaptive";
+	    }
+    };
+    template<class value_t,std::size_t N_in,std::size_t N_out,class rng_t>const std::size_t adaptive_helicities<value_t,N_in,N_out,rng_t,true>::N_tot;
+}
+
+#endif /*CAMGEN_ADAPT_HELS_H_*/
+
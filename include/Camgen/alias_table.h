@@ -0,0 +1,164 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+/*! \file alias_table.h
+    \brief Alias table for constant-time sampling of discrete distributions.
+ */
+
+#ifndef CAMGEN_ALIAS_TABLE_H_
+#define CAMGEN_ALIAS_TABLE_H_
+
+#include <cstddef>
+#include <vector>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Walker alias table, constructed with Vose's method. After an O(n) set-up,  *
+ * an index is drawn from the discrete distribution defined by the input       *
+ * weights with a single uniform random number in constant time. Entries with  *
+ * vanishing or negative weight are never drawn.                               *
+ *                                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+namespace Camgen
+{
+    /// Alias table class template.
+
+    template<class value_t>class alias_table
+    {
+	public:
+
+	    /* Type definitions: */
+
+	    typedef value_t value_type;
+	    typedef std::size_t size_type;
+
+	    /// Clears the table.
+
+	    void clear()
+	    {
+		prob.clear();
+		alias.clear();
+	    }
+
+	    /// Returns whether the table is empty.
+
+	    bool empty() const
+	    {
+		return prob.empty();
+	    }
+
+	    /// Returns the number of entries in the table.
+
+	    size_type size() const
+	    {
+		return prob.size();
+	    }
+
+	    /// Builds the table from the argument weights, which need not be
+	    /// normalised. Returns false and leaves the table empty if no weight
+	    /// is positive.
+
+	    bool build(const std::vector<value_type>& weights)
+	    {
+		clear();
+		size_type n=weights.size();
+		value_type norm(0);
+		for(size_type i=0;i<n;++i)
+		{
+		    if(weights[i]>(value_type)0)
+		    {
+			norm+=weights[i];
+		    }
+		}
+		if(!(norm>(value_type)0))
+		{
+		    return false;
+		}
+		prob.resize(n);
+		alias.resize(n);
+		std::vector<size_type>small,large;
+		size_type imax=0;
+		for(size_type i=0;i<n;++i)
+		{
+		    prob[i]=(weights[i]>(value_type)0)?(weights[i]*(value_type)n/norm):(value_type)0;
+		    alias[i]=i;
+		    if(prob[i]>prob[imax])
+		    {
+			imax=i;
+		    }
+		    if(prob[i]<(value_type)1)
+		    {
+			small.push_back(i);
+		    }
+		    else
+		    {
+			large.push_back(i);
+		    }
+		}
+		while(!small.empty() and !large.empty())
+		{
+		    size_type s=small.back();
+		    small.pop_back();
+		    size_type l=large.back();
+		    alias[s]=l;
+		    prob[l]-=((value_type)1-prob[s]);
+		    if(prob[l]<(value_type)1)
+		    {
+			large.pop_back();
+			small.push_back(l);
+		    }
+		}
+		for(size_type i=0;i<large.size();++i)
+		{
+		    prob[large[i]]=(value_type)1;
+		}
+
+		/* Remaining small entries are due to rounding errors: */
+
+		for(size_type i=0;i<small.size();++i)
+		{
+		    if(weights[small[i]]>(value_type)0)
+		    {
+			prob[small[i]]=(value_type)1;
+		    }
+		    else
+		    {
+			prob[small[i]]=(value_type)0;
+			alias[small[i]]=imax;
+		    }
+		}
+		return true;
+	    }
+
+	    /// Returns the index drawn by the argument uniform number in [0,1).
+	    /// The table should not be empty.
+
+	    size_type sample(const value_type& rho) const
+	    {
+		value_type u=rho*(value_type)prob.size();
+		size_type i=(u>(value_type)0)?((size_type)u):0;
+		if(i>=prob.size())
+		{
+		    i=prob.size()-1;
+		}
+		return ((u-(value_type)i)<prob[i])?i:alias[i];
+	    }
+
+	private:
+
+	    /* Acceptance probabilities: */
+
+	    std::vector<value_type>prob;
+
+	    /* Alias indices: */
+
+	    std::vector<size_type>alias;
+    };
+}
+
+#endif /*CAMGEN_ALIAS_TABLE_H_*/
+
@@ -14,12 +14,17 @@
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * ASCII datafile output interface class implementation. Creates a datafile  *
- * where each row represents an event.                                       *
+ * where each row represents an event. In the buffered mode, the rows are    *
+ * formatted into a large character buffer without iostreams, with floating- *
+ * point numbers in the shortest notation that reads back exactly, and the   *
+ * buffer is written to the file when full and when the file is closed.      *
  *                                                                           *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include <fstream>
+#include <map>
 #include <Camgen/if_output.h>
+#include <Camgen/fmt_buffer.h>
 
 namespace Camgen
 {
@@ -46,21 +51,49 @@ namespace Camgen
 
 	    /* Constructor with file name argument */
 
-	    ascii_file(const std::string& file_name_):base_type(file_name_),line(0){}
+	    ascii_file(const std::string& file_name_):base_type(file_name_),line(0),buffer_size(0){}
 
 	    /* Constructor with file name, tree name and tree description arguments: */
 
-	    ascii_file(const std::string& file_name_,const std::string description_):base_type(file_name_,description_),line(0){}
+	    ascii_file(const std::string& file_name_,const std::string description_):base_type(file_name_,description_),line(0),buffer_size(0){}
 
 	    /* Destructor: */
 
-	    ~ascii_file(){}
+	    ~ascii_file()
+	    {
+		close_file();
+	    }
 
 	    /* Creation method implementation: */
 
 	    interface_output<model_t>* create(const std::string& file_name_) const
 	    {
-		return new ascii_file<model_t>(file_name_,this->description);
+		ascii_file<model_t>* result=new ascii_file<model_t>(file_name_,this->description);
+		result->set_buffered(buffer_size);
+		return result;
+	    }
+
+	    /// Switches on buffered output, writing the buffer to the file each
+	    /// time it exceeds the argument number of characters. A zero
+	    /// argument switches back to unbuffered output. Returns false if
+	    /// events were already written.
+
+	    bool set_buffered(std::size_t n=1048576)
+	    {
+		if(line!=0)
+		{
+		    return false;
+		}
+		buffer_size=n;
+		buf.reserve(n+n/8);
+		return true;
+	    }
+
+	    /// Returns whether the output is buffered.
+
+	    bool buffered() const
+	    {
+		return buffer_size!=0;
 	    }
 
 	    /* Opens the (temporary) datafile. */
@@ -82,6 +115,7 @@ namespace Camgen
 	    {
 		if(ofs.is_open())
 		{
+		    buf.write(ofs);
 		    ofs.close();
 		}
 		return !(ofs.is_open());
@@ -156,6 +190,10 @@ namespace Camgen
 		{
 		    return false;
 		}
+		if(buffer_size!=0)
+		{
+		    return write_buffered();
+		}
 		if(line==0)
 		{
 		    ofs<<'#';
@@ -213,10 +251,82 @@ namespace Camgen
 
 	    int line;
 
+	    /* Buffer flushing threshold, zero for unbuffered output: */
+
+	    std::size_t buffer_size;
+
+	    /* Formatting buffer: */
+
+	    format_buffer buf;
+
 	    std::map<std::string,const momentum_type*> vectors;
 	    std::map<std::string,const value_type*> values;
 	    std::map<std::string,const int*> integers;
 	    std::map<std::string,const bool*> booleans;
+
+	    /* Formats the event into the buffer, with the columns separated by
+	     * at least one space: */
+
+	    bool write_buffered()
+	    {
+		if(line==0)
+		{
+		    buf.put('#');
+		    for(vector_iterator it=vectors.begin();it!=vectors.end();++it)
+		    {
+			for(typename momentum_type::size_type i=0;i<model_type::dimension;++i)
+			{
+			    std::stringstream ss;
+			    ss<<it->first<<'['<<i<<']';
+			    buf.put(ss.str(),20);
+			}
+		    }
+		    for(value_iterator it=values.begin();it!=values.end();++it)
+		    {
+			buf.put(it->first,20);
+		    }
+		    for(integer_iterator it=integers.begin();it!=integers.end();++it)
+		    {
+			buf.put(it->first,10);
+		    }
+		    for(boolean_iterator it=booleans.begin();it!=booleans.end();++it)
+		    {
+			buf.put(it->first,10);
+		    }
+		    buf.put('\n');
+		    line=1;
+		}
+		for(vector_iterator it=vectors.begin();it!=vectors.end();++it)
+		{
+		    for(typename momentum_type::size_type i=0;i<model_type::dimension;++i)
+		    {
+			buf.put(' ');
+			buf.put_shortest((double)(*(it->second))[i],19);
+		    }
+		}
+		for(value_iterator it=values.begin();it!=values.end();++it)
+		{
+		    buf.put(' ');
+		    buf.put_shortest((double)*(it->second),19);
+		}
+		for(integer_iterator it=integers.begin();it!=integers.end();++it)
+		{
+		    buf.put(' ');
+		    buf.put_int(*(it->second),9);
+		}
+		for(boolean_iterator it=booleans.begin();it!=booleans.end();++it)
+		{
+		    buf.put(' ');
+		    buf.put_int(*(it->second)?1:0,9);
+		}
+		buf.put('\n');
+		++line;
+		if(buf.size()>=buffer_size)
+		{
+		    return buf.write(ofs);
+		}
+		return true;
+	    }
     };
 }
 
@@ -0,0 +1,198 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+/*! \file async_writer.h
+    \brief Ring buffer handing records to a background output thread.
+ */
+
+#ifndef CAMGEN_ASYNC_WRITER_H_
+#define CAMGEN_ASYNC_WRITER_H_
+
+#include <vector>
+#include <Camgen/mt_utils.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Asynchronous record writer. The producer fills the next free slot of a      *
+ * single-producer single-consumer ring buffer and publishes it by advancing   *
+ * the tail index; a background thread consumes the slots in order, passing    *
+ * them to the consume() method of the sink, and advances the head index. No   *
+ * locks are taken: each index is written by one thread only. The slots are    *
+ * reused, so records holding vectors do not reallocate once sized. If the     *
+ * background thread is not running (or Camgen is built without thread         *
+ * support), published records are consumed immediately by the calling         *
+ * thread.                                                                     *
+ *                                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+namespace Camgen
+{
+    /// Asynchronous record writer class template.
+
+    template<class record_t,class sink_t>class async_writer
+    {
+	public:
+
+	    /* Type definitions: */
+
+	    typedef record_t record_type;
+	    typedef sink_t sink_type;
+	    typedef std::size_t size_type;
+
+	    /// Constructor with the sink and the minimal number of slots, which
+	    /// is rounded up to a power of two.
+
+	    async_writer(sink_type* sink_,size_type capacity=1024):sink(sink_),head(0),tail(0),tail_pos(0),stopping(0),threaded(false)
+	    {
+		size_type n=1;
+		while(n<capacity)
+		{
+		    n*=2;
+		}
+		slots.resize(n);
+		mask=n-1;
+	    }
+
+	    /// Destructor, draining the buffer.
+
+	    ~async_writer()
+	    {
+		stop();
+	    }
+
+	    /// Starts the background thread. Returns false if Camgen is built
+	    /// without thread support.
+
+	    bool start()
+	    {
+		if(!threaded)
+		{
+		    threaded=thread.start(this);
+		}
+		return threaded;
+	    }
+
+	    /// Consumes the remaining records and stops the background thread.
+
+	    void stop()
+	    {
+		if(!threaded)
+		{
+		    return;
+		}
+		store_release(stopping,1);
+		thread.join();
+		threaded=false;
+		store_release(stopping,0);
+	    }
+
+	    /// Returns whether the background thread is running.
+
+	    bool running() const
+	    {
+		return threaded;
+	    }
+
+	    /// Returns the number of slots.
+
+	    size_type capacity() const
+	    {
+		return slots.size();
+	    }
+
+	    /// Returns the next free slot, waiting for the background thread if
+	    /// the buffer is full.
+
+	    record_type& next()
+	    {
+		if(threaded)
+		{
+		    while(tail_pos-load_acquire(head)>mask)
+		    {
+			pause_thread();
+		    }
+		}
+		return slots[tail_pos&mask];
+	    }
+
+	    /// Publishes the slot returned by next().
+
+	    void push()
+	    {
+		if(!threaded)
+		{
+		    sink->consume(slots[tail_pos&mask]);
+		    return;
+		}
+		++tail_pos;
+		store_release(tail,tail_pos);
+	    }
+
+	    /// Background thread loop.
+
+	    void operator()()
+	    {
+		size_type h=load_acquire(head);
+		while(true)
+		{
+		    if(h==load_acquire(tail))
+		    {
+			if(load_acquire(stopping)!=0 and h==load_acquire(tail))
+			{
+			    break;
+			}
+			pause_thread();
+			continue;
+		    }
+		    sink->consume(slots[h&mask]);
+		    ++h;
+		    store_release(head,h);
+		}
+	    }
+
+	private:
+
+	    /* Record consumer: */
+
+	    sink_type* sink;
+
+	    /* Ring buffer slots: */
+
+	    std::vector<record_type>slots;
+
+	    /* Index mask: */
+
+	    size_type mask;
+
+	    /* Consumer and producer positions: */
+
+	    atomic_size_type head,tail;
+
+	    /* Producer position, owned by the producer: */
+
+	    size_type tail_pos;
+
+	    /* Stop request flag: */
+
+	    atomic_size_type stopping;
+
+	    /* Flag denoting whether the background thread runs: */
+
+	    bool threaded;
+
+	    /* Background thread: */
+
+	    background_thread thread;
+
+	    /* Non-copyable: */
+
+	    async_writer(const async_writer<record_t,sink_t>&);
+	    async_writer<record_t,sink_t>& operator = (const async_writer<record_t,sink_t>&);
+    };
+}
+
+#endif /*CAMGEN_ASYNC_WRITER_H_*/
+
@@ -0,0 +1,205 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+/*! \file batch_algo.h
+    \brief Batched amplitude evaluation over several phase space points.
+ */
+
+#ifndef CAMGEN_BATCH_ALGO_H_
+#define CAMGEN_BATCH_ALGO_H_
+
+#include <Camgen/CM_algo.h>
+#include <Camgen/def_args.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Definition of the batch_algorithm class template. A batch algorithm holds a   *
+ * number of lanes, each being an instance-local copy of a CM_algorithm with its *
+ * own phase space and current storage. After filling the phase space of every   *
+ * lane, evaluate() computes the amplitudes of all lanes by traversing the      *
+ * recursion once, evaluating every interaction for all lanes before moving on   *
+ * to the next one. The vertex code, couplings and Feynman rule dispatch of an   *
+ * interaction are thereby reused for the whole batch, rather than being fetched *
+ * anew for every phase space point.                                            *
+ *                                                                               *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+namespace Camgen
+{
+    /// Batched amplitude evaluation class template.
+
+    template<class model_t,std::size_t N_in,std::size_t N_out>class batch_algorithm
+    {
+	public:
+
+	    /* The usual type definitions: */
+
+	    DEFINE_BASIC_TYPES(model_t);
+
+	    /* Algorithm, tree and phase space type definitions: */
+
+	    typedef CM_algorithm<model_t,N_in,N_out> algorithm_type;
+	    typedef typename algorithm_type::tree_type tree_type;
+	    typedef typename algorithm_type::phase_space_type phase_space_type;
+
+	    /// Constructor with the algorithm to be copied and the number of
+	    /// lanes. The lanes are set to the argument's current subprocess.
+
+	    batch_algorithm(const algorithm_type& algo,size_type n):lanes(n,NULL),trees(n,NULL),amplitudes(n,value_type(0,0)),amplitudes2(n,(r_value_type)0)
+	    {
+		for(size_type i=0;i<n;++i)
+		{
+		    lanes[i]=new algorithm_type(algo);
+		}
+		refresh_trees();
+	    }
+
+	    /// Destructor.
+
+	    ~batch_algorithm()
+	    {
+		for(size_type i=0;i<lanes.size();++i)
+		{
+		    delete lanes[i];
+		}
+	    }
+
+	    /// Selects the subprocess in all lanes (see
+	    /// CM_algorithm::set_process). Returns false if the process was not
+	    /// found.
+
+	    bool set_process(const std::string& proc)
+	    {
+		bool q=true;
+		for(size_type i=0;i<lanes.size();++i)
+		{
+		    lanes[i]->set_process(proc);
+		    q&=lanes[i]->valid_process();
+		}
+		refresh_trees();
+		return q;
+	    }
+
+	    /// Resets all lanes to the first subprocess.
+
+	    bool reset_process()
+	    {
+		bool q=true;
+		for(size_type i=0;i<lanes.size();++i)
+		{
+		    q&=lanes[i]->reset_process();
+		}
+		refresh_trees();
+		return q;
+	    }
+
+	    /// Moves all lanes to the next subprocess. Returns false if the end
+	    /// of the process list was reached.
+
+	    bool next_process()
+	    {
+		bool q=true;
+		for(size_type i=0;i<lanes.size();++i)
+		{
+		    q&=lanes[i]->next_process();
+		}
+		refresh_trees();
+		return q;
+	    }
+
+	    /// Returns the number of lanes.
+
+	    size_type size() const
+	    {
+		return lanes.size();
+	    }
+
+	    /// Returns the n-th lane algorithm.
+
+	    algorithm_type& lane(size_type n)
+	    {
+		return *(lanes[n]);
+	    }
+
+	    /// Returns the n-th lane algorithm.
+
+	    const algorithm_type& lane(size_type n) const
+	    {
+		return *(lanes[n]);
+	    }
+
+	    /// Returns the phase space of the i-th external particle in the
+	    /// n-th lane.
+
+	    phase_space_type* get_phase_space(size_type n,size_type i)
+	    {
+		return lanes[n]->get_phase_space(i);
+	    }
+
+	    /// Evaluates the current subprocess amplitudes of all lanes.
+
+	    const std::vector<value_type>& evaluate()
+	    {
+		if(trees.size()!=0 and trees[0]!=NULL)
+		{
+		    tree_type::evaluate_batch(trees,amplitudes);
+		}
+		else
+		{
+		    amplitudes.assign(lanes.size(),value_type(0,0));
+		}
+		return amplitudes;
+	    }
+
+	    /// Evaluates the current subprocess squared amplitudes of all lanes.
+
+	    const std::vector<r_value_type>& evaluate2()
+	    {
+		evaluate();
+		for(size_type i=0;i<amplitudes.size();++i)
+		{
+		    amplitudes2[i]=std::norm(amplitudes[i]);
+		}
+		return amplitudes2;
+	    }
+
+	private:
+
+	    /* Instance-local algorithm copies: */
+
+	    std::vector<algorithm_type*>lanes;
+
+	    /* Current process trees of the lanes: */
+
+	    std::vector<tree_type*>trees;
+
+	    /* Output amplitudes: */
+
+	    std::vector<value_type>amplitudes;
+	    std::vector<r_value_type>amplitudes2;
+
+	    /* Collects the current process trees of the lanes. If any lane
+	     * has no valid process, the batch evaluates to zero: */
+
+	    void refresh_trees()
+	    {
+		for(size_type i=0;i<lanes.size();++i)
+		{
+		    if(!lanes[i]->valid_process())
+		    {
+			trees.assign(lanes.size(),NULL);
+			return;
+		    }
+		    trees[i]=&(*(lanes[i]->get_tree_iterator()));
+		}
+	    }
+    };
+}
+
+#include <Camgen/undef_args.h>
+
+#endif /*CAMGEN_BATCH_ALGO_H_*/
+
@@ -0,0 +1,940 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+/*! \file bin_if.h
+    \brief Binary interface output and event file reader.
+ */
+
+#ifndef CAMGEN_BIN_IF_H_
+#define CAMGEN_BIN_IF_H_
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Binary event file output interface and reader. Each event consists of a     *
+ * fixed-size record with the process id, weight, factorisation scale, strong  *
+ * coupling, particle ids, colour lines and momenta, followed by the variables *
+ * added as branches. The events are stored in blocks of fixed capacity, in    *
+ * which every column is contiguous and padded to 8 bytes. The file starts     *
+ * with a 16-byte header and ends with a footer describing the columns and the *
+ * block offsets, followed by the footer position and the magic string. All    *
+ * numbers are written in little-endian byte order. The reader maps the file   *
+ * into memory, so that on little-endian hosts the columns can be accessed     *
+ * without copying, and provides random access to the events. It can write a   *
+ * copy of the file extended with additional weight columns.                   *
+ *                                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <fstream>
+#include <Camgen/if_output.h>
+#include <Camgen/bin_io.h>
+
+namespace Camgen
+{
+    /// Column data types of binary event files.
+
+    struct binary_columns
+    {
+	enum type
+	{
+	    int32,
+	    float32,
+	    float64,
+	    uint8
+	};
+
+	/// Returns the size in bytes of the column data type.
+
+	static std::size_t size(unsigned t)
+	{
+	    switch(t)
+	    {
+		case int32:
+		    return 4;
+		case float32:
+		    return 4;
+		case float64:
+		    return 8;
+		case uint8:
+		    return 1;
+	    }
+	    return 0;
+	}
+
+	/// Returns the column data type of floating-point numbers of type T.
+
+	template<class T>static type floating_point()
+	{
+	    return (sizeof(T)==4)?float32:float64;
+	}
+
+	/// Magic string opening and closing binary event files.
+
+	static const char* magic()
+	{
+	    return "CAMGENEV";
+	}
+
+	/// File format version.
+
+	static const unsigned version=1;
+    };
+
+    /// Binary event file output interface class. The template parameter
+    /// storage_t determines whether momenta are stored in single or double
+    /// precision.
+
+    template<class model_t,class storage_t=double>class binary_file: public interface_output<model_t>
+    {
+	typedef interface_output<model_t> base_type;
+
+	public:
+
+	    /* Type definitions: */
+
+	    typedef model_t model_type;
+	    typedef typename base_type::value_type value_type;
+	    typedef typename base_type::momentum_type momentum_type;
+	    typedef std::size_t size_type;
+
+	    /// Constructor with file name and block capacity arguments.
+
+	    binary_file(const std::string& file_name_,size_type block_capacity_=4096):base_type(file_name_),block_capacity(block_capacity_==0?1:block_capacity_),n_in(0),n_out(0),n_events(0),block_fill(0)
+	    {
+		init_columns();
+	    }
+
+	    /// Constructor with file name, description and block capacity
+	    /// arguments.
+
+	    binary_file(const std::string& file_name_,const std::string description_,size_type block_capacity_=4096):base_type(file_name_,description_),block_capacity(block_capacity_==0?1:block_capacity_),n_in(0),n_out(0),n_events(0),block_fill(0)
+	    {
+		init_columns();
+	    }
+
+	    /// Destructor.
+
+	    ~binary_file()
+	    {
+		close_file();
+	    }
+
+	    /* Creation method implementation: */
+
+	    interface_output<model_t>* create(const std::string& file_name_) const
+	    {
+		return new binary_file<model_t,storage_t>(file_name_,this->description,block_capacity);
+	    }
+
+	    /* Opens the datafile and writes the header: */
+
+	    bool open_file()
+	    {
+		if(ofs.is_open())
+		{
+		    return true;
+		}
+		std::string fname=this->file_name+".bin";
+		ofs.open(fname.c_str(),std::ios::out|std::ios::binary);
+		if(!ofs.is_open())
+		{
+		    return false;
+		}
+		ofs.write(binary_columns::magic(),8);
+		write_value(ofs,(unsigned)binary_columns::version);
+		write_value(ofs,(unsigned)0x01020304);
+		return ofs.good();
+	    }
+
+	    /* Writes the last block and the footer and closes the datafile: */
+
+	    bool close_file()
+	    {
+		if(!ofs.is_open())
+		{
+		    return true;
+		}
+		write_block();
+		long long unsigned footer=(std::streamoff)ofs.tellp();
+		write_value(ofs,(unsigned)n_in);
+		write_value(ofs,(unsigned)n_out);
+		write_value(ofs,(unsigned)block_capacity);
+		write_value(ofs,(long long unsigned)n_events);
+		write_value(ofs,(unsigned)columns.size());
+		for(size_type i=0;i<columns.size();++i)
+		{
+		    write_value(ofs,(unsigned)columns[i].name.size());
+		    ofs.write(columns[i].name.data(),columns[i].name.size());
+		    write_value(ofs,columns[i].type);
+		    write_value(ofs,columns[i].width);
+		}
+		write_value(ofs,(unsigned)block_offsets.size());
+		for(size_type i=0;i<block_offsets.size();++i)
+		{
+		    write_value(ofs,block_offsets[i]);
+		}
+		write_value(ofs,footer);
+		ofs.write(binary_columns::magic(),8);
+		ofs.close();
+		return !(ofs.is_open());
+	    }
+
+	    /* Adds a branch holding a Lorentz vector: */
+
+	    bool branch(const momentum_type* p,const std::string& varname)
+	    {
+		return add_column(varname,binary_columns::floating_point<storage_t>(),model_t::dimension,source_momentum,p);
+	    }
+
+	    /* Adds a branch holding a floating-point number: */
+
+	    bool branch(const value_type* x,const std::string& varname)
+	    {
+		return add_column(varname,binary_columns::float64,1,source_value,x);
+	    }
+
+	    /* Adds a branch holding an integer: */
+
+	    bool branch(const int* n,const std::string& varname)
+	    {
+		return add_column(varname,binary_columns::int32,1,source_integer,n);
+	    }
+
+	    /* Adds a branch holding a boolean: */
+
+	    bool branch(const bool* b,const std::string& varname)
+	    {
+		return add_column(varname,binary_columns::uint8,1,source_boolean,b);
+	    }
+
+	    /* The event record requires the generator: */
+
+	    bool write_event()
+	    {
+		return false;
+	    }
+
+	    /* Appends the event to the current block, which is written to disk
+	     * when full: */
+
+	    bool write_event(const ps_generator_base<model_t>* gen)
+	    {
+		if(!ofs.is_open() or gen==NULL)
+		{
+		    return false;
+		}
+		size_type npart=gen->n_in()+gen->n_out();
+		if(n_events==0)
+		{
+		    n_in=gen->n_in();
+		    n_out=gen->n_out();
+		    columns[id_column].width=npart;
+		    columns[c_column].width=npart;
+		    columns[cbar_column].width=npart;
+		    columns[p_column].width=model_t::dimension*npart;
+		    for(size_type i=0;i<columns.size();++i)
+		    {
+			columns[i].data.reserve(block_capacity*columns[i].width*binary_columns::size(columns[i].type));
+		    }
+		}
+		else if(gen->n_in()!=n_in or gen->n_out()!=n_out)
+		{
+		    return false;
+		}
+		gen->fill_colours(c,cbar);
+		c.resize(npart,0);
+		cbar.resize(npart,0);
+		for(size_type i=0;i<columns.size();++i)
+		{
+		    column& col=columns[i];
+		    switch(col.source)
+		    {
+			case source_process:
+			    append(col,(int)gen->process_id());
+			    break;
+			case source_weight:
+			    append(col,(double)gen->w());
+			    break;
+			case source_scale:
+			    append(col,(double)gen->mu_F());
+			    break;
+			case source_alpha_s:
+			    append(col,(double)model_t::alpha_s);
+			    break;
+			case source_ids:
+			    for(size_type k=0;k<npart;++k)
+			    {
+				append(col,(int)((k<n_in)?gen->id_in(k):gen->id_out(k-n_in)));
+			    }
+			    break;
+			case source_colours:
+			    for(size_type k=0;k<npart;++k)
+			    {
+				append(col,(int)c[k]);
+			    }
+			    break;
+			case source_anticolours:
+			    for(size_type k=0;k<npart;++k)
+			    {
+				append(col,(int)cbar[k]);
+			    }
+			    break;
+			case source_momenta:
+			    for(size_type k=0;k<npart;++k)
+			    {
+				const momentum_type& q=(k<n_in)?gen->p_in(k):gen->p_out(k-n_in);
+				for(size_type mu=0;mu<model_t::dimension;++mu)
+				{
+				    append(col,(storage_t)q[mu]);
+				}
+			    }
+			    break;
+			case source_momentum:
+			    for(size_type mu=0;mu<model_t::dimension;++mu)
+			    {
+				append(col,(storage_t)(*static_cast<const momentum_type*>(col.address))[mu]);
+			    }
+			    break;
+			case source_value:
+			    append(col,(double)(*static_cast<const value_type*>(col.address)));
+			    break;
+			case source_integer:
+			    append(col,(int)(*static_cast<const int*>(col.address)));
+			    break;
+			case source_boolean:
+			    append(col,(unsigned char)(*static_cast<const bool*>(col.address)?1:0));
+			    break;
+		    }
+		}
+		++n_events;
+		if(++block_fill==block_capacity)
+		{
+		    write_block();
+		}
+		return true;
+	    }
+
+	private:
+
+	    /* Column value sources: */
+
+	    enum source_type
+	    {
+		source_process,
+		source_weight,
+		source_scale,
+		source_alpha_s,
+		source_ids,
+		source_colours,
+		source_anticolours,
+		source_momenta,
+		source_momentum,
+		source_value,
+		source_integer,
+		source_boolean
+	    };
+
+	    /* Column name, data type, number of values per event, value source
+	     * and data of the current block: */
+
+	    struct column
+	    {
+		std::string name;
+		unsigned type;
+		unsigned width;
+		source_type source;
+		const void* address;
+		std::vector<char>data;
+	    };
+
+	    /* Positions of the columns filled with the particle content: */
+
+	    static const size_type id_column=4;
+	    static const size_type c_column=5;
+	    static const size_type cbar_column=6;
+	    static const size_type p_column=7;
+
+	    /* Maximal number of events per block: */
+
+	    const size_type block_capacity;
+
+	    /* Output file stream: */
+
+	    std::ofstream ofs;
+
+	    /* Numbers of incoming and outgoing particles: */
+
+	    size_type n_in,n_out;
+
+	    /* Number of written events and number of events in the current
+	     * block: */
+
+	    size_type n_events,block_fill;
+
+	    /* Columns: */
+
+	    std::vector<column>columns;
+
+	    /* File positions of the written blocks: */
+
+	    std::vector<long long unsigned>block_offsets;
+
+	    /* Colour line buffers: */
+
+	    std::vector<int>c,cbar;
+
+	    /* Writes a value in little-endian byte order: */
+
+	    template<class T>static void write_value(std::ostream& os,T x)
+	    {
+		write_binary(os,little_endian(x));
+	    }
+
+	    /* Appends a value to the column data: */
+
+	    template<class T>static void append(column& col,T x)
+	    {
+		x=little_endian(x);
+		const char* p=reinterpret_cast<const char*>(&x);
+		col.data.insert(col.data.end(),p,p+sizeof(T));
+	    }
+
+	    /* Inserts the event record columns: */
+
+	    void init_columns()
+	    {
+		add_column("proc_id",binary_columns::int32,1,source_process,NULL);
+		add_column("weight",binary_columns::float64,1,source_weight,NULL);
+		add_column("mu_F",binary_columns::float64,1,source_scale,NULL);
+		add_column("alpha_s",binary_columns::float64,1,source_alpha_s,NULL);
+		add_column("id",binary_columns::int32,0,source_ids,NULL);
+		add_column("c",binary_columns::int32,0,source_colours,NULL);
+		add_column("cbar",binary_columns::int32,0,source_anticolours,NULL);
+		add_column("p",binary_columns::floating_point<storage_t>(),0,source_momenta,NULL);
+	    }
+
+	    /* Adds a column, replacing the source of an existing column with
+	     * the same name. The particle content columns cannot be replaced:
+	     * */
+
+	    bool add_column(const std::string& name,binary_columns::type type,unsigned width,source_type source,const void* address)
+	    {
+		if(n_events!=0)
+		{
+		    return false;
+		}
+		for(size_type i=0;i<columns.size();++i)
+		{
+		    if(columns[i].name==name)
+		    {
+			if(i>=id_column and i<=p_column)
+			{
+			    return false;
+			}
+			columns[i].type=type;
+			columns[i].width=width;
+			columns[i].source=source;
+			columns[i].address=address;
+			return true;
+		    }
+		}
+		column col;
+		col.name=name;
+		col.type=type;
+		col.width=width;
+		col.source=source;
+		col.address=address;
+		columns.push_back(col);
+		return true;
+	    }
+
+	    /* Writes the current block to disk, padding the columns to 8
+	     * bytes: */
+
+	    void write_block()
+	    {
+		if(block_fill==0)
+		{
+		    return;
+		}
+		block_offsets.push_back((std::streamoff)ofs.tellp());
+		static const char padding[8]={0,0,0,0,0,0,0,0};
+		for(size_type i=0;i<columns.size();++i)
+		{
+		    std::vector<char>& data=columns[i].data;
+		    if(!data.empty())
+		    {
+			ofs.write(&data[0],data.size());
+		    }
+		    ofs.write(padding,(8-data.size()%8)%8);
+		    data.clear();
+		}
+		block_fill=0;
+	    }
+    };
+
+    /// Binary event file reader. The file is mapped into memory, and the
+    /// column data of each block can be accessed directly on little-endian
+    /// hosts.
+
+    class binary_file_reader
+    {
+	public:
+
+	    /* Type definitions: */
+
+	    typedef std::size_t size_type;
+
+	    /// Constructor.
+
+	    binary_file_reader():n_in(0),n_out(0),block_capacity(0),n_events(0),proc_col(-1),w_col(-1),mu_col(-1),as_col(-1),id_col(-1),c_col(-1),cbar_col(-1),p_col(-1){}
+
+	    /// Constructor opening the argument file.
+
+	    binary_file_reader(const std::string& filename):n_in(0),n_out(0),block_capacity(0),n_events(0),proc_col(-1),w_col(-1),mu_col(-1),as_col(-1),id_col(-1),c_col(-1),cbar_col(-1),p_col(-1)
+	    {
+		open(filename);
+	    }
+
+	    /// Maps the argument file and reads the footer. Returns false if
+	    /// the file could not be opened or is not a valid event file.
+
+	    bool open(const std::string& filename)
+	    {
+		close();
+		if(!file.open(filename))
+		{
+		    return false;
+		}
+		if(!read_footer())
+		{
+		    close();
+		    return false;
+		}
+		return true;
+	    }
+
+	    /// Unmaps the file.
+
+	    void close()
+	    {
+		file.close();
+		n_in=n_out=block_capacity=n_events=0;
+		column_names.clear();
+		column_types.clear();
+		column_widths.clear();
+		block_offsets.clear();
+		column_offsets.clear();
+		proc_col=w_col=mu_col=as_col=id_col=c_col=cbar_col=p_col=-1;
+	    }
+
+	    /// Returns whether a valid file is mapped.
+
+	    bool is_open() const
+	    {
+		return file.is_open();
+	    }
+
+	    /// Returns the number of events.
+
+	    size_type events() const
+	    {
+		return n_events;
+	    }
+
+	    /// Returns the number of incoming particles.
+
+	    size_type n_incoming() const
+	    {
+		return n_in;
+	    }
+
+	    /// Returns the number of outgoing particles.
+
+	    size_type n_outgoing() const
+	    {
+		return n_out;
+	    }
+
+	    /// Returns the number of columns.
+
+	    size_type columns() const
+	    {
+		return column_names.size();
+	    }
+
+	    /// Returns the name of the c-th column.
+
+	    const std::string& column_name(size_type c) const
+	    {
+		return column_names[c];
+	    }
+
+	    /// Returns the data type of the c-th column.
+
+	    binary_columns::type column_type(size_type c) const
+	    {
+		return (binary_columns::type)column_types[c];
+	    }
+
+	    /// Returns the number of values per event of the c-th column.
+
+	    size_type column_width(size_type c) const
+	    {
+		return column_widths[c];
+	    }
+
+	    /// Returns the index of the column with the argument name, or -1 if
+	    /// it does not exist.
+
+	    int find_column(const std::string& name) const
+	    {
+		for(size_type c=0;c<column_names.size();++c)
+		{
+		    if(column_names[c]==name)
+		    {
+			return c;
+		    }
+		}
+		return -1;
+	    }
+
+	    /// Returns the number of blocks.
+
+	    size_type blocks() const
+	    {
+		return block_offsets.size();
+	    }
+
+	    /// Returns the number of events in the b-th block.
+
+	    size_type block_events(size_type b) const
+	    {
+		return (b+1<block_offsets.size())?block_capacity:(n_events-b*block_capacity);
+	    }
+
+	    /// Returns the raw data of the c-th column in the b-th block.
+
+	    const char* column_data(size_type c,size_type b) const
+	    {
+		return file.data()+column_offsets[b*column_names.size()+c];
+	    }
+
+	    /// Returns the data of the c-th column in the b-th block, with
+	    /// width*block_events(b) values, or NULL if the type T does not
+	    /// match the column or the host is not little-endian.
+
+	    template<class T>const T* column(size_type c,size_type b) const
+	    {
+		if(!little_endian_host() or sizeof(T)!=binary_columns::size(column_types[c]))
+		{
+		    return NULL;
+		}
+		return reinterpret_cast<const T*>(column_data(c,b));
+	    }
+
+	    /// Returns the k-th value of the c-th column for event i, converted
+	    /// to type T.
+
+	    template<class T>T value(size_type c,size_type i,size_type k=0) const
+	    {
+		size_type b=i/block_capacity;
+		const char* p=column_data(c,b)+((i-b*block_capacity)*column_widths[c]+k)*binary_columns::size(column_types[c]);
+		switch(column_types[c])
+		{
+		    case binary_columns::int32:
+			return (T)load<int>(p);
+		    case binary_columns::float32:
+			return (T)load<float>(p);
+		    case binary_columns::float64:
+			return (T)load<double>(p);
+		    case binary_columns::uint8:
+			return (T)load<unsigned char>(p);
+		}
+		return T(0);
+	    }
+
+	    /// Returns the process id of event i.
+
+	    int process_id(size_type i) const
+	    {
+		return value<int>(proc_col,i);
+	    }
+
+	    /// Returns the weight of event i.
+
+	    double weight(size_type i) const
+	    {
+		return value<double>(w_col,i);
+	    }
+
+	    /// Returns the factorisation scale of event i.
+
+	    double mu_F(size_type i) const
+	    {
+		return value<double>(mu_col,i);
+	    }
+
+	    /// Returns the strong coupling of event i.
+
+	    double alpha_s(size_type i) const
+	    {
+		return value<double>(as_col,i);
+	    }
+
+	    /// Returns the id of the k-th particle in event i, where the
+	    /// incoming particles precede the outgoing ones.
+
+	    int id(size_type i,size_type k) const
+	    {
+		return value<int>(id_col,i,k);
+	    }
+
+	    /// Returns the colour line of the k-th particle in event i.
+
+	    int c(size_type i,size_type k) const
+	    {
+		return value<int>(c_col,i,k);
+	    }
+
+	    /// Returns the anticolour line of the k-th particle in event i.
+
+	    int cbar(size_type i,size_type k) const
+	    {
+		return value<int>(cbar_col,i,k);
+	    }
+
+	    /// Returns the mu-th component of the k-th momentum in event i.
+
+	    double p(size_type i,size_type k,size_type mu) const
+	    {
+		return value<double>(p_col,i,k*(column_widths[p_col]/(n_in+n_out))+mu);
+	    }
+
+	    /// Writes a copy of the event file with additional double-precision
+	    /// weight columns, where the j-th column has the name names[j] and
+	    /// the values weights[j], one per event. Returns false if the
+	    /// argument sizes do not match or the file could not be written.
+
+	    bool write_weights(const std::string& filename,const std::vector<std::string>& names,const std::vector< std::vector<double> >& weights) const
+	    {
+		if(!is_open() or names.size()!=weights.size())
+		{
+		    return false;
+		}
+		for(size_type j=0;j<weights.size();++j)
+		{
+		    if(weights[j].size()!=n_events)
+		    {
+			return false;
+		    }
+		}
+		std::ofstream ofs(filename.c_str(),std::ios::out|std::ios::binary);
+		if(!ofs.is_open())
+		{
+		    return false;
+		}
+		ofs.write(file.data(),16);
+		std::vector<long long unsigned>offsets;
+		std::vector<char>data;
+		static const char padding[8]={0,0,0,0,0,0,0,0};
+		for(size_type b=0;b<blocks();++b)
+		{
+		    offsets.push_back((std::streamoff)ofs.tellp());
+		    size_type n=block_events(b);
+		    for(size_type c=0;c<columns();++c)
+		    {
+			size_type bytes=n*column_widths[c]*binary_columns::size(column_types[c]);
+			ofs.write(column_data(c,b),bytes+(8-bytes%8)%8);
+		    }
+		    for(size_type j=0;j<weights.size();++j)
+		    {
+			data.clear();
+			for(size_type i=b*block_capacity;i<b*block_capacity+n;++i)
+			{
+			    double x=little_endian(weights[j][i]);
+			    const char* p=reinterpret_cast<const char*>(&x);
+			    data.insert(data.end(),p,p+sizeof(double));
+			}
+			if(!data.empty())
+			{
+			    ofs.write(&data[0],data.size());
+			}
+			ofs.write(padding,(8-data.size()%8)%8);
+		    }
+		}
+		long long unsigned footer=(std::streamoff)ofs.tellp();
+		write_value(ofs,(unsigned)n_in);
+		write_value(ofs,(unsigned)n_out);
+		write_value(ofs,(unsigned)block_capacity);
+		write_value(ofs,(long long unsigned)n_events);
+		write_value(ofs,(unsigned)(columns()+names.size()));
+		for(size_type c=0;c<columns()+names.size();++c)
+		{
+		    const std::string& name=(c<columns())?column_names[c]:names[c-columns()];
+		    write_value(ofs,(unsigned)name.size());
+		    ofs.write(name.data(),name.size());
+		    write_value(ofs,(c<columns())?column_types[c]:(unsigned)binary_columns::float64);
+		    write_value(ofs,(c<columns())?column_widths[c]:1u);
+		}
+		write_value(ofs,(unsigned)offsets.size());
+		for(size_type b=0;b<offsets.size();++b)
+		{
+		    write_value(ofs,offsets[b]);
+		}
+		write_value(ofs,footer);
+		ofs.write(binary_columns::magic(),8);
+		ofs.close();
+		return !ofs.fail();
+	    }
+
+	private:
+
+	    /* Mapped file: */
+
+	    mapped_file file;
+
+	    /* Numbers of particles, block capacity and number of events: */
+
+	    size_type n_in,n_out,block_capacity,n_events;
+
+	    /* Column names, types and widths: */
+
+	    std::vector<std::string>column_names;
+	    std::vector<unsigned>column_types,column_widths;
+
+	    /* Block positions and column positions per block: */
+
+	    std::vector<long long unsigned>block_offsets;
+	    std::vector<size_type>column_offsets;
+
+	    /* Indices of the event record columns: */
+
+	    int proc_col,w_col,mu_col,as_col,id_col,c_col,cbar_col,p_col;
+
+	    /* Reads a little-endian value: */
+
+	    template<class T>static T load(const char* p)
+	    {
+		T x;
+		std::memcpy(&x,p,sizeof(T));
+		return little_endian(x);
+	    }
+
+	    /* Writes a value in little-endian byte order: */
+
+	    template<class T>static void write_value(std::ostream& os,T x)
+	    {
+		write_binary(os,little_endian(x));
+	    }
+
+	    /* Reads a little-endian value from the reader: */
+
+	    template<class T>static bool read_value(binary_reader& r,T& x)
+	    {
+		if(!r.read(x))
+		{
+		    return false;
+		}
+		x=little_endian(x);
+		return true;
+	    }
+
+	    /* Checks the header and trailer, reads the footer and computes the
+	     * column positions: */
+
+	    bool read_footer()
+	    {
+		const char* magic=binary_columns::magic();
+		if(file.size()<32 or std::memcmp(file.data(),magic,8)!=0 or std::memcmp(file.data()+file.size()-8,magic,8)!=0)
+		{
+		    return false;
+		}
+		binary_reader header(file.data()+8,file.data()+16);
+		unsigned version,order;
+		if(!read_value(header,version) or !read_value(header,order) or version!=binary_columns::version or order!=0x01020304)
+		{
+		    return false;
+		}
+		long long unsigned footer=load<long long unsigned>(file.data()+file.size()-16);
+		if(footer<16 or footer>file.size()-16)
+		{
+		    return false;
+		}
+		binary_reader r(file.data()+footer,file.data()+file.size()-16);
+		unsigned nin,nout,capacity,ncols,nblocks;
+		long long unsigned nevts;
+		if(!read_value(r,nin) or !read_value(r,nout) or !read_value(r,capacity) or !read_value(r,nevts) or !read_value(r,ncols))
+		{
+		    return false;
+		}
+		n_in=nin;
+		n_out=nout;
+		block_capacity=capacity;
+		n_events=nevts;
+		for(unsigned c=0;c<ncols;++c)
+		{
+		    unsigned n,type,width;
+		    if(!read_value(r,n) or !r.skip(n))
+		    {
+			return false;
+		    }
+		    column_names.push_back(std::string(r.position()-n,n));
+		    if(!read_value(r,type) or !read_value(r,width) or binary_columns::size(type)==0)
+		    {
+			return false;
+		    }
+		    column_types.push_back(type);
+		    column_widths.push_back(width);
+		}
+		if(!read_value(r,nblocks) or block_capacity==0 or nblocks!=(n_events+block_capacity-1)/block_capacity)
+		{
+		    return false;
+		}
+		for(unsigned b=0;b<nblocks;++b)
+		{
+		    long long unsigned offset;
+		    if(!read_value(r,offset))
+		    {
+			return false;
+		    }
+		    block_offsets.push_back(offset);
+		    size_type pos=offset;
+		    size_type n=(b+1<nblocks)?block_capacity:(n_events-b*block_capacity);
+		    for(unsigned c=0;c<ncols;++c)
+		    {
+			column_offsets.push_back(pos);
+			size_type bytes=n*column_widths[c]*binary_columns::size(column_types[c]);
+			pos+=bytes+(8-bytes%8)%8;
+		    }
+		    if(pos>footer)
+		    {
+			return false;
+		    }
+		}
+		if(!r.at_end())
+		{
+		    return false;
+		}
+		proc_col=find_column("proc_id");
+		w_col=find_column("weight");
+		mu_col=find_column("mu_F");
+		as_col=find_column("alpha_s");
+		id_col=find_column("id");
+		c_col=find_column("c");
+		cbar_col=find_column("cbar");
+		p_col=find_column("p");
+		return proc_col>=0 and w_col>=0 and mu_col>=0 and as_col>=0 and id_col>=0 and c_col>=0 and cbar_col>=0 and p_col>=0;
+	    }
+
+	    /* Non-copyable: */
+
+	    binary_file_reader(const binary_file_reader&);
+	    binary_file_reader& operator = (const binary_file_reader&);
+    };
+}
+
+#endif /*CAMGEN_BIN_IF_H_*/
+
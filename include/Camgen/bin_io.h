@@ -0,0 +1,369 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+/*! \file bin_io.h
+    \brief Binary file input and output utilities.
+ */
+
+#ifndef CAMGEN_BIN_IO_H_
+#define CAMGEN_BIN_IO_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Utilities for Camgen's binary data files. Values are written in the native    *
+ * byte order and layout, so the files are meant to be read back on the same     *
+ * architecture; portable formats can convert values to little-endian order      *
+ * with the little_endian() function. On POSIX systems the files are read        *
+ * through a read-only memory mapping, so that only the pages actually           *
+ * inspected are loaded; otherwise the file is read into a buffer, with an       *
+ * identical interface.                                                          *
+ *                                                                               *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CAMGEN_HAVE_MMAP 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace Camgen
+{
+    /// Writes the binary representation of the argument to the output
+    /// stream.
+
+    template<class T>std::ostream& write_binary(std::ostream& os,const T& x)
+    {
+	return os.write(reinterpret_cast<const char*>(&x),sizeof(T));
+    }
+
+    /// Writes the string length and characters to the output stream.
+
+    inline std::ostream& write_binary(std::ostream& os,const std::string& s)
+    {
+	write_binary(os,(unsigned)s.size());
+	return os.write(s.data(),s.size());
+    }
+
+    /// Returns whether the host stores numbers in little-endian byte order.
+
+    inline bool little_endian_host()
+    {
+	const unsigned n=1;
+	return *reinterpret_cast<const unsigned char*>(&n)==1;
+    }
+
+    /// Converts the argument between the host and little-endian byte order.
+
+    template<class T>T little_endian(T x)
+    {
+	if(!little_endian_host())
+	{
+	    char* p=reinterpret_cast<char*>(&x);
+	    std::reverse(p,p+sizeof(T));
+	}
+	return x;
+    }
+
+    /// 64-bit FNV-1a hash accumulator, used to key binary data files to the
+    /// input they were derived from.
+
+    class binary_hash
+    {
+	public:
+
+	    /// Constructor.
+
+	    binary_hash():h(14695981039346656037ULL){}
+
+	    /// Adds the bytes of the argument to the hash.
+
+	    template<class T>binary_hash& add(const T& x)
+	    {
+		return add_bytes(reinterpret_cast<const char*>(&x),sizeof(T));
+	    }
+
+	    /// Adds the characters of the argument string to the hash.
+
+	    binary_hash& add(const std::string& s)
+	    {
+		add((unsigned)s.size());
+		return add_bytes(s.data(),s.size());
+	    }
+
+	    /// Returns the hash value.
+
+	    long long unsigned value() const
+	    {
+		return h;
+	    }
+
+	private:
+
+	    /* Hash value: */
+
+	    long long unsigned h;
+
+	    /* Byte-wise update: */
+
+	    binary_hash& add_bytes(const char* p,std::size_t n)
+	    {
+		for(std::size_t i=0;i<n;++i)
+		{
+		    h^=(long long unsigned)(unsigned char)p[i];
+		    h*=1099511628211ULL;
+		}
+		return *this;
+	    }
+    };
+
+    /// Read-only file mapped into memory.
+
+    class mapped_file
+    {
+	public:
+
+	    /// Constructor.
+
+	    mapped_file():first(NULL),length(0),opened(false)
+#ifdef CAMGEN_HAVE_MMAP
+	    ,mapping(NULL)
+#endif
+	    {}
+
+	    /// Constructor opening the argument file.
+
+	    mapped_file(const std::string& filename):first(NULL),length(0),opened(false)
+#ifdef CAMGEN_HAVE_MMAP
+	    ,mapping(NULL)
+#endif
+	    {
+		open(filename);
+	    }
+
+	    /// Destructor.
+
+	    ~mapped_file()
+	    {
+		close();
+	    }
+
+	    /// Maps the argument file, returns false if it could not be
+	    /// opened.
+
+	    bool open(const std::string& filename)
+	    {
+		close();
+#ifdef CAMGEN_HAVE_MMAP
+		int fd=::open(filename.c_str(),O_RDONLY);
+		if(fd<0)
+		{
+		    return false;
+		}
+		struct stat st;
+		if(::fstat(fd,&st)!=0)
+		{
+		    ::close(fd);
+		    return false;
+		}
+		length=st.st_size;
+		if(length!=0)
+		{
+		    void* p=::mmap(NULL,length,PROT_READ,MAP_PRIVATE,fd,0);
+		    if(p==MAP_FAILED)
+		    {
+			::close(fd);
+			length=0;
+			return false;
+		    }
+		    mapping=p;
+		    first=static_cast<const char*>(p);
+		}
+		::close(fd);
+		opened=true;
+		return true;
+#else
+		std::ifstream ifs(filename.c_str(),std::ios::in|std::ios::binary);
+		if(!ifs.is_open())
+		{
+		    return false;
+		}
+		buffer.assign(std::istreambuf_iterator<char>(ifs),std::istreambuf_iterator<char>());
+		length=buffer.size();
+		first=buffer.empty()?NULL:&buffer[0];
+		opened=true;
+		return true;
+#endif
+	    }
+
+	    /// Unmaps the file.
+
+	    void close()
+	    {
+#ifdef CAMGEN_HAVE_MMAP
+		if(mapping!=NULL)
+		{
+		    ::munmap(mapping,length);
+		    mapping=NULL;
+		}
+#else
+		buffer.clear();
+#endif
+		first=NULL;
+		length=0;
+		opened=false;
+	    }
+
+	    /// Returns whether a file is mapped.
+
+	    bool is_open() const
+	    {
+		return opened;
+	    }
+
+	    /// Returns the beginning of the file contents.
+
+	    const char* data() const
+	    {
+		return first;
+	    }
+
+	    /// Returns the file size in bytes.
+
+	    std::size_t size() const
+	    {
+		return length;
+	    }
+
+	private:
+
+	    /* File contents and size: */
+
+	    const char* first;
+	    std::size_t length;
+
+	    /* Open-file flag: */
+
+	    bool opened;
+
+#ifdef CAMGEN_HAVE_MMAP
+	    /* Mapped memory region: */
+
+	    void* mapping;
+#else
+	    /* Buffer holding the file contents: */
+
+	    std::vector<char>buffer;
+#endif
+	    /* Non-copyable: */
+
+	    mapped_file(const mapped_file&);
+	    mapped_file& operator = (const mapped_file&);
+    };
+
+    /// Bounds-checked sequential reader of binary data in memory. Once a
+    /// read exceeds the data, the reader fails and all subsequent reads
+    /// return false.
+
+    class binary_reader
+    {
+	public:
+
+	    /// Constructor from a memory range.
+
+	    binary_reader(const char* first_,const char* last_):pos(first_),last(last_),failed(false){}
+
+	    /// Constructor reading the contents of a mapped file.
+
+	    binary_reader(const mapped_file& f):pos(f.data()),last(f.data()+f.size()),failed(false){}
+
+	    /// Reads a value of type T.
+
+	    template<class T>bool read(T& x)
+	    {
+		if(failed or (std::size_t)(last-pos)<sizeof(T))
+		{
+		    failed=true;
+		    return false;
+		}
+		std::memcpy(&x,pos,sizeof(T));
+		pos+=sizeof(T);
+		return true;
+	    }
+
+	    /// Reads a string written by write_binary.
+
+	    bool read(std::string& s)
+	    {
+		unsigned n;
+		if(!read(n) or (std::size_t)(last-pos)<n)
+		{
+		    failed=true;
+		    return false;
+		}
+		s.assign(pos,n);
+		pos+=n;
+		return true;
+	    }
+
+	    /// Skips n bytes.
+
+	    bool skip(std::size_t n)
+	    {
+		if(failed or (std::size_t)(last-pos)<n)
+		{
+		    failed=true;
+		    return false;
+		}
+		pos+=n;
+		return true;
+	    }
+
+	    /// Returns the current position.
+
+	    const char* position() const
+	    {
+		return pos;
+	    }
+
+	    /// Returns whether all data has been read.
+
+	    bool at_end() const
+	    {
+		return pos==last;
+	    }
+
+	    /// Returns false if a read exceeded the data.
+
+	    bool good() const
+	    {
+		return !failed;
+	    }
+
+	private:
+
+	    /* Current and final positions: */
+
+	    const char* pos;
+	    const char* last;
+
+	    /* Failure flag: */
+
+	    bool failed;
+    };
+}
+
+#endif /*CAMGEN_BIN_IO_H_*/
+
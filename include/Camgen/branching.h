@@ -207,6 +207,28 @@ namespace Camgen
 
 	    virtual void adapt_channels(){}
 
+	    /* Clears the multichannel statistics and grid data: */
+
+	    virtual void reset_statistics()
+	    {
+		W=0;
+		callcount=0;
+	    }
+
+	    /* Adds the multichannel statistics and grid data collected by the
+	     * argument, a copy of this branching: */
+
+	    virtual bool merge_statistics(const ps_branching<model_t,N_in,N_out,rng_t>* other)
+	    {
+		if(other==NULL)
+		{
+		    return false;
+		}
+		W+=other->W;
+		callcount+=other->callcount;
+		return true;
+	    }
+
 	    /* Full adaptation method: */
 
 	    void adapt()
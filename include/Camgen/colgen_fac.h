@@ -18,6 +18,7 @@
 #include <Camgen/MC_config.h>
 #include <Camgen/uni_cols.h>
 #include <Camgen/qcd_cols.h>
+#include <Camgen/adapt_cols.h>
 
 namespace Camgen
 {
@@ -103,6 +104,19 @@ namespace Camgen
 			{
 			    return NULL;
 			}
+		    case colour_generators::adaptive:
+			if(static_eq<typename model_t::colour_treatment,colour_flow>::value)
+			{
+			    return adaptive_colour_flows<value_type,N_in,N_out,model_t::N_c,rng_t,cc>::template create_instance<model_t>(it);
+			}
+			else if(static_eq<typename model_t::colour_treatment,adjoint>::value)
+			{
+			    return adjoint_QCD<value_type,N_in,N_out,model_t::N_c,rng_t,cc>::template create_instance<model_t>(it);
+			}
+			else
+			{
+			    return NULL;
+			}
 		    default:
 			return NULL;
 		}
@@ -149,6 +163,17 @@ namespace Camgen
 			result=NULL;
 		    }
 		}
+		else if(type=="adaptive")
+		{
+		    if(static_eq<typename model_t::colour_treatment,colour_flow>::value)
+		    {
+			result=adaptive_colour_flows<value_type,N_in,N_out,model_t::N_c,rng_t,cc>::template create_instance<model_t>(it);
+		    }
+		    else
+		    {
+			result=NULL;
+		    }
+		}
 		else
 		{
 		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"colour generator type "<<type<<" not recognised"<<endlog;
@@ -8,7 +8,6 @@
 #ifndef CAMGEN_CURRENT_H_
 #define CAMGEN_CURRENT_H_
 
-#include <set>
 #include <Camgen/forward_decs.h>
 #include <Camgen/particle.h>
 #include <Camgen/bit_string.h>
@@ -48,21 +47,23 @@ namespace Camgen
 
 	    friend class interaction_base<model_t,N>;
 	    
-	    /* Friend declarations of current_tree, process_tree and CM_algorithm classes: */
+	    /* Friend declarations of current_tree, process_tree, CM_algorithm, interaction_schedule and dof_amplitudes classes: */
 	    
 	    template<class mod_t,std::size_t N_in,std::size_t N_out>friend class process_tree;
 	    template<class mod_t,std::size_t N_in,std::size_t N_out>friend class current_tree;
 	    template<class mod_t,std::size_t N_in,std::size_t N_out>friend class CM_algorithm;
+	    template<class mod_t,std::size_t M,bool decomp>friend class interaction_schedule;
+	    template<class mod_t,std::size_t N_in,std::size_t N_out,bool decomp>friend class dof_amplitudes;
 
 	    /* Default constructor: */
 
-	    current_base():particle_t(NULL),CM_tag(false),coupled(true),outgoing(false),initialised(false),final_amplitude(NULL),phase_space(NULL){}
+	    current_base():particle_t(NULL),coupled(true),outgoing(false),initialised(false),final_amplitude(NULL),phase_space(NULL){}
 
 	    /* Regular constructor, specifying the type of particle propagated by the
 	     * current, the bitstring-coded momentum channel and an outgoing-particle
 	     * boolean tag: */
 
-	    current_base(const particle_type* phi,const bit_string<N>& b,bool out):particle_t(phi),bitstring(b),CM_tag(false),coupled(true),initialised(false),final_amplitude(NULL),phase_space(NULL)
+	    current_base(const particle_type* phi,const bit_string<N>& b,bool out):particle_t(phi),bitstring(b),coupled(true),initialised(false),final_amplitude(NULL),phase_space(NULL)
 	    {
 		if(b.count()<=1)
 		{
@@ -76,13 +77,43 @@ namespace Camgen
 
 	    /* Copy constructor: */
 
-	    current_base(const current_base<model_t,N>& other):momentum(other.momentum),particle_t(other.particle_t),bitstring(other.bitstring),CM_tag(other.CM_tag),coupled(other.coupled),outgoing(other.outgoing),initialised(other.initialised),amplitude(other.amplitude),multiplicity(other.multiplicity),final_amplitude(other.final_amplitude),phase_space(NULL)
+	    current_base(const current_base<model_t,N>& other):momentum(other.momentum),particle_t(other.particle_t),bitstring(other.bitstring),coupled(other.coupled),outgoing(other.outgoing),initialised(other.initialised),amplitude(other.amplitude),multiplicity(other.multiplicity),final_amplitude(other.final_amplitude),phase_space(NULL)
 	    {
 		if(other.phase_space!=NULL)
 		{
 		    allocate_phase_space();
 		}
 	    }
+
+	    /* Assignment operator. As in the copy constructor, the phase space
+	     * object is not shared but reallocated: */
+
+	    current_base<model_t,N>& operator = (const current_base<model_t,N>& other)
+	    {
+		if(this!=&other)
+		{
+		    momentum=other.momentum;
+		    particle_t=other.particle_t;
+		    bitstring=other.bitstring;
+		    coupled=other.coupled;
+		    outgoing=other.outgoing;
+		    initialised=other.initialised;
+		    amplitude=other.amplitude;
+		    multiplicity=other.multiplicity;
+		    final_amplitude=other.final_amplitude;
+		    if(phase_space!=NULL)
+		    {
+			delete phase_space;
+			phase_space=NULL;
+		    }
+		    if(other.phase_space!=NULL)
+		    {
+			allocate_phase_space();
+		    }
+		}
+		return *this;
+	    }
+
 	    /* Destructor: */
 
 	    ~current_base()
@@ -114,27 +145,6 @@ namespace Camgen
 		}
 	    }
 
-	    /* Marker utility function: */
-
-	    void mark()
-	    {
-		CM_tag=true;
-	    }
-	    
-	    /* Unmarking utility function: */
-	    
-	    void unmark()
-	    {
-		CM_tag=false;
-	    }
-
-	    /* Marker utility tag readout: */
-
-	    bool is_marked() const
-	    {
-		return CM_tag;
-	    }
-
 	    /* Momentum-channel bitstring readout: */
 
 	    bit_string<N> get_bit_string() const
@@ -311,10 +321,6 @@ namespace Camgen
 	    
 	    bit_string<N> bitstring;
 
-	    /* Utility boolean: */
-
-	    bool CM_tag;
-
 	    /* Decoupling utlilty boolean: */
 
 	    bool coupled;
@@ -631,10 +637,10 @@ namespace Camgen
 	    typedef typename base_type::momentum_type momentum_type;
 	    typedef typename base_type::particle_type particle_type;
 
-	    /* Additional type definitions involving stl sets of tensor
+	    /* Additional type definitions involving sorted sets of tensor
 	     * iterators: */
 
-	    typedef std::set<iterator> iterset;
+	    typedef iterator_set<iterator> iterset;
 	    typedef typename iterset::iterator iterset_iterator;
 	    typedef typename iterset::const_iterator const_iterset_iterator;
 
@@ -650,9 +656,28 @@ namespace Camgen
 	    
 	    current(const particle_type* phi,const bit_string<N>& b,bool ext):base_type(phi,b,ext){}
 	    
-	    /* Copy constructor: */
+	    /* Copy constructor. The propagating colour modes of the argument
+	     * refer to its own subamplitude tensor, so the copy starts out with
+	     * a reset subamplitude instead: */
 	    
-	    current(const current<model_t,N,true>& other):base_type(other),amp_iters(other.amp_iters){}
+	    current(const current<model_t,N,true>& other):base_type(other)
+	    {
+		this->amplitude.reset();
+	    }
+
+	    /* Assignment operator, resetting the subamplitude for the same
+	     * reason: */
+
+	    current<model_t,N,true>& operator = (const current<model_t,N,true>& other)
+	    {
+		if(this!=&other)
+		{
+		    this->base_type::operator=(other);
+		    amp_iters.clear();
+		    this->amplitude.reset();
+		}
+		return *this;
+	    }
 	    
 	    /* Subamplitude resetting function, only resetting the propagating
 	     * colour modes: */
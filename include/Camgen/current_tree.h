@@ -11,14 +11,21 @@
 #include <algorithm>
 #include <Camgen/current.h>
 #include <Camgen/logstream.h>
+#include <Camgen/mt_utils.h>
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * Definition of the current_tree class, which is essentially a static list of   *
  * current objects. Given the model type, the number of in- and outgoing legs of *
  * the process and the final particle number, the initialisation of the data     *
- * tree creates a big vector of all possible currents (all particle flavours in  *
- * all possible momentum channels). The actual subprocess trees consist of lists *
- * of interactions between these currents.                                       *
+ * tree creates the external currents of all flavours. Internal currents are    *
+ * only allocated when requested by the process trees, which determine the      *
+ * (momentum channel, flavour) pairs they can reach before being built. The     *
+ * currents are appended to the data vector and found through a per-channel     *
+ * index, so memory and initialisation time scale with the number of reachable  *
+ * currents rather than with the number of channels times flavours. The actual  *
+ * subprocess trees consist of lists of interactions between these currents.    *
+ * The marks set on the currents while building a tree are stored per thread,   *
+ * so that distinct trees can be constructed concurrently.                       *
  *                                                                               *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
@@ -53,9 +60,10 @@ namespace Camgen
 
 	    typedef current<model_t,N_bits,get_colour_treatment<model_t>::decomposes> current_type;
 	    
-	    /* Current iterator type definition: */
+	    /* Current iterator type definitions: */
 	    
 	    typedef typename std::vector<current_type>::iterator iterator;
+	    typedef typename std::vector<current_type>::const_iterator const_iterator;
 	    
 	    /* Current vector size type definition: */
 	    
@@ -78,7 +86,9 @@ namespace Camgen
 		}
 	    }
 
-	    /* Tree construction function: */
+	    /* Tree construction function, allocating the external currents. As
+	     * long as the capacity of the current vector suffices, these keep
+	     * their addresses: */
 
 	    static void refresh()
 	    {
@@ -88,35 +98,96 @@ namespace Camgen
 		    log(log_level::warning)<<"previously built process trees will become invalid..."<<endlog;
 		}
 
-		/* Resize the current vector to N_channels x N_flavours: */
-
 		flavours=model_wrapper<model_t>::flavours();
 		data.clear();
-		data.resize(static_size*(flavours));
+		channels.assign(static_size,std::vector<index_entry>());
+		requests.clear();
 		
-		/* Construct initial & internal currents: */
+		/* Request initial currents of all flavours: */
 		
 		bit_string<N_bits>B;
 		B.set(0);
-		size_type counter=0;
-		size_type m=(N_final<N_in)?(N_in-1):N_in;
-		for(size_type i=0;i<static_size-1;++i)
+		for(size_type i=0;i<N_bits;++i)
 		{
 		    for(size_type j=0;j<flavours;++j)
 		    {
-			data[counter]=current_type(model_wrapper<model_t>::get_particle(j),B,(i>=m and i<N_bits));
-			++counter;
+			request_current(B,j);
 		    }
 		    B.next();
 		}
 
-		/* Construct final currents: */
+		/* Request final currents of all flavours: */
 
+		B.reset();
 		for(size_type j=0;j<flavours;++j)
 		{
-		    data[counter]=current_type(model_wrapper<model_t>::get_particle(j),B,(N_final>=N_in));
-		    ++counter;
+		    request_current(B,j);
+		}
+		std::vector<current_type>old;
+		allocate(old);
+	    }
+
+	    /* Requests the current with the argument momentum channel and
+	     * flavour, which will be constructed upon the next call to
+	     * allocate(). Returns false if the current was already requested:
+	     * */
+
+	    static bool request_current(const bit_string<N_bits>& B,size_type flav)
+	    {
+		std::vector<index_entry>& c=channels[channel(B)];
+		typename std::vector<index_entry>::iterator it=std::lower_bound(c.begin(),c.end(),index_entry(flav,0));
+		if(it!=c.end() and it->first==flav)
+		{
+		    return false;
 		}
+		c.insert(it,index_entry(flav,data.size()+requests.size()));
+		requests.push_back(std::pair<bit_string<N_bits>,size_type>(B,flav));
+		return true;
+	    }
+
+	    /* Constructs all requested currents. If the capacity of the current
+	     * vector does not suffice, the current data is reallocated, the
+	     * argument is swapped with the previous data and the function
+	     * returns true. Process trees referring to the previous data
+	     * should then be relocated (their phase space objects are
+	     * transferred to the new data): */
+
+	    static bool allocate(std::vector<current_type>& old)
+	    {
+		if(requests.empty())
+		{
+		    return false;
+		}
+		bool moved=(data.capacity()<data.size()+requests.size());
+		if(moved)
+		{
+		    reallocate(data,data.size()+requests.size(),old);
+		}
+		for(size_type i=0;i<requests.size();++i)
+		{
+		    data.push_back(make_current(requests[i].first,requests[i].second));
+		}
+		requests.clear();
+		return moved;
+	    }
+
+	    /* Moves the currents of the first argument to new storage with
+	     * capacity n. The phase space objects are transferred, such that
+	     * their addresses remain valid, and the previous storage (with
+	     * newly allocated phase spaces) is swapped into the last argument:
+	     * */
+
+	    static void reallocate(std::vector<current_type>& v,size_type n,std::vector<current_type>& old)
+	    {
+		std::vector<current_type>w;
+		w.reserve(n);
+		w.insert(w.end(),v.begin(),v.end());
+		for(size_type i=0;i<v.size();++i)
+		{
+		    std::swap(w[i].phase_space,v[i].phase_space);
+		}
+		old.swap(v);
+		v.swap(w);
 	    }
 
 	    /* Function re-assigning the final particle currents: */
@@ -130,28 +201,16 @@ namespace Camgen
 		    log(log_level::message)<<"re-assigning momentum directions in current tree..."<<endlog;
 		    log(log_level::warning)<<"previously built process trees will become invalid..."<<endlog;
 		    
-		    for(size_type i=(N_in-1)*flavours;i<N_in*flavours;++i)
-		    {
-			data[i].set_incoming();
-		    }
-		    for(size_type i=data.size()-flavours;i<data.size();++i)
-		    {
-			data[i].set_outgoing();
-		    }
+		    set_directions(channels[N_in-1],true);
+		    set_directions(channels[static_size-1],false);
 		}
 		if(!p and q)
 		{
 		    log(log_level::message)<<"re-assigning momentum directions in current tree..."<<endlog;
 		    log(log_level::warning)<<"previously built process trees will become invalid..."<<endlog;
 
-		    for(size_type i=(N_in-1)*flavours;i<N_in*flavours;++i)
-		    {
-			data[i].set_outgoing();
-		    }
-		    for(size_type i=data.size()-flavours;i<data.size();++i)
-		    {
-			data[i].set_incoming();
-		    }
+		    set_directions(channels[N_in-1],false);
+		    set_directions(channels[static_size-1],true);
 		}
 		N_final=n;
 	    }
@@ -163,14 +222,27 @@ namespace Camgen
 		return N_final;
 	    }
 
+	    /* Number of allocated currents: */
+
+	    static size_type size()
+	    {
+		return data.size();
+	    }
+
 	    /* Output method: */
 
 	    static std::ostream& print(std::ostream& os)
 	    {
-		for(int i=0;i<data.size();++i)
+		for(size_type i=0;i<channels.size();++i)
 		{
-		    data[i].print(os);
-		    os<<std::endl;
+		    for(size_type j=0;j<channels[i].size();++j)
+		    {
+			if(channels[i][j].second<data.size())
+			{
+			    data[channels[i][j].second].print(os);
+			    os<<std::endl;
+			}
+		    }
 		}
 		return os;
 	    }
@@ -185,35 +257,23 @@ namespace Camgen
 	    {
 		return data.end();
 	    }
-	    static iterator begin_internals()
-	    {
-		if(initialised)
-		{
-		    return data.begin()+N_bits*flavours;
-		}
-		else
-		{
-		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"internal current iterator requested for uninitialised data"<<endlog;
-		    return data.end();
-		}
-	    }
-	    static iterator end_internals()
-	    {
-		if(initialised)
-		{
-		    return data.end()-flavours;
-		}
-		log(log_level::warning)<<CAMGEN_STREAMLOC<<"internal current iterator requested for uninitialised data"<<endlog;
-		return data.end();
-	    }
 
-	    /* Current-finding algorithms: */
+	    /* Current-finding algorithms. If the requested current was not
+	     * allocated, the end of the current data is returned: */
 
 	    static iterator find_current(const bit_string<N_bits>& B)
 	    {
 		if(initialised)
 		{
-		    return data.begin()+((B.to_integer()-1)*flavours);
+		    const std::vector<index_entry>& c=channels[channel(B)];
+		    for(size_type i=0;i<c.size();++i)
+		    {
+			if(c[i].second<data.size())
+			{
+			    return data.begin()+c[i].second;
+			}
+		    }
+		    return data.end();
 		}
 		log(log_level::warning)<<CAMGEN_STREAMLOC<<"internal current iterator requested for uninitialised data"<<endlog;
 		return data.end();
@@ -221,13 +281,8 @@ namespace Camgen
 
 	    static iterator find_current(const bit_string<N_bits>& B,const particle<model_t>* phi)
 	    {
-		if(initialised)
-		{
-		    CAMGEN_ERROR_IF((phi==NULL),"attempt to dereference NULL particle type instance...");
-		    return data.begin()+((B.to_integer()-1)*flavours+phi->get_flavour());
-		}
-		log(log_level::warning)<<CAMGEN_STREAMLOC<<"current iterator requested for uninitialised data"<<endlog;
-		return data.end();
+		CAMGEN_ERROR_IF((phi==NULL),"attempt to dereference NULL particle type instance...");
+		return find_current(B,phi->get_flavour());
 	    }
 
 	    static iterator find_current(const bit_string<N_bits>& B,const std::string& str)
@@ -239,7 +294,13 @@ namespace Camgen
 	    {
 		if(initialised)
 		{
-		    return (flav<flavours)?(data.begin()+(B.to_integer()-1)*flavours+flav):data.end();
+		    const std::vector<index_entry>& c=channels[channel(B)];
+		    typename std::vector<index_entry>::const_iterator it=std::lower_bound(c.begin(),c.end(),index_entry(flav,0));
+		    if(it!=c.end() and it->first==flav and it->second<data.size())
+		    {
+			return data.begin()+it->second;
+		    }
+		    return data.end();
 		}
 		log(log_level::warning)<<CAMGEN_STREAMLOC<<"current iterator requested for uninitialised data"<<endlog;
 		return data.end();
@@ -251,14 +312,13 @@ namespace Camgen
 	    {
 		if(initialised)
 		{
-		    iterator it=data.begin()+((B.to_integer()-1)*flavours);
-		    for(size_type i=0;i<flavours;++i)
+		    const std::vector<index_entry>& c=channels[channel(B)];
+		    for(size_type i=0;i<c.size();++i)
 		    {
-			if(it->is_marked())
+			if(c[i].second<data.size() and is_marked(c[i].second))
 			{
-			    return it;
+			    return data.begin()+c[i].second;
 			}
-			++it;
 		    }
 		}
 		else
@@ -284,30 +344,22 @@ namespace Camgen
 		    }
 		    if(it->get_bit_string().count()>1)
 		    {
-			iterator final=data.begin()+((it-data.begin())/flavours+1)*flavours;
-			do
+			const std::vector<index_entry>& c=channels[channel(it->get_bit_string())];
+			size_type n=it-data.begin();
+			size_type i=0;
+			while(c[i].second!=n)
 			{
-			    --final;
+			    ++i;
 			}
-			while(!(final->is_marked()));
-			if(it==final)
+			for(++i;i<c.size();++i)
 			{
-			    it=data.begin()+((it-data.begin())/flavours)*flavours;
-			    while(!(it->is_marked()))
+			    if(c[i].second<data.size() and is_marked(c[i].second))
 			    {
-				++it;
+				it=data.begin()+c[i].second;
+				return false;
 			    }
-			    return true;
-			}
-			else
-			{
-			    do
-			    {
-				++it;
-			    }
-			    while(!(it->is_marked()));
-			    return false;
 			}
+			it=first_marked_current(it->get_bit_string());
 		    }
 		    return true;
 		}
@@ -331,23 +383,56 @@ namespace Camgen
 		return (n != 0 or iters[0] != check);
 	    }
 
-	    /* Function unmarking all currents: */
+	    /* Marks the argument current in the calling thread: */
 
-	    static void unmark()
+	    static void mark(iterator it)
 	    {
-		for(size_type i=0;i<data.size();++i)
+		if(marks.size()<data.size())
 		{
-		    data[i].unmark();
+		    marks.resize(data.size(),false);
 		}
+		marks[it-data.begin()]=true;
+	    }
+
+	    /* Returns whether the argument current was marked in the calling
+	     * thread: */
+
+	    static bool is_marked(iterator it)
+	    {
+		return is_marked(it-data.begin());
+	    }
+
+	    /* Function unmarking all currents in the calling thread: */
+
+	    static void unmark()
+	    {
+		marks.assign(data.size(),false);
 	    }
 
 	private:
 
-	    /* Vector of currents of all possible flavours in all possible
-	     * momentum channels: */
+	    /* Channel index entry type, holding the flavour of a current and its
+	     * position in the data vector: */
+
+	    typedef std::pair<size_type,size_type> index_entry;
+
+	    /* Vector of allocated currents: */
 
 	    static std::vector<current_type>data;
+
+	    /* Index of the allocated currents per momentum channel, sorted by
+	     * flavour. The last entry contains the final currents: */
+
+	    static std::vector< std::vector<index_entry> >channels;
+
+	    /* Requested currents that were not allocated yet: */
+
+	    static std::vector< std::pair<bit_string<N_bits>,size_type> >requests;
 	    
+	    /* Marks of the currents set by the calling thread: */
+
+	    static CAMGEN_THREAD_LOCAL std::vector<bool>marks;
+
 	    /* Number of flavours in the model: */
 	    
 	    static size_type flavours;
@@ -355,12 +440,73 @@ namespace Camgen
 	    /* Initialisation tag: */
 
 	    static bool initialised;
+
+	    /* Returns the index of the momentum channel, where the empty bit
+	     * string denotes the final current channel: */
+
+	    static size_type channel(const bit_string<N_bits>& B)
+	    {
+		size_type n=B.to_integer();
+		return (n==0)?(static_size-1):(n-1);
+	    }
+
+	    /* Constructs the current with the argument momentum channel and
+	     * flavour. External currents are outgoing if their channel index
+	     * is beyond the last incoming leg: */
+
+	    static current_type make_current(const bit_string<N_bits>& B,size_type flav)
+	    {
+		size_type c=channel(B);
+		bool out;
+		if(c==static_size-1)
+		{
+		    out=(N_final>=N_in);
+		}
+		else
+		{
+		    size_type m=(N_final<N_in)?(N_in-1):N_in;
+		    out=(c>=m and c<N_bits);
+		}
+		return current_type(model_wrapper<model_t>::get_particle(flav),B,out);
+	    }
+
+	    /* Sets the momentum directions of the allocated currents in the
+	     * argument channel index: */
+
+	    static void set_directions(const std::vector<index_entry>& c,bool incoming)
+	    {
+		for(size_type i=0;i<c.size();++i)
+		{
+		    if(c[i].second<data.size())
+		    {
+			if(incoming)
+			{
+			    data[c[i].second].set_incoming();
+			}
+			else
+			{
+			    data[c[i].second].set_outgoing();
+			}
+		    }
+		}
+	    }
+
+	    /* Returns whether the n-th current was marked in the calling
+	     * thread: */
+
+	    static bool is_marked(size_type n)
+	    {
+		return n<marks.size() and marks[n];
+	    }
     };
 
     template<class model_t,std::size_t N_in,std::size_t N_out>const std::size_t current_tree<model_t,N_in,N_out>::N_bits;
     template<class model_t,std::size_t N_in,std::size_t N_out>const std::size_t current_tree<model_t,N_in,N_out>::static_size;
     template<class model_t,std::size_t N_in,std::size_t N_out>std::size_t current_tree<model_t,N_in,N_out>::N_final=0;
     template<class model_t,std::size_t N_in,std::size_t N_out>std::vector<typename current_tree<model_t,N_in,N_out>::current_type >current_tree<model_t,N_in,N_out>::data;
+    template<class model_t,std::size_t N_in,std::size_t N_out>std::vector< std::vector<typename current_tree<model_t,N_in,N_out>::index_entry> >current_tree<model_t,N_in,N_out>::channels;
+    template<class model_t,std::size_t N_in,std::size_t N_out>std::vector< std::pair<bit_string<current_tree<model_t,N_in,N_out>::N_bits>,typename current_tree<model_t,N_in,N_out>::size_type> >current_tree<model_t,N_in,N_out>::requests;
+    template<class model_t,std::size_t N_in,std::size_t N_out>CAMGEN_THREAD_LOCAL std::vector<bool>current_tree<model_t,N_in,N_out>::marks;
     template<class model_t,std::size_t N_in,std::size_t N_out>typename current_tree<model_t,N_in,N_out>::size_type current_tree<model_t,N_in,N_out>::flavours=0;
     template<class model_t,std::size_t N_in,std::size_t N_out>bool current_tree<model_t,N_in,N_out>::initialised=false;
 }
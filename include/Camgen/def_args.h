@@ -64,7 +64,7 @@ typedef typename get_basic_types<M>::momentum_type momentum_type
 /* Macro defining the argument list of vertex class methods in the case where
  * the program keeps track of nonzero propagating colour modes: */
 
-#define CFD_ARG_LIST const value_type& factor,const std::vector<const value_type*>& couplings,std::vector<iterator>& iters,const std::vector<const momentum_type*>& momenta,std::set<iterator>& produced_iters
+#define CFD_ARG_LIST const value_type& factor,const std::vector<const value_type*>& couplings,std::vector<iterator>& iters,const std::vector<const momentum_type*>& momenta,iterator_set<iterator>& produced_iters
 
 /* Preprocessor definitions of the arguments in the lists above: */
 
@@ -0,0 +1,475 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+#ifndef CAMGEN_DOF_AMPS_H_
+#define CAMGEN_DOF_AMPS_H_
+
+#include <map>
+#include <Camgen/interaction.h>
+#include <Camgen/def_args.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Definition of the dof_amplitudes class template, computing the amplitudes of  *
+ * all summed helicity and colour configurations of a process tree in a single   *
+ * pass of the recursion. Every external current carries the wave functions of   *
+ * all its summed degrees of freedom, and every internal current carries one     *
+ * subamplitude for each configuration of the external legs it depends on. Each  *
+ * interaction is applied to all combinations of incoming subamplitudes, where   *
+ * vanishing subamplitudes are skipped. The final leg is contracted with the     *
+ * last internal current for all its configurations. The amplitudes are stored   *
+ * in the order of the dof loop of the process tree, i.e. the first leg runs     *
+ * fastest. In colour decomposition mode the propagating colours of a current    *
+ * depend on the configuration, and the class falls back to the dof loop.        *
+ *                                                                               *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+namespace Camgen
+{
+    /* Vectorised dof amplitudes for models without colour flow decomposition:
+     * */
+
+    template<class model_t,std::size_t N_in,std::size_t N_out>class dof_amplitudes<model_t,N_in,N_out,false>
+    {
+	public:
+
+	    /* The usual type definitions: */
+
+	    DEFINE_BASIC_TYPES(model_t);
+
+	    /* Number of particles that the tree is built upon: */
+
+	    static const std::size_t N_bits=N_in+N_out-1;
+
+	    /* Current and interaction type definitions: */
+
+	    typedef current<model_t,N_bits,false> current_type;
+	    typedef interaction<model_t,N_bits,false> interaction_type;
+	    typedef typename std::vector<current_type>::iterator current_iterator;
+
+	    /* Constructor: */
+
+	    dof_amplitudes():dims(N_in+N_out,0),nodes(N_bits),built(false){}
+
+	    /* Clears the current structure, which is rebuilt upon the next
+	     * evaluation: */
+
+	    void clear()
+	    {
+		nodes.resize(N_bits);
+		fusions.clear();
+		tables.clear();
+		last_offsets.clear();
+		built=false;
+	    }
+
+	    /* Computes the amplitudes of all dof configurations of the tree
+	     * with interactions [first,last), external currents init_currents
+	     * and final current fc. Returns false if the configurations cannot
+	     * be vectorised, in which case the external currents have to be
+	     * reinitialised for the dof loop: */
+
+	    template<class interaction_iterator>bool evaluate(interaction_iterator first,interaction_iterator last,const std::vector<current_iterator>& init_currents,current_iterator fc,size_type N_final,const std::bitset<N_in+N_out>& summed_spins,const std::bitset<N_in+N_out>& summed_cols,std::vector<value_type>& amplitudes)
+	    {
+		if(first==last)
+		{
+		    return false;
+		}
+
+		/* Collect the wave functions of all external dofs: */
+
+		std::vector<size_type>new_dims(N_in+N_out);
+		for(size_type e=0;e<N_bits;++e)
+		{
+		    size_type l=leg(e,N_final);
+		    node& n=nodes[e];
+		    current_type* c=&(*(init_currents[e]));
+		    c->init_dof_sum(summed_spins[l],summed_cols[l]);
+		    size_type k=0;
+		    do
+		    {
+			if(k<n.states.size())
+			{
+			    n.states[k]=c->amplitude;
+			}
+			else
+			{
+			    n.states.push_back(c->amplitude);
+			}
+			++k;
+		    }
+		    while(!(c->evaluate_dof_sum(summed_spins[l],summed_cols[l])));
+		    n.states.resize(k);
+		    if(n.zero.size()!=c->amplitude.size())
+		    {
+			n.zero=c->amplitude;
+			n.zero.reset();
+		    }
+		    n.nonzero.resize(k);
+		    for(size_type i=0;i<k;++i)
+		    {
+			n.nonzero[i]=(n.states[i]!=n.zero);
+		    }
+		    new_dims[l]=k;
+		}
+		fc->init_dof_sum(summed_spins[N_final],summed_cols[N_final]);
+		new_dims[N_final]=1;
+		while(!(fc->evaluate_dof_sum(summed_spins[N_final],summed_cols[N_final])))
+		{
+		    ++new_dims[N_final];
+		}
+
+		/* (Re)build the internal current structure if necessary: */
+
+		if(!built or new_dims!=dims)
+		{
+		    dims=new_dims;
+		    if(!build(first,last,init_currents,N_final))
+		    {
+			clear();
+			return false;
+		    }
+		}
+
+		/* Compute the momenta and coupling flags: */
+
+		for(interaction_iterator it=first;it!=last;++it)
+		{
+		    it->compute_momentum();
+		    it->compute_coupling_flag();
+		}
+
+		/* Apply all interactions to all dof configurations: */
+
+		typename std::vector<fusion>::const_iterator f=fusions.begin();
+		for(interaction_iterator it=first;it!=last;++it,++f)
+		{
+		    node& P=nodes[f->produced];
+		    if(f->group_begin)
+		    {
+			for(size_type k=0;k<P.size;++k)
+			{
+			    P.states[k].reset();
+			}
+		    }
+		    if(it->coupled)
+		    {
+			std::vector<iterator>& args=iters[f->rank];
+			size_type n_in=f->rank-1;
+			for(size_type k=0;k<P.size;++k)
+			{
+			    bool nonzero=true;
+			    for(size_type j=0;j<n_in and nonzero;++j)
+			    {
+				size_type idx=tables[f->table+j*P.size+k];
+				nonzero=nodes[f->inputs[j]].nonzero[idx];
+			    }
+			    if(!nonzero)
+			    {
+				continue;
+			    }
+			    for(size_type s=0,j=0;s<f->rank;++s)
+			    {
+				if(s==it->produced_current)
+				{
+				    args[s]=P.states[k].begin();
+				}
+				else
+				{
+				    args[s]=nodes[f->inputs[j]].states[tables[f->table+j*P.size+k]].begin();
+				    ++j;
+				}
+			    }
+			    if(it->swap_fermions)
+			    {
+				std::swap(args[1],args[2]);
+			    }
+			    it->Feynman_rule(value_type(it->Fermi_sign,0),it->vertex_t->get_couplings(),args,it->momenta);
+			}
+		    }
+		    if(f->group_end)
+		    {
+			for(size_type k=0;k<P.size;++k)
+			{
+			    P.nonzero[k]=(P.states[k]!=P.zero);
+			}
+			if(it->prop_policy[2])
+			{
+			    current_type* c=&(*(it->currents[it->produced_current]));
+			    if(c->particle_t->is_coupled())
+			    {
+				c->particle_t->refresh_propagator(&(c->momentum));
+				for(size_type k=0;k<P.size;++k)
+				{
+				    if(P.nonzero[k])
+				    {
+					c->particle_t->propagate(P.states[k].begin(),P.states[k].end());
+				    }
+				}
+			    }
+			}
+		    }
+		}
+
+		/* Contract the last current with the final leg wave functions.
+		 * The final leg is looped over again, since its contraction may
+		 * depend on its phase space dofs. Its wave function is reset
+		 * first, as unsummed wave functions are added to the current: */
+
+		size_type N_total=1;
+		for(size_type l=0;l<N_in+N_out;++l)
+		{
+		    N_total*=dims[l];
+		}
+		amplitudes.assign(N_total,value_type(0,0));
+		const node& L=nodes[last_node];
+		fc->reset();
+		fc->init_dof_sum(summed_spins[N_final],summed_cols[N_final]);
+		size_type offset=0;
+		do
+		{
+		    if(fc->particle_t->is_coupled())
+		    {
+			for(size_type k=0;k<L.size;++k)
+			{
+			    if(L.nonzero[k])
+			    {
+				amplitudes[last_offsets[k]+offset]=fc->phase_space->contract(L.states[k].begin(),fc->amplitude.begin());
+			    }
+			}
+		    }
+		    offset+=final_stride;
+		}
+		while(!(fc->evaluate_dof_sum(summed_spins[N_final],summed_cols[N_final])));
+		return true;
+	    }
+
+	private:
+
+	    /* Current node type, holding the subamplitudes of a current for all
+	     * configurations of its external legs: */
+
+	    struct node
+	    {
+		std::vector<size_type>legs;
+		std::vector<size_type>strides;
+		size_type size;
+		std::vector<tensor_type>states;
+		std::vector<bool>nonzero;
+		tensor_type zero;
+	    };
+
+	    /* Fusion type, with the node indices of an interaction and the
+	     * offset of its index table: */
+
+	    struct fusion
+	    {
+		size_type produced;
+		std::vector<size_type>inputs;
+		size_type rank;
+		size_type table;
+		bool group_begin;
+		bool group_end;
+	    };
+
+	    /* Number of dofs of the external legs: */
+
+	    std::vector<size_type>dims;
+
+	    /* Current nodes, starting with the external currents: */
+
+	    std::vector<node>nodes;
+
+	    /* Fusions, in the order of the interactions: */
+
+	    std::vector<fusion>fusions;
+
+	    /* Index tables: for every incoming current of a fusion and every
+	     * configuration of the produced current, the corresponding
+	     * configuration of the incoming current: */
+
+	    std::vector<size_type>tables;
+
+	    /* Node index of the last internal current: */
+
+	    size_type last_node;
+
+	    /* Amplitude offsets of the configurations of the last internal
+	     * current, and the amplitude stride of the final leg: */
+
+	    std::vector<size_type>last_offsets;
+	    size_type final_stride;
+
+	    /* Argument vectors passed to the Feynman rules, one per vertex
+	     * rank: */
+
+	    std::vector< std::vector<iterator> >iters;
+
+	    /* Flag denoting whether the structure is built: */
+
+	    bool built;
+
+	    /* Maps the index of an external current to its leg number: */
+
+	    static size_type leg(size_type e,size_type N_final)
+	    {
+		return (e<N_final)?e:(e+1);
+	    }
+
+	    /* Builds the current node structure: */
+
+	    template<class interaction_iterator>bool build(interaction_iterator first,interaction_iterator last,const std::vector<current_iterator>& init_currents,size_type N_final)
+	    {
+		clear();
+		std::map<const current_type*,size_type>node_map;
+		for(size_type e=0;e<N_bits;++e)
+		{
+		    node& n=nodes[e];
+		    n.legs.assign(1,leg(e,N_final));
+		    n.strides.assign(1,1);
+		    n.size=dims[n.legs[0]];
+		    node_map[&(*(init_currents[e]))]=e;
+		}
+		size_type max_rank=0;
+		for(interaction_iterator it=first;it!=last;++it)
+		{
+		    fusion f;
+		    const current_type* c=&(*(it->currents[it->produced_current]));
+		    typename std::map<const current_type*,size_type>::iterator m=node_map.find(c);
+		    if(m==node_map.end())
+		    {
+			node n;
+			n.size=1;
+			for(size_type e=0;e<N_bits;++e)
+			{
+			    bit_string<N_bits>b=init_currents[e]->get_bit_string();
+			    if((b&c->get_bit_string())==b)
+			    {
+				n.legs.push_back(leg(e,N_final));
+				n.strides.push_back(n.size);
+				n.size*=dims[leg(e,N_final)];
+			    }
+			}
+			n.zero=c->amplitude;
+			n.zero.reset();
+			n.states.assign(n.size,n.zero);
+			n.nonzero.assign(n.size,false);
+			m=node_map.insert(std::pair<const current_type*,size_type>(c,nodes.size())).first;
+			nodes.push_back(n);
+			f.group_begin=true;
+		    }
+		    else
+		    {
+			if(m->second<N_bits or fusions.empty() or fusions.back().produced!=m->second)
+			{
+			    return false;
+			}
+			f.group_begin=false;
+		    }
+		    f.produced=m->second;
+		    f.rank=it->currents.size();
+		    f.table=tables.size();
+		    f.group_end=true;
+		    if(!fusions.empty() and !f.group_begin)
+		    {
+			fusions.back().group_end=false;
+		    }
+		    max_rank=std::max(max_rank,f.rank);
+
+		    /* Fill the index tables of the incoming currents: */
+
+		    const node& P=nodes[f.produced];
+		    for(size_type s=0;s<it->currents.size();++s)
+		    {
+			if(s==it->produced_current)
+			{
+			    continue;
+			}
+			typename std::map<const current_type*,size_type>::const_iterator m2=node_map.find(&(*(it->currents[s])));
+			if(m2==node_map.end() or m2->second==f.produced)
+			{
+			    return false;
+			}
+			f.inputs.push_back(m2->second);
+			const node& I=nodes[m2->second];
+			for(size_type k=0;k<P.size;++k)
+			{
+			    size_type idx=0;
+			    for(size_type q=0;q<P.legs.size();++q)
+			    {
+				for(size_type r=0;r<I.legs.size();++r)
+				{
+				    if(I.legs[r]==P.legs[q])
+				    {
+					idx+=((k/P.strides[q])%dims[P.legs[q]])*I.strides[r];
+				    }
+				}
+			    }
+			    tables.push_back(idx);
+			}
+		    }
+		    fusions.push_back(f);
+		}
+
+		/* The last internal current should depend on all external legs
+		 * except the final one: */
+
+		last_node=fusions.back().produced;
+		const node& L=nodes[last_node];
+		if(L.legs.size()!=N_bits)
+		{
+		    return false;
+		}
+		std::vector<size_type>gstrides(N_in+N_out);
+		size_type g=1;
+		for(size_type l=0;l<N_in+N_out;++l)
+		{
+		    gstrides[l]=g;
+		    g*=dims[l];
+		}
+		final_stride=gstrides[N_final];
+		last_offsets.assign(L.size,0);
+		for(size_type k=0;k<L.size;++k)
+		{
+		    for(size_type q=0;q<L.legs.size();++q)
+		    {
+			last_offsets[k]+=((k/L.strides[q])%dims[L.legs[q]])*gstrides[L.legs[q]];
+		    }
+		}
+		iters.resize(max_rank+1);
+		for(size_type n=0;n<=max_rank;++n)
+		{
+		    iters[n].resize(n);
+		}
+		built=true;
+		return true;
+	    }
+    };
+
+    /* Models with colour flow decomposition use the dof loop of the process
+     * tree: */
+
+    template<class model_t,std::size_t N_in,std::size_t N_out>class dof_amplitudes<model_t,N_in,N_out,true>
+    {
+	public:
+
+	    /* The usual type definitions: */
+
+	    DEFINE_BASIC_TYPES(model_t);
+
+	    void clear(){}
+
+	    template<class interaction_iterator,class current_iterator>bool evaluate(interaction_iterator first,interaction_iterator last,const std::vector<current_iterator>& init_currents,current_iterator fc,size_type N_final,const std::bitset<N_in+N_out>& summed_spins,const std::bitset<N_in+N_out>& summed_cols,std::vector<value_type>& amplitudes)
+	    {
+		return false;
+	    }
+    };
+}
+
+#include <Camgen/undef_args.h>
+
+#endif /*CAMGEN_DOF_AMPS_H_*/
+
@@ -13,6 +13,8 @@
 #define CAMGEN_EVT_GEN_H_
 
 #include <Camgen/MC_config.h>
+#include <Camgen/mt_utils.h>
+#include <Camgen/alias_table.h>
 #include <Camgen/proc_gen.h>
 
 namespace Camgen
@@ -99,9 +101,14 @@ namespace Camgen
 		    return NULL;
 		}
 		result->load(is);
+		bool sum_procs=false;
 		while(line!="<procgen>" and !is.eof())
 		{
 		    std::getline(is,line);
+		    if(line=="<sumprocs>")
+		    {
+			sum_procs=true;
+		    }
 		}
 		if(is.eof())
 		{
@@ -122,7 +129,13 @@ namespace Camgen
 		    }
 		    std::getline(is,line);
 		}
+		result->assign_equivalent_processes();
 		std::sort(result->procs.begin(),result->procs.end(),alpha_more);
+		if(sum_procs)
+		{
+		    result->sum_compatible_processes();
+		}
+		result->refresh_alias_table();
 		if(result->procs.size()!=0)
 		{
 		    result->sub_proc=result->procs.begin();
@@ -171,9 +184,14 @@ namespace Camgen
 		    return NULL;
 		}
 		result->load(is);
+		bool sum_procs=false;
 		while(line!="<procgen>" and !is.eof())
 		{
 		    std::getline(is,line);
+		    if(line=="<sumprocs>")
+		    {
+			sum_procs=true;
+		    }
 		}
 		if(is.eof())
 		{
@@ -196,7 +214,13 @@ namespace Camgen
 		    }
 		    std::getline(is,line);
 		}
+		result->assign_equivalent_processes();
 		std::sort(result->procs.begin(),result->procs.end(),alpha_more);
+		if(sum_procs)
+		{
+		    result->sum_compatible_processes();
+		}
+		result->refresh_alias_table();
 		if(result->procs.size()!=0)
 		{
 		    result->sub_proc=result->procs.begin();
@@ -232,7 +256,7 @@ namespace Camgen
 
 	    /// Constructor from static configuration data.
 
-	    event_generator(CM_algorithm<model_t,N_in,N_out>& algo):algorithm(algo),update_counter(0),auto_update(false),auto_proc_adapt(0),ps_cut(NULL),scale(NULL),subproc_params(1,0)
+	    event_generator(CM_algorithm<model_t,N_in,N_out>& algo):algorithm(algo),update_counter(0),auto_update(false),auto_proc_adapt(0),ps_cut(NULL),scale(NULL),subproc_params(1,0),proc_time(0)
 	    {
 		procs.reserve(algorithm.n_trees());
 		init();
@@ -250,7 +274,7 @@ namespace Camgen
 
 	    /// Constructor from configuration data in the settings object.
 
-	    event_generator(CM_algorithm<model_t,N_in,N_out>& algo,generator_configuration<model_t>& settings):algorithm(algo),update_counter(0),auto_update(false),auto_proc_adapt(0),ps_cut(NULL),scale(NULL),subproc_params(1,0)
+	    event_generator(CM_algorithm<model_t,N_in,N_out>& algo,generator_configuration<model_t>& settings):algorithm(algo),update_counter(0),auto_update(false),auto_proc_adapt(0),ps_cut(NULL),scale(NULL),subproc_params(1,0),proc_time(0)
 	    {
 		procs.reserve(algorithm.n_trees());
 		init();
@@ -274,6 +298,46 @@ namespace Camgen
 		subproc_params.second=subprocess_threshold();
 	    }
 
+	    /// Groups the subprocesses with identical external masses and colour
+	    /// representations, and lets the first generator of every group
+	    /// evaluate the matrix elements of the others at its phase space
+	    /// points (see process_generator::add_summed_process). The other
+	    /// generators are no longer sampled. Should be called before
+	    /// initialisation. Returns the number of remaining subprocess
+	    /// generators.
+
+	    size_type sum_compatible_processes()
+	    {
+		process_container leaders;
+		value_type alpha(0);
+		for(process_iterator it=procs.begin();it!=procs.end();++it)
+		{
+		    process_iterator it2=leaders.begin();
+		    while(it2!=leaders.end() and !(*it2)->add_summed_process(*it))
+		    {
+			++it2;
+		    }
+		    if(it2==leaders.end())
+		    {
+			leaders.push_back(*it);
+			alpha+=(*it)->alpha;
+		    }
+		    else
+		    {
+			(*it)->alpha=(value_type)0;
+			summed_procs.push_back(*it);
+		    }
+		}
+		procs.swap(leaders);
+		for(process_iterator it=procs.begin();it!=procs.end();++it)
+		{
+		    (*it)->alpha=(alpha>(value_type)0)?((*it)->alpha/alpha):((value_type)1/procs.size());
+		}
+		sub_proc=procs.begin();
+		refresh_alias_table();
+		return procs.size();
+	    }
+
 	    /// Pre-initialisation method to obtain first subprocess cross
 	    /// section estimates, determining which subprocesses are relevant.
 
@@ -353,6 +417,10 @@ namespace Camgen
 		{
 		    delete procs[i];
 		}
+		for(size_type i=0;i<summed_procs.size();++i)
+		{
+		    delete summed_procs[i];
+		}
 	    }
 
 	    /* Public modifying member functions */
@@ -481,20 +549,14 @@ namespace Camgen
 		    this->weight()=(value_type)0;
 		    return false;
 		}
-		value_type rho=rn_stream::throw_number();
-		sub_proc=procs.begin();
-		value_type r(0);
-		while(r<=rho and sub_proc!=procs.end())
-		{
-		    r+=(*sub_proc)->alpha;
-		    ++sub_proc;
-		}
-		--sub_proc;
-		if(sub_proc==procs.end())
+		double t0=wall_clock();
+		if(proc_alias.size()!=procs.size() and !refresh_alias_table())
 		{
-		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"subprocess iterator overflow detected--no generation performed"<<endlog;
+		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"no subprocess with positive multichannel weight--no generation performed"<<endlog;
 		    return false;
 		}
+		sub_proc=procs.begin()+proc_alias.sample(rn_stream::throw_number());
+		proc_time+=(wall_clock()-t0);
 		bool q=(*sub_proc)->generate();
 		this->integrand()=(*sub_proc)->integrand();
 		this->weight()=(*sub_proc)->weight()/(*sub_proc)->alpha;
@@ -561,7 +623,9 @@ namespace Camgen
 		    (*it)->reset();
 		    (*it)->alpha=(value_type)1/procs.size();
 		}
+		refresh_alias_table();
 		update_counter=0;
+		proc_time=0;
 	    }
 
 	    /// Resets all subprocess cross sections.
@@ -707,6 +771,7 @@ namespace Camgen
 		}
 		if(it==procs.end() or it==procs.begin())
 		{
+		    refresh_alias_table();
 		    return;
 		}
 		std::size_t newsize=it-procs.begin();
@@ -720,6 +785,54 @@ namespace Camgen
 		}
 		procs.resize(newsize);
 		sub_proc=procs.begin();
+		refresh_alias_table();
+	    }
+
+	    /// Adds the argument weight sums to the cross section data of the
+	    /// subprocess with the argument id. Returns false if no such
+	    /// subprocess exists.
+
+	    bool add_process_weight_sums(size_type id,const MC_weight_sums<value_type>& sums)
+	    {
+		for(process_iterator it=procs.begin();it!=procs.end();++it)
+		{
+		    if((*it)->id==id)
+		    {
+			(*it)->add_weight_sums(sums);
+			this->up_to_date=false;
+			return true;
+		    }
+		}
+		return false;
+	    }
+
+	    /// Clears the grid and multichannel statistics of all subprocesses,
+	    /// keeping the grids and channel weights intact.
+
+	    void reset_statistics()
+	    {
+		for(process_iterator it=procs.begin();it!=procs.end();++it)
+		{
+		    (*it)->reset_statistics();
+		}
+	    }
+
+	    /// Adds the grid and multichannel statistics of the subprocesses of
+	    /// the argument, a copy of this generator, to the subprocesses of
+	    /// this instance.
+
+	    bool merge_statistics(const event_generator<model_t,N_in,N_out,rng_t>& other)
+	    {
+		if(other.procs.size()!=procs.size())
+		{
+		    return false;
+		}
+		bool q=true;
+		for(size_type i=0;i<procs.size();++i)
+		{
+		    q&=procs[i]->merge_statistics(*(other.procs[i]));
+		}
+		return q;
 	    }
 
 	    /// Sets up the weight histogram (default 1000 bins).
@@ -780,6 +893,35 @@ namespace Camgen
 		return procs.size();
 	    }
 
+	    /// Returns the number of subprocesses evaluated at the phase space
+	    /// points of other subprocess generators.
+
+	    size_type summed_processes() const
+	    {
+		return summed_procs.size();
+	    }
+
+	    /// Returns the time (in seconds) spent selecting subprocesses since
+	    /// the last reset.
+
+	    double subprocess_selection_time() const
+	    {
+		return proc_time;
+	    }
+
+	    /// Returns the time (in seconds) spent by the subprocess phase space
+	    /// generators selecting channels since the last reset.
+
+	    double channel_selection_time() const
+	    {
+		double t=0;
+		for(const_process_iterator it=procs.begin();it!=procs.end();++it)
+		{
+		    t+=(*it)->channel_selection_time();
+		}
+		return t;
+	    }
+
 	    /// Returns the current process id.
 
 	    size_type process_id() const
@@ -1036,6 +1178,13 @@ namespace Camgen
 		return (*sub_proc)->particle(i);
 	    }
 
+	    /// Returns the pointer to the n-th subprocess generator.
+
+	    process_generator_type* process(size_type n)
+	    {
+		return procs[n];
+	    }
+
 	    /// Returns the const pointer to the n-th subprocess generator.
 
 	    const process_generator_type* process(size_type n) const
@@ -1106,7 +1255,7 @@ namespace Camgen
 	    std::ostream& print_status(std::ostream& os=std::cout) const
 	    {
 		size_type evt_counter=0,pos_evt_counter=0,calls=0,grid_adaptations=0,channel_adaptations=0;
-		value_type efficiency;
+		value_type efficiency(0);
 		for(const_process_iterator it=procs.begin();it!=procs.end();++it)
 		{
 		    evt_counter+=((*it)->evt_counter);
@@ -1118,6 +1267,7 @@ namespace Camgen
 		}
 		os<<"###############################################################################################"<<std::endl;
 		os<<"Nr of subprocesses:                                "<<std::scientific<<procs.size()<<std::endl;
+		os<<"Nr of summed subprocesses:                         "<<std::scientific<<summed_procs.size()<<std::endl;
 		os<<"Nr of events generated:                            "<<std::scientific<<evt_counter<<std::endl;
 		os<<"Nr of positive weight events generated:            "<<std::scientific<<pos_evt_counter<<std::endl;
 		os<<"Nr of events contributing to cross-section:        "<<std::scientific<<calls<<std::endl;
@@ -1125,8 +1275,11 @@ namespace Camgen
 		os<<"Nr of grid adaptations performed:                  "<<std::scientific<<grid_adaptations<<std::endl;
 		os<<"Nr of channel adaptations performed:               "<<std::scientific<<channel_adaptations<<std::endl;
 		os<<"Mean Monte Carlo efficiency (%):                   "<<std::scientific<<efficiency<<std::endl;
+		os<<"Subprocess selection time (s):                     "<<std::scientific<<subprocess_selection_time()<<std::endl;
+		os<<"Channel selection time (s):                        "<<std::scientific<<channel_selection_time()<<std::endl;
 		os<<"Cross section (pb):                                "<<std::scientific<<cross_section()<<std::endl;
 		os<<"###############################################################################################"<<std::endl;
+		return os;
 	    }
 
 	    /// Prints the generator cuts.
@@ -1178,10 +1331,18 @@ namespace Camgen
 		os<<"<evtgen>"<<std::endl;
 		this->base_type::save(os);
 		os<<update_counter<<"\t"<<auto_update<<"\t"<<auto_proc_adapt<<"\t"<<subproc_params.first<<"\t"<<subproc_params.second<<std::endl;
+		if(!summed_procs.empty())
+		{
+		    os<<"<sumprocs>"<<std::endl;
+		}
 		for(const_process_iterator it=procs.begin();it!=procs.end();++it)
 		{
 		    (*it)->save(os);
 		}
+		for(const_process_iterator it=summed_procs.begin();it!=summed_procs.end();++it)
+		{
+		    (*it)->save(os);
+		}
 		os<<"</evtgen>"<<std::endl;
 		return os;
 	    }
@@ -1214,6 +1375,11 @@ namespace Camgen
 
 	    process_container procs;
 
+	    /* Subprocess generators evaluated at the phase space points of the
+	     * generators in procs: */
+
+	    process_container summed_procs;
+
 	    /* Subprocess iterator: */
 
 	    process_iterator sub_proc;
@@ -1242,9 +1408,17 @@ namespace Camgen
 
 	    std::pair<value_type,value_type> subproc_params;
 
+	    /* Alias table of the subprocess multichannel weights: */
+
+	    alias_table<value_type>proc_alias;
+
+	    /* Time spent in subprocess selection: */
+
+	    double proc_time;
+
 	    /* Private constructor: */
 	    
-	    event_generator(CM_algorithm<model_t,N_in,N_out>& algo,bool alloc):algorithm(algo),update_counter(0),auto_update(false),auto_proc_adapt(0),ps_cut(NULL),scale(NULL),subproc_params(1,0)
+	    event_generator(CM_algorithm<model_t,N_in,N_out>& algo,bool alloc):algorithm(algo),update_counter(0),auto_update(false),auto_proc_adapt(0),ps_cut(NULL),scale(NULL),subproc_params(1,0),proc_time(0)
 	    {
 		procs.reserve(algorithm.n_trees());
 		if(alloc)
@@ -1257,6 +1431,42 @@ namespace Camgen
 		}
 	    }
 
+	    /* Lets the process generators produce the events of all subprocesses
+	     * sharing their amplitudes: */
+
+	    void assign_equivalent_processes()
+	    {
+		if(!algorithm.reset_process())
+		{
+		    return;
+		}
+		do
+		{
+		    for(process_iterator it=procs.begin();it!=procs.end();++it)
+		    {
+			if((*it)->amplitude==algorithm.get_tree_iterator())
+			{
+			    (*it)->add_equivalent_process(algorithm.get_process_iterator()->get_pdg_ids());
+			    break;
+			}
+		    }
+		}
+		while(algorithm.next_process());
+	    }
+
+	    /* Rebuilds the subprocess alias table from the multichannel weights.
+	     * Returns false if no subprocess has positive weight: */
+
+	    bool refresh_alias_table()
+	    {
+		std::vector<value_type>alphas(procs.size());
+		for(size_type i=0;i<procs.size();++i)
+		{
+		    alphas[i]=procs[i]->alpha;
+		}
+		return proc_alias.build(alphas);
+	    }
+
 	    /* Constructor helper function: */
 
 	    void init()
@@ -1264,15 +1474,19 @@ namespace Camgen
 		if(algorithm.reset_process())
 		{
 		    size_type id=0;
+		    std::vector<CM_tree_iterator>trees;
 		    do
 		    {
-			if(!algorithm.get_tree_iterator()->is_empty())
+			CM_tree_iterator it=algorithm.get_tree_iterator();
+			if(!it->is_empty() and std::find(trees.begin(),trees.end(),it)==trees.end())
 			{
-			    procs.push_back(new process_generator_type(algorithm.get_tree_iterator(),id));
+			    trees.push_back(it);
+			    procs.push_back(new process_generator_type(it,id));
 			    ++id;
 			}
 		    }
 		    while(algorithm.next_process());
+		    assign_equivalent_processes();
 		    if(procs.size()!=0)
 		    {
 			value_type alpha=(value_type)1/(value_type)procs.size();
@@ -1281,6 +1495,7 @@ namespace Camgen
 			    procs[i]->alpha=alpha;
 			}
 			sub_proc=procs.begin();
+			refresh_alias_table();
 		    }
 		    else
 		    {
@@ -0,0 +1,325 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+/*! \file evt_rwgt.h
+    \brief Matrix-element reweighting of existing event samples.
+ */
+
+#ifndef CAMGEN_EVT_RWGT_H_
+#define CAMGEN_EVT_RWGT_H_
+
+#include <map>
+#include <Camgen/mt_utils.h>
+#include <Camgen/CM_algo.h>
+#include <Camgen/bin_if.h>
+#include <Camgen/def_args.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Definition of the event_reweighter class template. The reweighter reads the   *
+ * particle ids and momenta of the events from a binary event file reader or a   *
+ * Les-Houches event file reader, selects the corresponding subprocess of the    *
+ * CM algorithm and evaluates the helicity- and colour-summed squared amplitude, *
+ * so that the helicities and colours of the events are not needed. The events   *
+ * are divided into contiguous ranges, which are evaluated concurrently by       *
+ * instance-local copies of the algorithm. A reweighting pass first evaluates    *
+ * the reference squared amplitudes; after changing the model parameters, every  *
+ * call to add_weight() evaluates the sample again and adds a weight column with *
+ * the event weights multiplied by the ratio of the new and reference squared    *
+ * amplitudes. Since the model parameters are static, the passes are done one    *
+ * after the other, each being a single streaming pass over the sample without   *
+ * regenerating the events. Running couplings are not reset to the event scales. *
+ *                                                                               *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+namespace Camgen
+{
+    /// Event sample reweighting class template. The reader type should
+    /// provide the events, particle ids, momenta and weights in the way of
+    /// the binary_file_reader and LHE_file_reader classes.
+
+    template<class model_t,std::size_t N_in,std::size_t N_out,class reader_t=binary_file_reader>class event_reweighter
+    {
+	public:
+
+	    /* The usual type definitions: */
+
+	    DEFINE_BASIC_TYPES(model_t);
+
+	    /* Algorithm, phase space and reader type definitions: */
+
+	    typedef CM_algorithm<model_t,N_in,N_out> algorithm_type;
+	    typedef typename algorithm_type::phase_space_type phase_space_type;
+	    typedef reader_t reader_type;
+	    typedef vector<int,N_in+N_out> id_vector;
+
+	    /// Constructor with the algorithm, the event reader and the number
+	    /// of threads (by default the number of hardware threads). The
+	    /// subprocesses of the events that are missing in the algorithm are
+	    /// added to it.
+
+	    event_reweighter(algorithm_type& algo,const reader_type& reader_,size_type n_threads=0):reader(reader_),n_events(0)
+	    {
+		if(!reader.is_open() or reader.n_incoming()!=N_in or reader.n_outgoing()!=N_out)
+		{
+		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"event sample does not match the "<<N_in<<" -> "<<N_out<<" algorithm--no events will be reweighted"<<endlog;
+		    return;
+		}
+		n_events=reader.events();
+		for(size_type i=0;i<n_events;++i)
+		{
+		    id_vector ids=event_ids(i);
+		    if(processes.find(ids)==processes.end())
+		    {
+			algo.set_process_pdg_ids(ids);
+			processes[ids]=algo.valid_process();
+			if(!algo.valid_process())
+			{
+			    log(log_level::warning)<<CAMGEN_STREAMLOC<<"subprocess "<<ids<<" could not be constructed--its events will get zero weight"<<endlog;
+			}
+		    }
+		}
+		if(n_threads==0)
+		{
+		    n_threads=hardware_threads();
+		}
+		n_threads=std::max(std::min(n_threads,n_events),(size_type)1);
+		for(size_type j=0;j<n_threads;++j)
+		{
+		    lanes.push_back(new algorithm_type(algo));
+		    lanes.back()->sum_spins();
+		    lanes.back()->sum_colours();
+		}
+	    }
+
+	    /// Destructor.
+
+	    ~event_reweighter()
+	    {
+		for(size_type j=0;j<lanes.size();++j)
+		{
+		    delete lanes[j];
+		}
+	    }
+
+	    /// Returns the number of events.
+
+	    size_type events() const
+	    {
+		return n_events;
+	    }
+
+	    /// Returns the number of threads.
+
+	    size_type threads() const
+	    {
+		return lanes.size();
+	    }
+
+	    /// Evaluates the helicity- and colour-summed squared amplitudes of
+	    /// all events with the current model parameters into the argument.
+
+	    void evaluate(std::vector<r_value_type>& me2)
+	    {
+		me2.assign(n_events,(r_value_type)0);
+		std::vector<evaluation_job*>jobs(lanes.size(),NULL);
+		for(size_type j=0;j<lanes.size();++j)
+		{
+		    jobs[j]=new evaluation_job(this,j,me2);
+		}
+		run_parallel(jobs);
+		for(size_type j=0;j<jobs.size();++j)
+		{
+		    delete jobs[j];
+		}
+	    }
+
+	    /// Evaluates the reference squared amplitudes with the current model
+	    /// parameters, and removes the added weight columns.
+
+	    void set_reference()
+	    {
+		evaluate(reference);
+		names.clear();
+		columns.clear();
+	    }
+
+	    /// Returns the reference squared amplitudes.
+
+	    const std::vector<r_value_type>& reference_amplitudes() const
+	    {
+		return reference;
+	    }
+
+	    /// Evaluates the squared amplitudes with the current model
+	    /// parameters and adds a weight column with the argument name, with
+	    /// the event weights multiplied by the ratio of the squared amplitude
+	    /// and its reference value. Events with vanishing reference squared
+	    /// amplitude get zero weight. Returns false if no reference was set.
+
+	    bool add_weight(const std::string& name)
+	    {
+		if(reference.size()!=n_events or n_events==0)
+		{
+		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"no reference squared amplitudes evaluated--weight "<<name<<" not added"<<endlog;
+		    return false;
+		}
+		std::vector<r_value_type>me2;
+		evaluate(me2);
+		names.push_back(name);
+		columns.push_back(std::vector<double>(n_events,0));
+		std::vector<double>& w=columns.back();
+		for(size_type i=0;i<n_events;++i)
+		{
+		    if(reference[i]!=(r_value_type)0)
+		    {
+			w[i]=reader.weight(i)*(me2[i]/reference[i]);
+		    }
+		}
+		return true;
+	    }
+
+	    /// Returns the number of added weight columns.
+
+	    size_type weights() const
+	    {
+		return names.size();
+	    }
+
+	    /// Returns the name of the j-th weight column.
+
+	    const std::string& weight_name(size_type j) const
+	    {
+		return names[j];
+	    }
+
+	    /// Returns the j-th weight column.
+
+	    const std::vector<double>& weight_column(size_type j) const
+	    {
+		return columns[j];
+	    }
+
+	    /// Returns the j-th weight of event i.
+
+	    double weight(size_type j,size_type i) const
+	    {
+		return columns[j][i];
+	    }
+
+	    /// Writes a copy of the event file with the added weight columns
+	    /// (see the write_weights methods of the readers).
+
+	    bool write(const std::string& filename) const
+	    {
+		return reader.write_weights(filename,names,columns);
+	    }
+
+	private:
+
+	    /* Evaluation of a contiguous range of events by one lane: */
+
+	    struct evaluation_job
+	    {
+		event_reweighter* reweighter;
+		size_type lane;
+		std::vector<r_value_type>* me2;
+
+		evaluation_job(event_reweighter* reweighter_,size_type lane_,std::vector<r_value_type>& me2_):reweighter(reweighter_),lane(lane_),me2(&me2_){}
+
+		void operator()()
+		{
+		    reweighter->evaluate_range(lane,*me2);
+		}
+	    };
+
+	    /* Event reader: */
+
+	    const reader_type& reader;
+
+	    /* Number of events: */
+
+	    size_type n_events;
+
+	    /* Instance-local algorithm copies: */
+
+	    std::vector<algorithm_type*>lanes;
+
+	    /* Subprocesses of the sample and their validity: */
+
+	    std::map<id_vector,bool>processes;
+
+	    /* Reference squared amplitudes: */
+
+	    std::vector<r_value_type>reference;
+
+	    /* Added weight names and columns: */
+
+	    std::vector<std::string>names;
+	    std::vector< std::vector<double> >columns;
+
+	    /* Returns the particle ids of event i: */
+
+	    id_vector event_ids(size_type i) const
+	    {
+		id_vector ids;
+		for(size_type k=0;k<N_in+N_out;++k)
+		{
+		    ids[k]=reader.id(i,k);
+		}
+		return ids;
+	    }
+
+	    /* Evaluates the events in the range of the argument lane. The
+	     * subprocess is only selected when the particle ids change, and
+	     * only among the subprocesses added in the constructor: */
+
+	    void evaluate_range(size_type j,std::vector<r_value_type>& me2) const
+	    {
+		algorithm_type* algo=lanes[j];
+		size_type first=(j*n_events)/lanes.size(),last=((j+1)*n_events)/lanes.size();
+		id_vector current;
+		bool valid=false;
+		for(size_type i=first;i<last;++i)
+		{
+		    id_vector ids=event_ids(i);
+		    if(i==first or ids!=current)
+		    {
+			current=ids;
+			typename std::map<id_vector,bool>::const_iterator it=processes.find(ids);
+			valid=(it!=processes.end() and it->second);
+			if(valid)
+			{
+			    algo->set_process_pdg_ids(ids);
+			}
+		    }
+		    if(!valid)
+		    {
+			continue;
+		    }
+		    for(size_type k=0;k<N_in+N_out;++k)
+		    {
+			momentum_type& p=algo->get_phase_space(k)->momentum();
+			for(size_type mu=0;mu<model_t::dimension;++mu)
+			{
+			    p[mu]=reader.p(i,k,mu);
+			}
+		    }
+		    me2[i]=algo->evaluate_sum();
+		}
+	    }
+
+	    /* Non-copyable: */
+
+	    event_reweighter(const event_reweighter&);
+	    event_reweighter& operator = (const event_reweighter&);
+    };
+}
+
+#include <Camgen/undef_args.h>
+
+#endif /*CAMGEN_EVT_RWGT_H_*/
+
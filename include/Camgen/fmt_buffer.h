@@ -0,0 +1,345 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+/*! \file fmt_buffer.h
+    \brief Character buffer with fast number formatting.
+ */
+
+#ifndef CAMGEN_FMT_BUFFER_H_
+#define CAMGEN_FMT_BUFFER_H_
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if __cplusplus>=201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+#ifdef __cpp_lib_to_chars
+#define CAMGEN_HAVE_TO_CHARS 1
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output buffer for event and data files. Numbers are formatted directly into *
+ * the buffer without iostreams, and the contents are written to the output    *
+ * stream in a single call. Floating-point numbers in scientific notation      *
+ * reproduce the output of std::scientific with the same precision; the        *
+ * mantissa is obtained from a single scaling by an exact power of ten, so the *
+ * last digit may differ in rare near-halfway cases. The shortest round-trip   *
+ * notation uses std::to_chars if available, and otherwise the shortest of the *
+ * %g formats with 15, 16 and 17 significant digits that reads back exactly.   *
+ *                                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+namespace Camgen
+{
+    /// Character output buffer with number formatting.
+
+    class format_buffer
+    {
+	public:
+
+	    /* Type definitions: */
+
+	    typedef std::size_t size_type;
+
+	    /// Constructor, reserving the argument number of characters.
+
+	    format_buffer(size_type n=0)
+	    {
+		buf.reserve(n);
+	    }
+
+	    /// Reserves storage for the argument number of characters.
+
+	    void reserve(size_type n)
+	    {
+		buf.reserve(n);
+	    }
+
+	    /// Clears the buffer.
+
+	    void clear()
+	    {
+		buf.clear();
+	    }
+
+	    /// Returns whether the buffer is empty.
+
+	    bool empty() const
+	    {
+		return buf.empty();
+	    }
+
+	    /// Returns the number of buffered characters.
+
+	    size_type size() const
+	    {
+		return buf.size();
+	    }
+
+	    /// Returns a pointer to the buffered characters.
+
+	    const char* data() const
+	    {
+		return buf.empty()?NULL:(&buf[0]);
+	    }
+
+	    /// Appends a character.
+
+	    void put(char c)
+	    {
+		buf.push_back(c);
+	    }
+
+	    /// Appends a null-terminated string, right-aligned in the argument
+	    /// field width.
+
+	    void put(const char* s,int width=0)
+	    {
+		append(s,std::strlen(s),width);
+	    }
+
+	    /// Appends a string, right-aligned in the argument field width.
+
+	    void put(const std::string& s,int width=0)
+	    {
+		append(s.c_str(),s.size(),width);
+	    }
+
+	    /// Appends an integer, right-aligned in the argument field width.
+
+	    void put_int(long n,int width=0)
+	    {
+		char s[24];
+		append(s,format_int(s,n),width);
+	    }
+
+	    /// Appends a floating-point number in scientific notation with the
+	    /// argument number of decimals, right-aligned in the argument field
+	    /// width.
+
+	    void put_scientific(double x,int precision=10,int width=0)
+	    {
+		char s[48];
+		append(s,format_scientific(s,x,precision),width);
+	    }
+
+	    /// Appends a floating-point number in the shortest notation that
+	    /// reads back to the same value, right-aligned in the argument field
+	    /// width.
+
+	    void put_shortest(double x,int width=0)
+	    {
+		char s[32];
+		append(s,format_shortest(s,x),width);
+	    }
+
+	    /// Writes the buffered characters to the argument stream and clears
+	    /// the buffer.
+
+	    bool write(std::ostream& os)
+	    {
+		if(!buf.empty())
+		{
+		    os.write(&buf[0],buf.size());
+		    buf.clear();
+		}
+		return os.good();
+	    }
+
+	    /// Exchanges the buffered characters with the argument vector.
+
+	    void swap(std::vector<char>& v)
+	    {
+		buf.swap(v);
+	    }
+
+	    /// Writes the integer to the argument character array and returns
+	    /// the number of characters written.
+
+	    static size_type format_int(char* s,long n)
+	    {
+		char tmp[24];
+		size_type k=0;
+		unsigned long m=(n<0)?(0ul-(unsigned long)n):((unsigned long)n);
+		do
+		{
+		    tmp[k++]=(char)('0'+(m%10));
+		    m/=10;
+		}
+		while(m!=0);
+		size_type l=0;
+		if(n<0)
+		{
+		    s[l++]='-';
+		}
+		while(k!=0)
+		{
+		    s[l++]=tmp[--k];
+		}
+		return l;
+	    }
+
+	    /// Writes the floating-point number in the shortest notation that
+	    /// reads back to the same value to the character array, which should
+	    /// hold at least 32 characters, and returns the number of characters
+	    /// written.
+
+	    static size_type format_shortest(char* s,double x)
+	    {
+#ifdef CAMGEN_HAVE_TO_CHARS
+		return std::to_chars(s,s+32,x).ptr-s;
+#else
+		for(int precision=15;precision<17;++precision)
+		{
+		    int n=std::sprintf(s,"%.*g",precision,x);
+		    if(std::strtod(s,NULL)==x)
+		    {
+			return n;
+		    }
+		}
+		return std::sprintf(s,"%.17g",x);
+#endif
+	    }
+
+	    /// Writes the floating-point number in scientific notation with the
+	    /// argument number of decimals to the character array, which should
+	    /// hold at least 48 characters, and returns the number of characters
+	    /// written.
+
+	    static size_type format_scientific(char* s,double x,int precision)
+	    {
+		if(x!=x or std::abs(x)>std::numeric_limits<double>::max() or precision<0 or precision>17)
+		{
+		    return std::sprintf(s,"%.*e",precision,x);
+		}
+		size_type l=0;
+		if(x<0)
+		{
+		    s[l++]='-';
+		    x=-x;
+		}
+		const unsigned long long p=pow10_int(precision);
+		unsigned long long m=0;
+		int e=0;
+		if(x!=0)
+		{
+		    e=(int)std::floor(std::log10(x));
+		    m=scale(x,precision-e);
+		    if(m>=10*p)
+		    {
+			++e;
+			m=scale(x,precision-e);
+		    }
+		    else if(m<p)
+		    {
+			--e;
+			m=scale(x,precision-e);
+		    }
+		    if(m>=10*p)
+		    {
+			m/=10;
+			++e;
+		    }
+		}
+		char digits[24];
+		for(int i=precision;i>=0;--i)
+		{
+		    digits[i]=(char)('0'+(m%10));
+		    m/=10;
+		}
+		s[l++]=digits[0];
+		if(precision>0)
+		{
+		    s[l++]='.';
+		    std::memcpy(s+l,digits+1,precision);
+		    l+=precision;
+		}
+		s[l++]='e';
+		s[l++]=(e<0)?'-':'+';
+		if(e<0)
+		{
+		    e=-e;
+		}
+		if(e>=100)
+		{
+		    s[l++]=(char)('0'+e/100);
+		}
+		s[l++]=(char)('0'+(e/10)%10);
+		s[l++]=(char)('0'+e%10);
+		return l;
+	    }
+
+	private:
+
+	    /* Character buffer: */
+
+	    std::vector<char>buf;
+
+	    /* Appends n characters, right-aligned in the field width: */
+
+	    void append(const char* s,size_type n,int width)
+	    {
+		if(width>0 and (size_type)width>n)
+		{
+		    buf.insert(buf.end(),(size_type)width-n,' ');
+		}
+		buf.insert(buf.end(),s,s+n);
+	    }
+
+	    /* Returns 10^n as an integer: */
+
+	    static unsigned long long pow10_int(int n)
+	    {
+		unsigned long long result=1;
+		for(int i=0;i<n;++i)
+		{
+		    result*=10;
+		}
+		return result;
+	    }
+
+	    /* Returns x*10^n rounded to the nearest integer. Powers of ten up
+	     * to 10^22 are exact doubles, so a single rounding occurs in the
+	     * common case: */
+
+	    static unsigned long long scale(double x,int n)
+	    {
+		static const double pow10[23]={1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22};
+		double y=x;
+		while(n>22)
+		{
+		    y*=pow10[22];
+		    n-=22;
+		}
+		if(n>=0)
+		{
+		    y*=pow10[n];
+		}
+		else if(n>=-22)
+		{
+		    y/=pow10[-n];
+		}
+		else
+		{
+		    y/=std::pow(10.0,-n);
+		}
+		return (unsigned long long)std::floor(y+0.5);
+	    }
+    };
+}
+
+#endif /*CAMGEN_FMT_BUFFER_H_*/
+
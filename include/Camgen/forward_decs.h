@@ -30,6 +30,7 @@ namespace Camgen
 	template<class model_t,std::size_t N_in,std::size_t N_out>class process_tree;
 	template<class model_t,std::size_t N,bool decomp>class current;
 	template<class model_t,std::size_t N>class current_base;
+	template<class model_t,std::size_t N_in,std::size_t N_out,bool decomp>class dof_amplitudes;
 	template<class Feynrule_t>class evaluate;
 	template<class model_t>class particle_family;
 	template<class model_t>class fermion_propagator;
@@ -50,6 +51,7 @@ namespace Camgen
 	
 	template<class model_t,std::size_t N,bool decomp>class interaction;
 	template<class model_t,std::size_t N>class interaction_base;
+	template<class model_t,std::size_t N,bool decomp>class interaction_schedule;
 	template<class model_t>class m_anti_fermion_wave_function;
 	template<class model_t>class m_fermion_wave_function;
 	template<class model_t,std::size_t dim=model_t::dimension,class spacetime_t=typename model_t::spacetime_type,class Dirac_t=typename model_t::Dirac_algebra_type>class m_vector_wave_function;
@@ -131,10 +131,6 @@ namespace Camgen
 
 	private:
 
-	    /* Generator instance: */
-
-	    generator_type* gen;
-
 	    /* Interface output instance: */
 
 	    interface_output<model_t>* output;
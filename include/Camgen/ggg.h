@@ -8,6 +8,8 @@
 #ifndef CAMGEN_GGG_H_
 #define CAMGEN_GGG_H_
 
+#include <Camgen/mt_utils.h>
+
 namespace Camgen
 {
     /* Specialisation of the Yang-Mills 3-vertex composed with the
@@ -254,15 +256,15 @@ namespace Camgen
 	    }
 	    static void fourth(ARG_LIST){}
 	private:
-	    static value_type c1[N*N-1];
-	    static value_type c2[N*N-1];
-	    static value_type c3[N*N-1][N*N-1];
+	    static CAMGEN_THREAD_LOCAL value_type c1[N*N-1];
+	    static CAMGEN_THREAD_LOCAL value_type c2[N*N-1];
+	    static CAMGEN_THREAD_LOCAL value_type c3[N*N-1][N*N-1];
     };
     template<std::size_t N,class model_t>const std::size_t evaluate<compose_vertices<colour_tensor::f<SU<N>,0,1,2>,vvv<model_t> > >::vector_size;
     template<std::size_t N,class model_t>const std::size_t evaluate<compose_vertices<colour_tensor::f<SU<N>,0,1,2>,vvv<model_t> > >::gluon_size;
-    template<std::size_t N,class model_t>typename evaluate<compose_vertices<colour_tensor::f<SU<N>,0,1,2>,vvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::f<SU<N>,0,1,2>,vvv<model_t> > >::c1[N*N-1]={0};
-    template<std::size_t N,class model_t>typename evaluate<compose_vertices<colour_tensor::f<SU<N>,0,1,2>,vvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::f<SU<N>,0,1,2>,vvv<model_t> > >::c2[N*N-1]={0};
-    template<std::size_t N,class model_t>typename evaluate<compose_vertices<colour_tensor::f<SU<N>,0,1,2>,vvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::f<SU<N>,0,1,2>,vvv<model_t> > >::c3[N*N-1][N*N-1]={{0}};
+    template<std::size_t N,class model_t>CAMGEN_THREAD_LOCAL typename evaluate<compose_vertices<colour_tensor::f<SU<N>,0,1,2>,vvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::f<SU<N>,0,1,2>,vvv<model_t> > >::c1[N*N-1]={0};
+    template<std::size_t N,class model_t>CAMGEN_THREAD_LOCAL typename evaluate<compose_vertices<colour_tensor::f<SU<N>,0,1,2>,vvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::f<SU<N>,0,1,2>,vvv<model_t> > >::c2[N*N-1]={0};
+    template<std::size_t N,class model_t>CAMGEN_THREAD_LOCAL typename evaluate<compose_vertices<colour_tensor::f<SU<N>,0,1,2>,vvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::f<SU<N>,0,1,2>,vvv<model_t> > >::c3[N*N-1][N*N-1]={{0}};
 
     /* Specialisation evaluate class template for the gluon 3-vertex with the
      * gluons in the colour-flow representation: */
@@ -494,14 +496,14 @@ namespace Camgen
 	    }
 	    static void fourth(ARG_LIST){}
 	private:
-	    static value_type c1[N][N];
-	    static value_type c2[N][N];
+	    static CAMGEN_THREAD_LOCAL value_type c1[N][N];
+	    static CAMGEN_THREAD_LOCAL value_type c2[N][N];
     };
     template<std::size_t N,class model_t>const std::size_t evaluate<compose_vertices<colour_tensor::CF_f<N,0,1,2>,vvv<model_t> > >::vector_size;
     template<std::size_t N,class model_t>const std::size_t evaluate<compose_vertices<colour_tensor::CF_f<N,0,1,2>,vvv<model_t> > >::quark_size;
     template<std::size_t N,class model_t>const std::size_t evaluate<compose_vertices<colour_tensor::CF_f<N,0,1,2>,vvv<model_t> > >::gluon_size;
-    template<std::size_t N,class model_t>typename evaluate<compose_vertices<colour_tensor::CF_f<N,0,1,2>,vvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::CF_f<N,0,1,2>,vvv<model_t> > >::c1[N][N]={{0}};
-    template<std::size_t N,class model_t>typename evaluate<compose_vertices<colour_tensor::CF_f<N,0,1,2>,vvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::CF_f<N,0,1,2>,vvv<model_t> > >::c2[N][N]={{0}};
+    template<std::size_t N,class model_t>CAMGEN_THREAD_LOCAL typename evaluate<compose_vertices<colour_tensor::CF_f<N,0,1,2>,vvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::CF_f<N,0,1,2>,vvv<model_t> > >::c1[N][N]={{0}};
+    template<std::size_t N,class model_t>CAMGEN_THREAD_LOCAL typename evaluate<compose_vertices<colour_tensor::CF_f<N,0,1,2>,vvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::CF_f<N,0,1,2>,vvv<model_t> > >::c2[N][N]={{0}};
 }
 
 #endif /*CAMGEN_GGG_H_*/
@@ -8,6 +8,8 @@
 #ifndef CAMGEN_GGGG_H_
 #define CAMGEN_GGGG_H_
 
+#include <Camgen/mt_utils.h>
+
 namespace Camgen
 {
     /* Declaration and definition of the four-gluon vertex with the gluons in
@@ -575,9 +577,9 @@ namespace Camgen
 
 	    /* Inner product data holders: */
 
-	    static value_type c1[N*N-1][N*N-1];
-	    static value_type c2[N*N-1][N*N-1];
-	    static value_type c3[N*N-1][N*N-1];
+	    static CAMGEN_THREAD_LOCAL value_type c1[N*N-1][N*N-1];
+	    static CAMGEN_THREAD_LOCAL value_type c2[N*N-1][N*N-1];
+	    static CAMGEN_THREAD_LOCAL value_type c3[N*N-1][N*N-1];
 
 	    /* Initialisation tag: */
 
@@ -585,9 +587,9 @@ namespace Camgen
     };	
     template<std::size_t N,class model_t>const std::size_t evaluate<compose_vertices<colour_tensor::ff_contr<SU<N>,0,1,2,3>,vvvv<model_t> > >::vector_size;
     template<std::size_t N,class model_t>const std::size_t evaluate<compose_vertices<colour_tensor::ff_contr<SU<N>,0,1,2,3>,vvvv<model_t> > >::gluon_size;
-    template<std::size_t N,class model_t>typename evaluate<compose_vertices<colour_tensor::ff_contr<SU<N>,0,1,2,3>,vvvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::ff_contr<SU<N>,0,1,2,3>,vvvv<model_t> > >::c1[N*N-1][N*N-1]={{0}};
-    template<std::size_t N,class model_t>typename evaluate<compose_vertices<colour_tensor::ff_contr<SU<N>,0,1,2,3>,vvvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::ff_contr<SU<N>,0,1,2,3>,vvvv<model_t> > >::c2[N*N-1][N*N-1]={{0}};
-    template<std::size_t N,class model_t>typename evaluate<compose_vertices<colour_tensor::ff_contr<SU<N>,0,1,2,3>,vvvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::ff_contr<SU<N>,0,1,2,3>,vvvv<model_t> > >::c3[N*N-1][N*N-1]={{0}};
+    template<std::size_t N,class model_t>CAMGEN_THREAD_LOCAL typename evaluate<compose_vertices<colour_tensor::ff_contr<SU<N>,0,1,2,3>,vvvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::ff_contr<SU<N>,0,1,2,3>,vvvv<model_t> > >::c1[N*N-1][N*N-1]={{0}};
+    template<std::size_t N,class model_t>CAMGEN_THREAD_LOCAL typename evaluate<compose_vertices<colour_tensor::ff_contr<SU<N>,0,1,2,3>,vvvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::ff_contr<SU<N>,0,1,2,3>,vvvv<model_t> > >::c2[N*N-1][N*N-1]={{0}};
+    template<std::size_t N,class model_t>CAMGEN_THREAD_LOCAL typename evaluate<compose_vertices<colour_tensor::ff_contr<SU<N>,0,1,2,3>,vvvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::ff_contr<SU<N>,0,1,2,3>,vvvv<model_t> > >::c3[N*N-1][N*N-1]={{0}};
     template<std::size_t N,class model_t>bool evaluate<compose_vertices<colour_tensor::ff_contr<SU<N>,0,1,2,3>,vvvv<model_t> > >::initialised=false;
 
     /* Specialisation of the 4-gluon vertex with the gluons in the colour-flow
@@ -1210,9 +1212,9 @@ namespace Camgen
 
 	    /* Inner product data holders: */
 
-	    static value_type c12[N][N];
-	    static value_type c13[N][N];
-	    static value_type c23[N][N];
+	    static CAMGEN_THREAD_LOCAL value_type c12[N][N];
+	    static CAMGEN_THREAD_LOCAL value_type c13[N][N];
+	    static CAMGEN_THREAD_LOCAL value_type c23[N][N];
 
 	    /* Initialisation tag: */
 
@@ -1221,9 +1223,9 @@ namespace Camgen
     template<std::size_t N,class model_t>const std::size_t evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::vector_size;
     template<std::size_t N,class model_t>const std::size_t evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::quark_size;
     template<std::size_t N,class model_t>const std::size_t evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::gluon_size;
-    template<std::size_t N,class model_t>typename evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::c12[N][N]={{0}};
-    template<std::size_t N,class model_t>typename evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::c13[N][N]={{0}};
-    template<std::size_t N,class model_t>typename evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::c23[N][N]={{0}};
+    template<std::size_t N,class model_t>CAMGEN_THREAD_LOCAL typename evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::c12[N][N]={{0}};
+    template<std::size_t N,class model_t>CAMGEN_THREAD_LOCAL typename evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::c13[N][N]={{0}};
+    template<std::size_t N,class model_t>CAMGEN_THREAD_LOCAL typename evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::value_type evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::c23[N][N]={{0}};
     template<std::size_t N,class model_t>bool evaluate<compose_vertices<colour_tensor::CF_ff_contr<N,0,1,2,3>,vvvv<model_t> > >::initialised=false;
 
     /* Specialisation of the cfd_evaluate class template for the gluon 4-vertex
@@ -0,0 +1,301 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+/*! \file gz_writer.h
+    \brief Parallel chunk-wise gzip compression of output streams.
+ */
+
+#ifndef CAMGEN_GZ_WRITER_H_
+#define CAMGEN_GZ_WRITER_H_
+
+#include <cstring>
+#include <ostream>
+#include <vector>
+#include <Camgen/mt_utils.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Compressed output writer. Every chunk of data handed to the writer is       *
+ * compressed into an independent gzip member; since a concatenation of gzip   *
+ * members is a valid gzip file, the output can be read by the standard tools. *
+ * The chunks are distributed round-robin over a pool of worker threads, and   *
+ * the compressed members are written to the output stream in submission order *
+ * by the thread handing in the data, so that compression runs concurrently    *
+ * with the production of the next chunks. Without thread support, every       *
+ * chunk is compressed and written immediately. The writer is only available   *
+ * if Camgen was configured with zlib.                                         *
+ *                                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+namespace Camgen
+{
+    class gzip_chunk_writer;
+}
+
+#if HAVE_ZLIB_H_
+#include <zlib.h>
+
+namespace Camgen
+{
+    /// Chunk-wise gzip output writer class.
+
+    class gzip_chunk_writer
+    {
+	public:
+
+	    /* Type definitions: */
+
+	    typedef std::size_t size_type;
+
+	    /// Constructor with the output stream, the compression level and
+	    /// the number of worker threads (by default the number of hardware
+	    /// threads).
+
+	    gzip_chunk_writer(std::ostream* os_,int level_=Z_DEFAULT_COMPRESSION,size_type n_workers=0):os(os_),level(level_),n_threads(0),n_submitted(0),n_written(0),stopping(0),finished(false)
+	    {
+		if(threads_enabled())
+		{
+		    n_threads=(n_workers==0)?hardware_threads():n_workers;
+		    for(size_type i=0;i<2*n_threads;++i)
+		    {
+			chunks.push_back(new chunk);
+		    }
+		    for(size_type i=0;i<n_threads;++i)
+		    {
+			workers.push_back(new worker(this,i));
+			workers.back()->thread.start(workers.back());
+		    }
+		}
+		else
+		{
+		    chunks.push_back(new chunk);
+		}
+	    }
+
+	    /// Destructor, writing the pending chunks.
+
+	    ~gzip_chunk_writer()
+	    {
+		finish();
+		for(size_type i=0;i<chunks.size();++i)
+		{
+		    delete chunks[i];
+		}
+	    }
+
+	    /// Hands the argument data to the writer as a new chunk. The
+	    /// argument is swapped with a previously used buffer, whose
+	    /// contents are unspecified. Returns false if the writer was
+	    /// finished or a compression or write error occurred.
+
+	    bool write(std::vector<char>& data)
+	    {
+		if(finished)
+		{
+		    return false;
+		}
+		if(data.empty())
+		{
+		    return os->good();
+		}
+		if(workers.empty())
+		{
+		    chunk* c=chunks[0];
+		    c->in.swap(data);
+		    compress(*c);
+		    c->in.swap(data);
+		    return write_chunk(*c);
+		}
+		bool result=true;
+		while(n_written+chunks.size()<=n_submitted)
+		{
+		    result&=write_next();
+		}
+		chunk* c=chunks[n_submitted%chunks.size()];
+		c->in.swap(data);
+		store_release(c->state,chunk_submitted);
+		++n_submitted;
+		while(n_written<n_submitted and load_acquire(chunks[n_written%chunks.size()]->state)==chunk_compressed)
+		{
+		    result&=write_next();
+		}
+		return result and os->good();
+	    }
+
+	    /// Waits for the pending chunks, writes them and stops the worker
+	    /// threads. No data can be written afterwards.
+
+	    bool finish()
+	    {
+		if(finished)
+		{
+		    return os->good();
+		}
+		bool result=true;
+		while(n_written<n_submitted)
+		{
+		    result&=write_next();
+		}
+		store_release(stopping,1);
+		for(size_type i=0;i<workers.size();++i)
+		{
+		    workers[i]->thread.join();
+		    delete workers[i];
+		}
+		workers.clear();
+		finished=true;
+		return result and os->good();
+	    }
+
+	    /// Returns the number of worker threads.
+
+	    size_type threads() const
+	    {
+		return n_threads;
+	    }
+
+	private:
+
+	    /* Chunk states: */
+
+	    enum chunk_state
+	    {
+		chunk_free,
+		chunk_submitted,
+		chunk_compressed
+	    };
+
+	    /* Chunk with uncompressed and compressed data: */
+
+	    struct chunk
+	    {
+		std::vector<char>in,out;
+		atomic_size_type state;
+		bool ok;
+
+		chunk():state(chunk_free),ok(true){}
+	    };
+
+	    /* Worker thread compressing the chunks with sequence numbers equal
+	     * to its index modulo the number of workers: */
+
+	    struct worker
+	    {
+		gzip_chunk_writer* writer;
+		size_type index;
+		background_thread thread;
+
+		worker(gzip_chunk_writer* writer_,size_type index_):writer(writer_),index(index_){}
+
+		void operator()()
+		{
+		    const std::vector<chunk*>& chunks=writer->chunks;
+		    for(size_type k=index;;k+=writer->n_threads)
+		    {
+			chunk* c=chunks[k%chunks.size()];
+			while(load_acquire(c->state)!=chunk_submitted)
+			{
+			    if(load_acquire(writer->stopping)!=0 and load_acquire(c->state)!=chunk_submitted)
+			    {
+				return;
+			    }
+			    pause_thread();
+			}
+			writer->compress(*c);
+			store_release(c->state,chunk_compressed);
+		    }
+		}
+	    };
+
+	    /* Output stream: */
+
+	    std::ostream* os;
+
+	    /* Compression level: */
+
+	    const int level;
+
+	    /* Chunk ring, twice as large as the worker pool: */
+
+	    std::vector<chunk*>chunks;
+
+	    /* Worker threads: */
+
+	    size_type n_threads;
+	    std::vector<worker*>workers;
+
+	    /* Numbers of submitted and written chunks: */
+
+	    size_type n_submitted,n_written;
+
+	    /* Stop request flag for the workers: */
+
+	    atomic_size_type stopping;
+
+	    /* Flag denoting whether the writer was finished: */
+
+	    bool finished;
+
+	    /* Compresses the input of the chunk into a single gzip member: */
+
+	    void compress(chunk& c) const
+	    {
+		z_stream zs;
+		std::memset(&zs,0,sizeof(z_stream));
+		c.ok=(deflateInit2(&zs,level,Z_DEFLATED,15+16,8,Z_DEFAULT_STRATEGY)==Z_OK);
+		if(!c.ok)
+		{
+		    c.out.clear();
+		    return;
+		}
+		c.out.resize(deflateBound(&zs,c.in.size()));
+		zs.next_in=reinterpret_cast<Bytef*>(&c.in[0]);
+		zs.avail_in=c.in.size();
+		zs.next_out=reinterpret_cast<Bytef*>(&c.out[0]);
+		zs.avail_out=c.out.size();
+		c.ok=(deflate(&zs,Z_FINISH)==Z_STREAM_END);
+		c.out.resize(zs.total_out);
+		deflateEnd(&zs);
+	    }
+
+	    /* Writes the compressed member of the chunk: */
+
+	    bool write_chunk(const chunk& c)
+	    {
+		if(!c.out.empty())
+		{
+		    os->write(&c.out[0],c.out.size());
+		}
+		return c.ok;
+	    }
+
+	    /* Waits for the oldest pending chunk, writes it and frees its
+	     * slot: */
+
+	    bool write_next()
+	    {
+		chunk* c=chunks[n_written%chunks.size()];
+		while(load_acquire(c->state)!=chunk_compressed)
+		{
+		    pause_thread();
+		}
+		bool result=write_chunk(*c);
+		store_release(c->state,chunk_free);
+		++n_written;
+		return result;
+	    }
+
+	    /* Non-copyable: */
+
+	    gzip_chunk_writer(const gzip_chunk_writer&);
+	    gzip_chunk_writer& operator = (const gzip_chunk_writer&);
+    };
+}
+
+#endif /*HAVE_ZLIB_H_*/
+
+#endif /*CAMGEN_GZ_WRITER_H_*/
+
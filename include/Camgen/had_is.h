@@ -209,6 +209,25 @@ namespace Camgen
 		xgen->adapt();
 	    }
 
+	    /* Statistics resetting method implementation: */
+
+	    void reset_statistics()
+	    {
+		xgen->reset_statistics();
+	    }
+
+	    /* Statistics merging method implementation: */
+
+	    bool merge_statistics(const initial_state<model_t,2>* other)
+	    {
+		const hadronic_is_xx<model_t,rng_t,Minkowski_type>* is=dynamic_cast<const hadronic_is_xx<model_t,rng_t,Minkowski_type>*>(other);
+		if(is==NULL)
+		{
+		    return false;
+		}
+		return xgen->merge_statistics(*(is->xgen));
+	    }
+
 	    /* Resets adaptive grids: */
 
 	    void reset()
@@ -683,6 +702,26 @@ namespace Camgen
 		y_gen->adapt();
 	    }
 
+	    /* Statistics resetting method implementation: */
+
+	    void reset_statistics()
+	    {
+		tau_gen->reset_statistics();
+		y_gen->reset_statistics();
+	    }
+
+	    /* Statistics merging method implementation: */
+
+	    bool merge_statistics(const initial_state<model_t,2>* other)
+	    {
+		const hadronic_is_sy<model_t,rng_t,Minkowski_type>* is=dynamic_cast<const hadronic_is_sy<model_t,rng_t,Minkowski_type>*>(other);
+		if(is==NULL)
+		{
+		    return false;
+		}
+		return tau_gen->merge_statistics(is->tau_gen) and y_gen->merge_statistics(is->y_gen);
+	    }
+
 	    /* Resets adaptive grids: */
 
 	    void reset()
@@ -1097,6 +1136,25 @@ namespace Camgen
 		y_gen->adapt();
 	    }
 
+	    /* Statistics resetting method implementation: */
+
+	    void reset_statistics()
+	    {
+		y_gen->reset_statistics();
+	    }
+
+	    /* Statistics merging method implementation: */
+
+	    bool merge_statistics(const initial_state<model_t,2>* other)
+	    {
+		const hadronic_is_y<model_t,rng_t,Minkowski_type>* is=dynamic_cast<const hadronic_is_y<model_t,rng_t,Minkowski_type>*>(other);
+		if(is==NULL)
+		{
+		    return false;
+		}
+		return y_gen->merge_statistics(is->y_gen);
+	    }
+
 	    /* Resets adaptive grids: */
 
 	    void reset()
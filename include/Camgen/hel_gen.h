@@ -172,7 +172,7 @@ namespace Camgen
 
 	    /// Writes derived class data to output stream (empty by default).
 
-	    std::ostream& save_data(std::ostream& os) const
+	    virtual std::ostream& save_data(std::ostream& os) const
 	    {
 		return os;
 	    }
@@ -422,7 +422,7 @@ namespace Camgen
 
 	    /// Writes derived class data to output stream (empty by default).
 
-	    std::ostream& save_data(std::ostream& os) const
+	    virtual std::ostream& save_data(std::ostream& os) const
 	    {
 		return os;
 	    }
@@ -17,6 +17,7 @@
 #include <Camgen/MC_config.h>
 #include <Camgen/uni_hels.h>
 #include <Camgen/long_hels.h>
+#include <Camgen/adapt_hels.h>
 
 namespace Camgen
 {
@@ -53,6 +54,8 @@ namespace Camgen
 			return longitudinal_helicities<value_type,N_in,N_out,rng_t,ch>::template create_instance<model_t>(it);
 		    case helicity_generators::summation:
 			return helicity_summer<value_type,N_in,N_out,ch>::template create_instance<model_t>(it);
+		    case helicity_generators::adaptive:
+			return adaptive_helicities<value_type,N_in,N_out,rng_t,ch>::template create_instance<model_t>(it);
 		    default:
 			return NULL;
 		}
@@ -89,6 +92,10 @@ namespace Camgen
 		{
 		    result=longitudinal_helicities<value_type,N_in,N_out,rng_t,ch>::template create_instance<model_t>(it);
 		}
+		else if(type=="adaptive")
+		{
+		    result=adaptive_helicities<value_type,N_in,N_out,rng_t,ch>::template create_instance<model_t>(it);
+		}
 		else
 		{
 		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"helicity generator type "<<type<<" not recognised"<<endlog;
@@ -266,6 +266,19 @@ namespace Camgen
 
 	    virtual void adapt_channels(){}
 
+	    /// Clears the statistics collected by the adaptive grids.
+
+	    virtual void reset_statistics(){}
+
+	    /// Adds the grid statistics collected by the argument, a copy of
+	    /// this generator, to the adaptive grids. Returns false if the
+	    /// generators are incompatible.
+
+	    virtual bool merge_statistics(const initial_state<model_t,N>* other)
+	    {
+		return true;
+	    }
+
 	    /// Overridden adaption method.
 
 	    void adapt()
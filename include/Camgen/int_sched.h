@@ -0,0 +1,290 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+#ifndef CAMGEN_INT_SCHED_H_
+#define CAMGEN_INT_SCHED_H_
+
+#include <Camgen/interaction.h>
+#include <Camgen/def_args.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Definition of the interaction schedule class template. A schedule is a        *
+ * compiled form of the interaction list of a process tree: every interaction is *
+ * lowered to an instruction in a contiguous array, holding the Feynman rule,    *
+ * the coupling vector, the Fermi sign factor, the momentum policy and offsets   *
+ * into flat arrays of operand tensor iterators, momentum addresses and incoming *
+ * current addresses. The interpreter loop evaluates the instructions in order,  *
+ * which yields the same results as the evaluation of the interaction list but   *
+ * avoids the traversal of the list nodes and the per-interaction vectors.       *
+ * Schedules refer to the current data of the tree they were compiled from, and  *
+ * have to be recompiled whenever the tree is rebuilt or relocated. In colour    *
+ * decomposition mode the operands of a Feynman rule depend on the propagating   *
+ * colours, and the schedule is not compiled.                                    *
+ *                                                                               *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+namespace Camgen
+{
+    /* Interaction schedule for models without colour flow decomposition: */
+
+    template<class model_t,std::size_t N>class interaction_schedule<model_t,N,false>
+    {
+	public:
+
+	    /* The usual type definitions: */
+
+	    DEFINE_BASIC_TYPES(model_t);
+
+	    /* Vertex and Feynman rule type definitions: */
+
+	    typedef typename get_basic_types<model_t>::vertex_type vertex_type;
+	    typedef typename get_basic_types<model_t>::vert_func vert_func;
+
+	    /* Current and interaction type definitions: */
+
+	    typedef current<model_t,N,false> current_type;
+	    typedef interaction<model_t,N,false> interaction_type;
+
+	    /* Constructor: */
+
+	    interaction_schedule():compiled(false){}
+
+	    /* Compiles the interactions in the range [first,last): */
+
+	    template<class iterator_t>void compile(iterator_t first,iterator_t last)
+	    {
+		clear();
+		size_type max_rank=0;
+		for(iterator_t it=first;it!=last;++it)
+		{
+		    const interaction_type& I=*it;
+		    instruction instr;
+		    instr.Feynman_rule=I.Feynman_rule;
+		    instr.vertex=I.vertex_t;
+		    instr.couplings=&(I.vertex_t->get_couplings());
+		    instr.factor=value_type(I.Fermi_sign,0);
+		    instr.produced=&(*(I.currents[I.produced_current]));
+		    instr.produced_momentum=I.produced_momentum;
+		    instr.rank=I.currents.size();
+		    instr.operands=operand_iters.size();
+		    instr.inputs=input_currents.size();
+		    instr.computes_momentum=I.prop_policy[0];
+		    instr.assigns_momentum=I.prop_policy[1];
+		    instr.propagates=I.prop_policy[2];
+		    for(size_type i=0;i<I.currents.size();++i)
+		    {
+			operand_iters.push_back(I.amp_iters[i]);
+			operand_momenta.push_back(I.momenta[i]);
+			if(i!=I.produced_current)
+			{
+			    input_currents.push_back(&(*(I.currents[i])));
+			}
+		    }
+		    max_rank=std::max(max_rank,instr.rank);
+		    instructions.push_back(instr);
+		}
+
+		/* Argument vectors handed to the Feynman rules, one per vertex
+		 * rank: */
+
+		iters.resize(max_rank+1);
+		momenta.resize(max_rank+1);
+		for(size_type n=0;n<=max_rank;++n)
+		{
+		    iters[n].resize(n);
+		    momenta[n].resize(n,NULL);
+		}
+		compiled=true;
+	    }
+
+	    /* Clears the schedule: */
+
+	    void clear()
+	    {
+		instructions.clear();
+		operand_iters.clear();
+		operand_momenta.clear();
+		input_currents.clear();
+		iters.clear();
+		momenta.clear();
+		compiled=false;
+	    }
+
+	    /* Returns whether the schedule has been compiled: */
+
+	    bool is_compiled() const
+	    {
+		return compiled;
+	    }
+
+	    /* Returns the number of instructions: */
+
+	    size_type size() const
+	    {
+		return instructions.size();
+	    }
+
+	    /* Interpreter loop, equivalent to calling evaluate() for all
+	     * compiled interactions: */
+
+	    void evaluate()
+	    {
+		typename std::vector<instruction>::const_iterator end=instructions.end();
+		for(typename std::vector<instruction>::const_iterator it=instructions.begin();it!=end;++it)
+		{
+		    execute(*it);
+		}
+	    }
+
+	    /* Evaluates the n-th instruction only: */
+
+	    void evaluate(size_type n)
+	    {
+		execute(instructions[n]);
+	    }
+
+	private:
+
+	    /* Instruction type, the compiled form of an interaction: */
+
+	    struct instruction
+	    {
+		vert_func Feynman_rule;
+		const vertex_type* vertex;
+		const std::vector<const value_type*>* couplings;
+		value_type factor;
+		current_type* produced;
+		const momentum_type* produced_momentum;
+		size_type rank;
+		size_type operands;
+		size_type inputs;
+		bool computes_momentum;
+		bool assigns_momentum;
+		bool propagates;
+	    };
+
+	    /* Instruction array: */
+
+	    std::vector<instruction>instructions;
+
+	    /* Operand tensor iterators and momentum addresses of all
+	     * instructions, rank entries per instruction: */
+
+	    std::vector<iterator>operand_iters;
+	    std::vector<const momentum_type*>operand_momenta;
+
+	    /* Incoming current addresses of all instructions, rank-1 entries
+	     * per instruction: */
+
+	    std::vector<current_type*>input_currents;
+
+	    /* Argument vectors passed to the Feynman rules: */
+
+	    std::vector< std::vector<iterator> >iters;
+	    std::vector< std::vector<const momentum_type*> >momenta;
+
+	    /* Compilation flag: */
+
+	    bool compiled;
+
+	    /* Evaluates a single instruction: */
+
+	    void execute(const instruction& I)
+	    {
+		current_type* const* in=input_currents.empty()?NULL:&input_currents[I.inputs];
+		size_type n_in=I.rank-1;
+		current_type* out=I.produced;
+
+		/* Produced momentum: */
+
+		if(I.computes_momentum)
+		{
+		    out->momentum.assign((r_value_type)0);
+		    for(size_type i=0;i<n_in;++i)
+		    {
+			out->momentum+=in[i]->momentum;
+		    }
+		}
+		else if(I.assigns_momentum)
+		{
+		    out->momentum=*(I.produced_momentum);
+		}
+
+		/* Coupling flag: */
+
+		bool coupled=I.vertex->is_coupled();
+		for(size_type i=0;i<n_in and coupled;++i)
+		{
+		    coupled=in[i]->coupled;
+		}
+		if(I.computes_momentum or I.assigns_momentum)
+		{
+		    out->coupled=coupled;
+		}
+		else
+		{
+		    out->coupled|=coupled;
+		}
+
+		/* Recursive relation: */
+
+		if(coupled)
+		{
+		    std::vector<iterator>& args=iters[I.rank];
+		    std::vector<const momentum_type*>& moms=momenta[I.rank];
+		    for(size_type i=0;i<I.rank;++i)
+		    {
+			args[i]=operand_iters[I.operands+i];
+			moms[i]=operand_momenta[I.operands+i];
+		    }
+		    I.Feynman_rule(I.factor,*(I.couplings),args,moms);
+		}
+
+		/* Propagation: */
+
+		if(I.propagates)
+		{
+		    out->propagate();
+		}
+	    }
+    };
+
+    /* Interaction schedule for models with colour flow decomposition, which
+     * is never compiled: */
+
+    template<class model_t,std::size_t N>class interaction_schedule<model_t,N,true>
+    {
+	public:
+
+	    /* The usual type definitions: */
+
+	    DEFINE_BASIC_TYPES(model_t);
+
+	    template<class iterator_t>void compile(iterator_t first,iterator_t last){}
+
+	    void clear(){}
+
+	    bool is_compiled() const
+	    {
+		return false;
+	    }
+
+	    size_type size() const
+	    {
+		return 0;
+	    }
+
+	    void evaluate(){}
+
+	    void evaluate(size_type n){}
+    };
+}
+
+#include <Camgen/undef_args.h>
+
+#endif /*CAMGEN_INT_SCHED_H_*/
+
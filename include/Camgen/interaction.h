@@ -9,6 +9,7 @@
 #define CAMGEN_INTERACTION_H_
 
 #include <Camgen/utils.h>
+#include <Camgen/mt_utils.h>
 #include <Camgen/curr_iter_comp.h>
 #include <Camgen/vertex.h>
 #include <Camgen/def_args.h>
@@ -71,6 +72,14 @@ namespace Camgen
 
 	    template<class mod,std::size_t N_in,std::size_t N_out>friend class process_tree;
 
+	    /* Friend declaration of the interaction schedule class template: */
+
+	    template<class mod,std::size_t M,bool decomp>friend class interaction_schedule;
+
+	    /* Friend declaration of the dof amplitude class template: */
+
+	    template<class mod,std::size_t N_in,std::size_t N_out,bool decomp>friend class dof_amplitudes;
+
 	    /* Trivial constructor: */
 
 	    interaction_base():vertex_t(NULL),produced_current(0),Feynman_rule(NULL),swap_fermions(false),Fermi_sign(1),flow(0),CM_tag(false),coupled(vertex_t->is_coupled()),produced_momentum(NULL)
@@ -88,7 +97,7 @@ namespace Camgen
 
 	    /* Copy constructor: */
 
-	    interaction_base(const interaction_base<model_t,N>& other):vertex_t(other.vertex_t),currents(other.currents),amp_iters(other.amp_iters),momenta(other.momenta),produced_current(other.produced_current),Feynman_rule(other.Feynman_rule),swap_fermions(false),Fermi_sign(other.Fermi_sign),flow(other.flow),CM_tag(other.CM_tag),coupled(other.coupled),prop_policy(other.prop_policy),produced_momentum(other.produced_momentum)
+	    interaction_base(const interaction_base<model_t,N>& other):vertex_t(other.vertex_t),currents(other.currents),amp_iters(other.amp_iters),momenta(other.momenta),produced_current(other.produced_current),Feynman_rule(other.Feynman_rule),swap_fermions(other.swap_fermions),Fermi_sign(other.Fermi_sign),flow(other.flow),CM_tag(other.CM_tag),coupled(other.coupled),prop_policy(other.prop_policy),produced_momentum(other.produced_momentum)
 	    {
 		++object_counter;
 	    }
@@ -367,6 +376,26 @@ namespace Camgen
 		}
 	    }
 
+	    /* Relocation of the interacting currents to a copy of the current
+	     * container starting at the second argument, where the first
+	     * argument denotes the beginning of the original container. The
+	     * produced momentum address is not relocated and should be
+	     * reassigned by the process tree: */
+
+	    void relocate(const_current_iterator from,current_iterator to)
+	    {
+		for(size_type i=0;i<currents.size();++i)
+		{
+		    currents[i]=to+(currents[i]-from);
+		    momenta[i]=&(currents[i]->momentum);
+		    amp_iters[i]=currents[i]->amplitude.begin();
+		}
+		if(swap_fermions)
+		{
+		    std::swap(amp_iters[1],amp_iters[2]);
+		}
+	    }
+
 	    /* Function computing the memory usage of all interaction objects
 	     * together in the program: */
 
@@ -480,33 +509,6 @@ namespace Camgen
 		return currents.end();
 	    }
 
-	    /* CM marking function: */
-
-	    void mark()
-	    {
-		CM_tag=true;
-		for(size_type i=0;i<currents.size();++i)
-		{
-		    currents[i]->mark();
-		}
-	    }
-
-	    /* Conditional reverse marking function: if the produced current is
-	     * marked, the incoming ones are: */
-
-	    void mark_if()
-	    {
-		CAMGEN_ERROR_IF((produced_current>=currents.size()),"produced current out of range");
-		if(currents[produced_current]->is_marked())
-		{
-		    CM_tag=true;
-		    for(size_type i=0;i<currents.size();++i)
-		    {
-			currents[i]->mark();
-		    }
-		}
-	    }
-
 	    /* Comparison operators: */
 
 	    bool operator == (const interaction_base<model_t,N>& other) const
@@ -517,13 +519,18 @@ namespace Camgen
 	    {
 		return !(this->operator==(other));
 	    }
+
+	    /* Interactions are ordered by their produced currents, which are
+	     * compared by momentum channel and flavour rather than by address,
+	     * so that the ordering does not depend on the current storage: */
+
 	    bool operator < (const interaction_base<model_t,N>& other) const
 	    {
 		if(this->get_produced_current()==other.get_produced_current())
 		{
 		    return std::lexicographical_compare(currents.begin(),currents.end(),other.currents.begin(),other.currents.end(),current_comparison);
 		}
-		return this->get_produced_current()<other.get_produced_current();
+		return *(this->get_produced_current())<*(other.get_produced_current());
 	    }
 	    bool operator > (const interaction_base<model_t,N>& other) const
 	    {
@@ -639,9 +646,9 @@ namespace Camgen
 	    const momentum_type* produced_momentum;
 
 	    /* Static integer counting the interaction objects created by
-	     * Camgen: */
+	     * Camgen. Trees may be constructed concurrently: */
 
-	    static std::size_t object_counter;
+	    static atomic_size_type object_counter;
 
 	    /* Static current iterator comparison object: */
 
@@ -660,7 +667,7 @@ namespace Camgen
 
     };
     template<class model_t,std::size_t N>const bool interaction_base<model_t,N>::decomposes;
-    template<class model_t,std::size_t N>std::size_t interaction_base<model_t,N>::object_counter=0;
+    template<class model_t,std::size_t N>atomic_size_type interaction_base<model_t,N>::object_counter(0);
     template<class model_t,std::size_t N>current_iter_comp<model_t,N> interaction_base<model_t,N>::current_comparison;
 
     /* Interaction subclass for models without colour flow decomposition: */
@@ -0,0 +1,113 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+#ifndef CAMGEN_ITER_SET_H_
+#define CAMGEN_ITER_SET_H_
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Declaration and definition of the iterator set class template. It provides   *
+ * the part of the std::set interface used to track the nonzero colour modes of  *
+ * colour-decomposed currents, but stores the iterators in a sorted contiguous   *
+ * array. Insertions are binary searches followed by (in practice short) shifts, *
+ * and clearing keeps the allocated storage, so that once a current has seen its *
+ * maximal number of propagating modes, no further heap allocations occur.       *
+ *                                                                               *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+namespace Camgen
+{
+    template<class T>class iterator_set
+    {
+	public:
+
+	    /* Type definitions: */
+
+	    typedef T value_type;
+	    typedef T key_type;
+	    typedef std::size_t size_type;
+	    typedef typename std::vector<T>::iterator iterator;
+	    typedef typename std::vector<T>::const_iterator const_iterator;
+
+	    /* Inserts the argument, if not present yet. Returns the position
+	     * of the element and whether it was inserted: */
+
+	    std::pair<iterator,bool> insert(const T& x)
+	    {
+		if(elements.empty() or elements.back()<x)
+		{
+		    elements.push_back(x);
+		    return std::pair<iterator,bool>(elements.end()-1,true);
+		}
+		iterator it=std::lower_bound(elements.begin(),elements.end(),x);
+		if(!(x<*it))
+		{
+		    return std::pair<iterator,bool>(it,false);
+		}
+		return std::pair<iterator,bool>(elements.insert(it,x),true);
+	    }
+
+	    /* Removes all elements, keeping the storage: */
+
+	    void clear()
+	    {
+		elements.clear();
+	    }
+
+	    /* Returns the number of elements: */
+
+	    size_type size() const
+	    {
+		return elements.size();
+	    }
+
+	    /* Returns whether the set is empty: */
+
+	    bool empty() const
+	    {
+		return elements.empty();
+	    }
+
+	    /* Returns the number of occurrences of the argument: */
+
+	    size_type count(const T& x) const
+	    {
+		return std::binary_search(elements.begin(),elements.end(),x)?1:0;
+	    }
+
+	    /* Iterators in increasing order: */
+
+	    iterator begin()
+	    {
+		return elements.begin();
+	    }
+	    iterator end()
+	    {
+		return elements.end();
+	    }
+	    const_iterator begin() const
+	    {
+		return elements.begin();
+	    }
+	    const_iterator end() const
+	    {
+		return elements.end();
+	    }
+
+	private:
+
+	    /* Sorted element array: */
+
+	    std::vector<T>elements;
+    };
+}
+
+#endif /*CAMGEN_ITER_SET_H_*/
+
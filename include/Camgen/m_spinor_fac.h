@@ -9,6 +9,7 @@
 #define CAMGEN_M_SPINOR_FAC_H_
 
 #include <Camgen/spinor_fac.h>
+#include <Camgen/mt_utils.h>
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * Massive spinor factory class template declaration and definition. The       *
@@ -432,16 +433,16 @@ namespace Camgen
 	    
 	    /* temporary spin vector: */
 
-	    static momentum_type s;
+	    static CAMGEN_THREAD_LOCAL momentum_type s;
 	    
 	    /* Temporary spinors: */
 	    
-	    static tensor_type temp;
-	    static tensor_type temp2;
+	    static CAMGEN_THREAD_LOCAL tensor_type temp;
+	    static CAMGEN_THREAD_LOCAL tensor_type temp2;
     };
-    template<class Dirac_alg_t,class spin_vec_t,int beam_dir>typename massive_spinor_factory<Dirac_alg_t,spin_vec_t,beam_dir,4>::momentum_type massive_spinor_factory<Dirac_alg_t,spin_vec_t,beam_dir,4>::s;
-    template<class Dirac_alg_t,class spin_vec_t,int beam_dir>typename massive_spinor_factory<Dirac_alg_t,spin_vec_t,beam_dir,4>::tensor_type massive_spinor_factory<Dirac_alg_t,spin_vec_t,beam_dir,4>::temp(1,4);
-    template<class Dirac_alg_t,class spin_vec_t,int beam_dir>typename massive_spinor_factory<Dirac_alg_t,spin_vec_t,beam_dir,4>::tensor_type massive_spinor_factory<Dirac_alg_t,spin_vec_t,beam_dir,4>::temp2(1,4);
+    template<class Dirac_alg_t,class spin_vec_t,int beam_dir>CAMGEN_THREAD_LOCAL typename massive_spinor_factory<Dirac_alg_t,spin_vec_t,beam_dir,4>::momentum_type massive_spinor_factory<Dirac_alg_t,spin_vec_t,beam_dir,4>::s;
+    template<class Dirac_alg_t,class spin_vec_t,int beam_dir>CAMGEN_THREAD_LOCAL typename massive_spinor_factory<Dirac_alg_t,spin_vec_t,beam_dir,4>::tensor_type massive_spinor_factory<Dirac_alg_t,spin_vec_t,beam_dir,4>::temp(1,4);
+    template<class Dirac_alg_t,class spin_vec_t,int beam_dir>CAMGEN_THREAD_LOCAL typename massive_spinor_factory<Dirac_alg_t,spin_vec_t,beam_dir,4>::tensor_type massive_spinor_factory<Dirac_alg_t,spin_vec_t,beam_dir,4>::temp2(1,4);
 }
 
 /* Specialisations in the case of the Pauli and Weyl bases combined with standard spin
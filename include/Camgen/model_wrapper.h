@@ -18,6 +18,7 @@
 #include <Camgen/has_leg.h>
 #include <Camgen/fusion_cont.h>
 #include <Camgen/type_holders.h>
+#include <Camgen/bin_io.h>
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * Model wrapper class definition. The model wrapper contains static lists of    *
@@ -217,6 +218,48 @@ namespace Camgen
 		return particle_content.size();
 	    }
 
+	    /* Number of vertices: */
+
+	    static size_type vertices()
+	    {
+		return vertex_content.size();
+	    }
+
+	    /* i-th vertex readout: */
+
+	    static const vertex_type* get_vertex(size_type i)
+	    {
+		CAMGEN_ERROR_IF((i>=vertex_content.size()),"vertex request out of range");
+		return vertex_content[i];
+	    }
+
+	    /* Hash of the model structure: the particle names, identifiers and
+	     * couplings, and the vertex Feynman rules, legs and couplings.
+	     * Vertex trees constructed with models of different hashes
+	     * generally differ: */
+
+	    static long long unsigned structure_hash()
+	    {
+		binary_hash h;
+		h.add(particle_content.size());
+		for(size_type i=0;i<particle_content.size();++i)
+		{
+		    const particle_type* phi=particle_content[i];
+		    h.add(phi->get_name()).add(phi->get_pdg_id()).add(phi->is_coupled());
+		}
+		h.add(vertex_content.size());
+		for(size_type i=0;i<vertex_content.size();++i)
+		{
+		    const vertex_type* v=vertex_content[i];
+		    h.add(v->get_name()).add(v->get_Feynman_rule()).add(v->is_coupled());
+		    for(size_type j=0;j<v->get_rank();++j)
+		    {
+			h.add(v->get_leg(j)->get_flavour());
+		    }
+		}
+		return h.value();
+	    }
+
 	    /* Particle fusion finder function: */
 
 	    static std::pair<fusion_iterator,fusion_iterator>find_fusion(const std::vector<const particle_type*>& parts)
@@ -693,7 +736,7 @@ namespace Camgen
 		particle_type* phi=get_private_particle(str);
 		if(phi!=NULL)
 		{
-		    phi->set_propagator<prop_t>();
+		    phi->template set_propagator<prop_t>();
 		}
 	    }
 
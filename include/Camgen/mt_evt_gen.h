@@ -0,0 +1,571 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+/*! \file mt_evt_gen.h
+    \brief Multithreaded driver for the multi-process event generator.
+ */
+
+#ifndef CAMGEN_MT_EVT_GEN_H_
+#define CAMGEN_MT_EVT_GEN_H_
+
+#include <map>
+#include <sstream>
+#include <Camgen/mt_utils.h>
+#include <Camgen/evt_gen.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Parallel driver for the event generator. The driver clones the argument event *
+ * generator into a number of workers, each owning an instance-local copy of the *
+ * CM algorithm. The requested events are divided into chunks, which are picked  *
+ * up by the first idle worker. Chunk c draws its random numbers from substream  *
+ * offset+c, and the cross section statistics of the chunks are merged into the  *
+ * original generator in chunk order, so the results do not depend on the       *
+ * number of threads nor on their scheduling. The grids and channel weights of   *
+ * the workers are frozen during a run; call synchronise() after adapting the    *
+ * original generator. Running couplings are stored in the model class and are  *
+ * therefore shared by all workers. Since the calling thread runs one of the     *
+ * workers, its random number engine is left at one of the substreams.          *
+ *                                                                               *
+ * The initialisation divides every adaptation batch over the workers, each     *
+ * drawing from its own substream. The grid and multichannel statistics of the  *
+ * workers are merged into the original generator, which performs a single      *
+ * adaptation step and broadcasts the result to the workers. The adapted grids  *
+ * depend on the number of threads, but not on their scheduling.                *
+ *                                                                               *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+namespace Camgen
+{
+    /// Multithreaded event generation driver.
+
+    template<class model_t,std::size_t N_in,std::size_t N_out,class rng_t>class parallel_event_generator
+    {
+	public:
+
+	    /* Type definitions: */
+
+	    typedef model_t model_type;
+	    typedef typename model_t::value_type value_type;
+	    typedef std::size_t size_type;
+	    typedef rng_t rn_engine;
+	    typedef random_number_stream<value_type,rng_t> rn_stream;
+	    typedef CM_algorithm<model_t,N_in,N_out> algorithm_type;
+	    typedef event_generator<model_t,N_in,N_out,rng_t> event_generator_type;
+	    typedef typename event_generator_type::process_generator_type process_generator_type;
+	    typedef MC_weight_sums<value_type> weight_sums_type;
+
+	    /* Public constructors: */
+	    /*----------------------*/
+
+	    /// Constructor with the event generator, its algorithm, the number
+	    /// of worker threads (if 0, the number of hardware threads is
+	    /// taken) and the number of events per chunk.
+
+	    parallel_event_generator(event_generator_type& gen_,algorithm_type& algo,size_type n_threads=0,size_type chunk=1000):gen(gen_),chunk_size(std::max(chunk,(size_type)1)),stream_offset(1),n_chunks(0),next_chunk(0),n_run(0),n_evts(0),unweighted(false)
+	    {
+		if(n_threads==0)
+		{
+		    n_threads=hardware_threads();
+		}
+		for(size_type i=0;i<n_threads;++i)
+		{
+		    algos.push_back(new algorithm_type(algo));
+		}
+		workers.resize(n_threads,NULL);
+		synchronise();
+	    }
+
+	    /// Destructor.
+
+	    ~parallel_event_generator()
+	    {
+		for(size_type i=0;i<workers.size();++i)
+		{
+		    if(workers[i]!=NULL)
+		    {
+			delete workers[i];
+		    }
+		    delete algos[i];
+		}
+	    }
+
+	    /* Public modifiers: */
+	    /*-------------------*/
+
+	    /// Copies the grids, channel weights and cross sections of the
+	    /// original generator to the workers.
+
+	    bool synchronise()
+	    {
+		std::stringstream ss;
+		gen.save(ss);
+		std::string state=ss.str();
+		bool q=true;
+		for(size_type i=0;i<workers.size();++i)
+		{
+		    if(workers[i]!=NULL)
+		    {
+			delete workers[i];
+		    }
+		    std::istringstream is(state);
+		    workers[i]=event_generator_type::read(*algos[i],is);
+		    if(workers[i]==NULL)
+		    {
+			log(log_level::warning)<<CAMGEN_STREAMLOC<<"failed to clone event generator for worker "<<i<<endlog;
+			q=false;
+			continue;
+		    }
+		    workers[i]->set_auto_update(false);
+		    workers[i]->reset_statistics();
+		    for(size_type j=0;j<workers[i]->processes();++j)
+		    {
+			workers[i]->process(j)->unset_auto_grid_adapt();
+			workers[i]->process(j)->unset_auto_channel_adapt();
+		    }
+		}
+		slots.clear();
+		ids.clear();
+		hist_bins.clear();
+		for(size_type i=0;i<gen.processes();++i)
+		{
+		    size_type id=gen.process_id(i);
+		    slots[id]=ids.size();
+		    ids.push_back(id);
+		    const weight_histogrammer<value_type>* h=gen.process(i)->weight_histogram();
+		    hist_bins.push_back((h==NULL)?0:(h->bins()));
+		}
+		return q;
+	    }
+
+	    /// Initialises the original generator with the numbers of channel
+	    /// and grid iterations, batch sizes and subprocess events defined in
+	    /// the static configuration.
+
+	    void initialise(bool verbose=false)
+	    {
+		initialise(init_channel_iterations(),init_channel_batch(),init_grid_iterations(),init_grid_batch(),subprocess_events(),verbose);
+	    }
+
+	    /// Initialises the original generator with channel_iters multichannel
+	    /// iterations of batch size channel_batch, grid_iters grid
+	    /// adaptations of batch size grid_batch and a cross section estimate
+	    /// of sub_proc_evts events per subprocess. All batches are divided
+	    /// over the worker threads.
+
+	    void initialise(size_type channel_iters,size_type channel_batch,size_type grid_iters,size_type grid_batch,size_type sub_proc_evts,bool verbose=false)
+	    {
+		if(!synchronise())
+		{
+		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"invalid worker generator encountered--no initialisation performed"<<endlog;
+		    return;
+		}
+		for(size_type p=0;p<gen.processes();++p)
+		{
+		    if(verbose)
+		    {
+			std::stringstream ss;
+			gen.process(p)->print_process(ss);
+			std::cout<<std::endl<<"init subprocess "<<ss.str()<<std::endl;
+		    }
+		    if(!gen.process(p)->zero_matrix_element())
+		    {
+			if(verbose)
+			{
+			    std::cout<<"adapting ps channels...";
+			    std::cout.flush();
+			}
+			for(size_type i=0;i<channel_iters;++i)
+			{
+			    run_batch(p,channel_batch,false);
+			    gen.process(p)->adapt_channels();
+			    synchronise();
+			}
+			if(verbose)
+			{
+			    std::cout<<"done"<<std::endl;
+			    std::cout<<"adapting grids...";
+			    std::cout.flush();
+			}
+			for(size_type i=0;i<grid_iters;++i)
+			{
+			    run_batch(p,grid_batch,false);
+			    gen.process(p)->adapt_grids();
+			    synchronise();
+			}
+			if(verbose)
+			{
+			    std::cout<<"done"<<std::endl;
+			}
+		    }
+		    if(verbose)
+		    {
+			std::cout<<"estimating xsec...";
+			std::cout.flush();
+		    }
+		    run_batch(p,sub_proc_evts,true);
+		    synchronise();
+		    if(verbose)
+		    {
+			std::cout<<"done"<<std::endl;
+		    }
+		}
+		gen.refresh_cross_section();
+		gen.adapt_processes();
+		synchronise();
+	    }
+
+	    /// Sets the random number substream of the first chunk (default 1).
+	    /// Successive runs continue with the subsequent substreams.
+
+	    void set_stream_offset(size_type n)
+	    {
+		stream_offset=n;
+	    }
+
+	    /// Generates n weighted events, merging the cross section statistics
+	    /// into the original generator.
+
+	    void generate(size_type n)
+	    {
+		run<null_sink>(n,NULL,false);
+	    }
+
+	    /// Generates n weighted events, passing every event to the argument
+	    /// sink. The sink is invoked as sink(gen), where gen is the worker
+	    /// event generator, one event at a time.
+
+	    template<class sink_t>void generate(size_type n,sink_t& sink)
+	    {
+		run(n,&sink,false);
+	    }
+
+	    /// Generates n unweighted events, passing every event to the
+	    /// argument sink. The cross sections are not updated.
+
+	    template<class sink_t>void generate_unweighted(size_type n,sink_t& sink)
+	    {
+		run(n,&sink,true);
+	    }
+
+	    /* Public readout methods: */
+	    /*-------------------------*/
+
+	    /// Returns the number of worker threads.
+
+	    size_type threads() const
+	    {
+		return workers.size();
+	    }
+
+	    /// Returns the chunk size.
+
+	    size_type chunk() const
+	    {
+		return chunk_size;
+	    }
+
+	    /// Returns the total number of events generated by the driver.
+
+	    size_type events() const
+	    {
+		return n_evts;
+	    }
+
+	    /// Returns the i-th worker event generator.
+
+	    event_generator_type* worker(size_type i)
+	    {
+		return workers[i];
+	    }
+
+	    /// Returns the i-th worker event generator.
+
+	    const event_generator_type* worker(size_type i) const
+	    {
+		return workers[i];
+	    }
+
+	private:
+
+	    /* Trivial event sink: */
+
+	    struct null_sink
+	    {
+		void operator()(event_generator_type&){}
+	    };
+
+	    /* Worker job class: */
+
+	    template<class sink_t>class worker_job
+	    {
+		public:
+
+		    worker_job(parallel_event_generator<model_t,N_in,N_out,rng_t>* driver_,size_type n_,sink_t* sink_):driver(driver_),n(n_),sink(sink_){}
+
+		    void operator()()
+		    {
+			driver->process_chunks(n,sink);
+		    }
+
+		private:
+
+		    parallel_event_generator<model_t,N_in,N_out,rng_t>* driver;
+		    size_type n;
+		    sink_t* sink;
+	    };
+
+	    /* Worker job class for the initialisation batches: */
+
+	    class batch_job
+	    {
+		public:
+
+		    batch_job(parallel_event_generator<model_t,N_in,N_out,rng_t>* driver_,size_type n_,size_type proc_,size_type evts_,bool estimate_):driver(driver_),n(n_),proc(proc_),evts(evts_),estimate(estimate_){}
+
+		    void operator()()
+		    {
+			driver->process_batch(n,proc,evts,estimate);
+		    }
+
+		private:
+
+		    parallel_event_generator<model_t,N_in,N_out,rng_t>* driver;
+		    size_type n,proc,evts;
+		    bool estimate;
+	    };
+
+	    /* Original event generator: */
+
+	    event_generator_type& gen;
+
+	    /* Instance-local algorithms of the workers: */
+
+	    std::vector<algorithm_type*>algos;
+
+	    /* Worker event generators: */
+
+	    std::vector<event_generator_type*>workers;
+
+	    /* Number of events per chunk: */
+
+	    size_type chunk_size;
+
+	    /* Random number substream of the next chunk: */
+
+	    size_type stream_offset;
+
+	    /* Number of chunks in the current run and next chunk to process: */
+
+	    size_type n_chunks,next_chunk;
+
+	    /* Number of events in the current run: */
+
+	    size_type n_run;
+
+	    /* Total number of generated events: */
+
+	    size_type n_evts;
+
+	    /* Unweighted generation flag: */
+
+	    bool unweighted;
+
+	    /* Map from process id to weight sum slot and its inverse: */
+
+	    std::map<size_type,size_type>slots;
+	    std::vector<size_type>ids;
+
+	    /* Weight histogram bins per subprocess (0 if none): */
+
+	    std::vector<size_type>hist_bins;
+
+	    /* Weight sums per chunk and subprocess: */
+
+	    std::vector< std::vector<weight_sums_type> >results;
+
+	    /* Weight sums per worker during the initialisation: */
+
+	    std::vector<weight_sums_type>batch_results;
+
+	    /* Locks for the chunk queue and the event sink: */
+
+	    mutex queue_mutex,sink_mutex;
+
+	    /* Parallel run implementation: */
+
+	    template<class sink_t>void run(size_type n,sink_t* sink,bool unweighted_)
+	    {
+		for(size_type i=0;i<workers.size();++i)
+		{
+		    if(workers[i]==NULL)
+		    {
+			log(log_level::warning)<<CAMGEN_STREAMLOC<<"invalid worker generator encountered--no events generated"<<endlog;
+			return;
+		    }
+		}
+		if(n==0 or workers.size()==0)
+		{
+		    return;
+		}
+		unweighted=unweighted_;
+		n_run=n;
+		n_chunks=(n+chunk_size-1)/chunk_size;
+		next_chunk=0;
+		results.assign(n_chunks,std::vector<weight_sums_type>(ids.size()));
+		if(!unweighted)
+		{
+		    for(size_type c=0;c<n_chunks;++c)
+		    {
+			for(size_type i=0;i<ids.size();++i)
+			{
+			    if(hist_bins[i]!=0)
+			    {
+				results[c][i].bin_weights(hist_bins[i]);
+			    }
+			}
+		    }
+		}
+		std::vector<worker_job<sink_t>*>jobs(workers.size());
+		for(size_type i=0;i<workers.size();++i)
+		{
+		    jobs[i]=new worker_job<sink_t>(this,i,sink);
+		}
+		run_parallel(jobs);
+		for(size_type i=0;i<jobs.size();++i)
+		{
+		    delete jobs[i];
+		}
+		if(!unweighted)
+		{
+		    for(size_type c=0;c<n_chunks;++c)
+		    {
+			for(size_type i=0;i<ids.size();++i)
+			{
+			    gen.add_process_weight_sums(ids[i],results[c][i]);
+			}
+		    }
+		    gen.refresh_cross_section();
+		}
+		results.clear();
+		stream_offset+=n_chunks;
+		n_evts+=n;
+	    }
+
+	    /* Divides n events of the p-th subprocess over the workers and merges
+	     * the collected grid statistics into the original generator. If
+	     * estimate is true, the events are added to the cross section too: */
+
+	    void run_batch(size_type p,size_type n,bool estimate)
+	    {
+		if(n==0 or workers.size()==0)
+		{
+		    return;
+		}
+		batch_results.assign(workers.size(),weight_sums_type());
+		if(estimate and hist_bins[p]!=0)
+		{
+		    for(size_type i=0;i<workers.size();++i)
+		    {
+			batch_results[i].bin_weights(hist_bins[p]);
+		    }
+		}
+		std::vector<batch_job*>jobs(workers.size());
+		for(size_type i=0;i<workers.size();++i)
+		{
+		    size_type evts=n/workers.size()+((i<n%workers.size())?1:0);
+		    jobs[i]=new batch_job(this,i,p,evts,estimate);
+		}
+		run_parallel(jobs);
+		for(size_type i=0;i<jobs.size();++i)
+		{
+		    delete jobs[i];
+		}
+		for(size_type i=0;i<workers.size();++i)
+		{
+		    if(!gen.process(p)->merge_statistics(*(workers[i]->process(p))))
+		    {
+			log(log_level::warning)<<CAMGEN_STREAMLOC<<"failed to merge grid statistics of worker "<<i<<endlog;
+		    }
+		    if(estimate)
+		    {
+			gen.add_process_weight_sums(ids[p],batch_results[i]);
+		    }
+		}
+		batch_results.clear();
+		stream_offset+=workers.size();
+	    }
+
+	    /* Worker initialisation batch: */
+
+	    void process_batch(size_type n,size_type p,size_type evts,bool estimate)
+	    {
+		rn_stream::set_stream(stream_offset+n);
+		process_generator_type* g=workers[n]->process(p);
+		if(!estimate)
+		{
+		    g->collect_statistics(evts);
+		    return;
+		}
+		for(size_type i=0;i<evts;++i)
+		{
+		    g->generate();
+		    g->update();
+		    if(MC_generator<value_type>::valid(g->weight()) and MC_generator<value_type>::valid(g->integrand()))
+		    {
+			batch_results[n].insert(g->weight()*g->integrand());
+		    }
+		}
+	    }
+
+	    /* Worker loop, processing chunks until the queue is empty: */
+
+	    template<class sink_t>void process_chunks(size_type n,sink_t* sink)
+	    {
+		event_generator_type* g=workers[n];
+		while(true)
+		{
+		    size_type c;
+		    {
+			scoped_lock lock(queue_mutex);
+			if(next_chunk==n_chunks)
+			{
+			    return;
+			}
+			c=next_chunk;
+			++next_chunk;
+		    }
+		    rn_stream::set_stream(stream_offset+c);
+		    size_type n_evts_chunk=(c+1==n_chunks)?(n_run-c*chunk_size):chunk_size;
+		    std::vector<weight_sums_type>& sums=results[c];
+		    for(size_type i=0;i<n_evts_chunk;++i)
+		    {
+			if(unweighted)
+			{
+			    g->generate_unweighted();
+			}
+			else
+			{
+			    g->generate();
+			    const process_generator_type* p=g->process();
+			    if(MC_generator<value_type>::valid(p->weight()) and MC_generator<value_type>::valid(p->integrand()))
+			    {
+				sums[slots.find(p->id)->second].insert(p->weight()*p->integrand());
+			    }
+			}
+			if(sink!=NULL)
+			{
+			    scoped_lock lock(sink_mutex);
+			    (*sink)(*g);
+			}
+		    }
+		}
+	    }
+    };
+}
+
+#endif /*CAMGEN_MT_EVT_GEN_H_*/
+
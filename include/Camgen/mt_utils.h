@@ -0,0 +1,286 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+/*! \file mt_utils.h
+    \brief Multithreading utilities.
+ */
+
+#ifndef CAMGEN_MT_UTILS_H_
+#define CAMGEN_MT_UTILS_H_
+
+#include <cstddef>
+#include <ctime>
+#include <vector>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Minimal multithreading layer of Camgen. If the library is compiled with a     *
+ * C++11 compiler, the standard thread library is used and the scratch data of   *
+ * the recursive relations is declared thread-local. Otherwise, all parallel     *
+ * sections fall back to serial execution on the calling thread, so that code    *
+ * using these utilities yields identical results in both configurations.        *
+ *                                                                               *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#if __cplusplus>=201103L
+#define CAMGEN_HAVE_THREADS 1
+#define CAMGEN_THREAD_LOCAL thread_local
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#else
+#define CAMGEN_THREAD_LOCAL
+#endif
+
+namespace Camgen
+{
+    /// Counter type that may be updated concurrently. Reduces to a plain
+    /// integer when Camgen is built without thread support.
+
+#ifdef CAMGEN_HAVE_THREADS
+    typedef std::atomic<std::size_t> atomic_size_type;
+#else
+    typedef std::size_t atomic_size_type;
+#endif
+
+    /// Mutual exclusion lock. Trivial when Camgen is built without thread
+    /// support.
+
+    class mutex
+    {
+	public:
+
+	    /// Constructor.
+
+	    mutex(){}
+
+	    /// Acquires the lock.
+
+	    void lock()
+	    {
+#ifdef CAMGEN_HAVE_THREADS
+		m.lock();
+#endif
+	    }
+
+	    /// Releases the lock.
+
+	    void unlock()
+	    {
+#ifdef CAMGEN_HAVE_THREADS
+		m.unlock();
+#endif
+	    }
+
+	private:
+
+#ifdef CAMGEN_HAVE_THREADS
+	    std::mutex m;
+#endif
+	    /* Non-copyable: */
+
+	    mutex(const mutex&);
+	    mutex& operator = (const mutex&);
+    };
+
+    /// Scope-bound lock on a mutex.
+
+    class scoped_lock
+    {
+	public:
+
+	    /// Constructor, acquiring the argument lock.
+
+	    scoped_lock(mutex& m_):m(m_)
+	    {
+		m.lock();
+	    }
+
+	    /// Destructor, releasing the lock.
+
+	    ~scoped_lock()
+	    {
+		m.unlock();
+	    }
+
+	private:
+
+	    mutex& m;
+
+	    /* Non-copyable: */
+
+	    scoped_lock(const scoped_lock&);
+	    scoped_lock& operator = (const scoped_lock&);
+    };
+
+    /// Returns the number of concurrent threads supported by the hardware (1
+    /// if unknown or if threads are not supported).
+
+    inline std::size_t hardware_threads()
+    {
+#ifdef CAMGEN_HAVE_THREADS
+	std::size_t n=std::thread::hardware_concurrency();
+	return (n==0)?1:n;
+#else
+	return 1;
+#endif
+    }
+
+    /// Returns whether Camgen was compiled with thread support.
+
+    inline bool threads_enabled()
+    {
+#ifdef CAMGEN_HAVE_THREADS
+	return true;
+#else
+	return false;
+#endif
+    }
+
+    /// Returns the elapsed wall-clock time in seconds with respect to an
+    /// arbitrary reference point. Without thread support, the processor
+    /// time is returned instead.
+
+    inline double wall_clock()
+    {
+#ifdef CAMGEN_HAVE_THREADS
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+	return (double)std::clock()/(double)CLOCKS_PER_SEC;
+#endif
+    }
+
+    /// Atomically loads the counter, with acquire semantics.
+
+    inline std::size_t load_acquire(const atomic_size_type& n)
+    {
+#ifdef CAMGEN_HAVE_THREADS
+	return n.load(std::memory_order_acquire);
+#else
+	return n;
+#endif
+    }
+
+    /// Atomically stores the value in the counter, with release semantics.
+
+    inline void store_release(atomic_size_type& n,std::size_t m)
+    {
+#ifdef CAMGEN_HAVE_THREADS
+	n.store(m,std::memory_order_release);
+#else
+	n=m;
+#endif
+    }
+
+    /// Suspends the calling thread for a short while, to be used in loops
+    /// waiting for another thread. Does nothing without thread support.
+
+    inline void pause_thread()
+    {
+#ifdef CAMGEN_HAVE_THREADS
+	std::this_thread::sleep_for(std::chrono::microseconds(50));
+#endif
+    }
+
+    /* Helper invoking the call operator of a job pointer: */
+
+    template<class job_t>void run_job(job_t* job)
+    {
+	(*job)();
+    }
+
+    /// Thread running the call operator of a job in the background until it
+    /// is joined. Without thread support, no thread can be started.
+
+    class background_thread
+    {
+	public:
+
+	    /// Constructor.
+
+	    background_thread(){}
+
+	    /// Destructor, joining the thread.
+
+	    ~background_thread()
+	    {
+		join();
+	    }
+
+	    /// Starts the call operator of the argument job in a new thread.
+	    /// Returns false if a thread is already running or if Camgen is
+	    /// built without thread support.
+
+	    template<class job_t>bool start(job_t* job)
+	    {
+#ifdef CAMGEN_HAVE_THREADS
+		if(t.joinable())
+		{
+		    return false;
+		}
+		t=std::thread(run_job<job_t>,job);
+		return true;
+#else
+		return false;
+#endif
+	    }
+
+	    /// Waits for the thread to finish.
+
+	    void join()
+	    {
+#ifdef CAMGEN_HAVE_THREADS
+		if(t.joinable())
+		{
+		    t.join();
+		}
+#endif
+	    }
+
+	private:
+
+#ifdef CAMGEN_HAVE_THREADS
+	    std::thread t;
+#endif
+	    /* Non-copyable: */
+
+	    background_thread(const background_thread&);
+	    background_thread& operator = (const background_thread&);
+    };
+
+    /// Runs the call operators of the argument jobs concurrently, one thread
+    /// per job, and returns when all of them have finished. Without thread
+    /// support, the jobs are run one after the other in order.
+
+    template<class job_t>void run_parallel(const std::vector<job_t*>& jobs)
+    {
+#ifdef CAMGEN_HAVE_THREADS
+	if(jobs.size()>1)
+	{
+	    std::vector<std::thread>threads;
+	    threads.reserve(jobs.size()-1);
+	    for(std::size_t i=1;i<jobs.size();++i)
+	    {
+		threads.push_back(std::thread(run_job<job_t>,jobs[i]));
+	    }
+	    run_job(jobs[0]);
+	    for(std::size_t i=0;i<threads.size();++i)
+	    {
+		threads[i].join();
+	    }
+	    return;
+	}
+#endif
+	for(std::size_t i=0;i<jobs.size();++i)
+	{
+	    run_job(jobs[i]);
+	}
+    }
+}
+
+#endif /*CAMGEN_MT_UTILS_H_*/
+
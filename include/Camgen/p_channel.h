@@ -23,6 +23,7 @@
 #include <Camgen/particle.h>
 #include <Camgen/flav_comp.h>
 #include <Camgen/MC_config.h>
+#include <Camgen/alias_table.h>
 #include <Camgen/ps_decl.h>
 #include <Camgen/MC_gen.h>
 #include <Camgen/sgen_grid.h>
@@ -188,24 +189,17 @@ namespace Camgen
 		    (*branching_iterator)->choose_channel(b);
 		    return true;
 		}
-		else
+		if(branching_alias.size()!=branchings.size())
 		{
-		    branching_iterator=branchings.begin();
-		    value_type rho=rn_stream::throw_number();
-		    value_type r(0);
-		    while(r<rho and branching_iterator!=branchings.end())
-		    {
-			r+=((*branching_iterator)->alpha);
-			++branching_iterator;
-		    }
-		    --branching_iterator;
+		    refresh_alias_table();
 		}
-		if(branching_iterator==branchings.end())
+		if(branching_alias.empty())
 		{
-		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"multichannel weights incorrectly normalized: channel iterator overflow encountered"<<endlog;
+		    log(log_level::warning)<<CAMGEN_STREAMLOC<<"multichannel weights incorrectly normalized: no branching with positive weight encountered"<<endlog;
 		    b.clear();
 		    return false;
 		}
+		branching_iterator=alias_branchings[branching_alias.sample(rn_stream::throw_number())];
 		b.push_back(*branching_iterator);
 		return (*branching_iterator)->choose_channel(b);
 	    }
@@ -332,6 +326,38 @@ namespace Camgen
 		s_gen->update_weight();
 	    }
 
+	    /* Clears the update counters and invariant mass grid statistics. The
+	     * branching statistics are cleared by the phase space tree: */
+
+	    void reset_statistics()
+	    {
+		update_counter=0;
+		multichannel_flag=false;
+		if(s_gen!=NULL)
+		{
+		    s_gen->reset_statistics();
+		}
+	    }
+
+	    /* Adds the update counters and invariant mass grid statistics
+	     * collected by the argument, a copy of this channel. The branching
+	     * statistics are merged by the phase space tree: */
+
+	    bool merge_statistics(const particle_channel<model_t,N_in,N_out,rng_t>* other)
+	    {
+		if(other==NULL or other->particle_type!=particle_type or other->branchings.size()!=branchings.size())
+		{
+		    return false;
+		}
+		update_counter+=other->update_counter;
+		multichannel_flag|=other->multichannel_flag;
+		if(s_gen!=NULL and other->s_gen!=NULL)
+		{
+		    return s_gen->merge_statistics(other->s_gen);
+		}
+		return (s_gen==NULL and other->s_gen==NULL);
+	    }
+
 	    /* Adapts the multichannel weights. */
 
 	    void adapt_channels()
@@ -381,6 +407,7 @@ namespace Camgen
 			(*it)->W=(value_type)0;
 		    }
 		    branchings.sort(branching_ordering);
+		    refresh_alias_table();
 		}
 		update_counter=0;
 		multichannel_flag=false;
@@ -411,6 +438,7 @@ namespace Camgen
 		    }
 		    branchings.sort(branching_ordering);
 		}
+		refresh_alias_table();
 	    }
 
 	    /* Adapts the vegas grids: */
@@ -440,6 +468,7 @@ namespace Camgen
 		    (*it)->alpha=(value_type)1/branchings.size();
 		    (*it)->reset();
 		}
+		refresh_alias_table();
 		generation_flag=false;
 		update_counter=0;
 		multichannel_flag=false;
@@ -473,6 +502,7 @@ namespace Camgen
 		}
 	    	branchings.remove_if(redundant_branching);
 		branching_iterator=branchings.begin();
+		refresh_alias_table();
 	    }
 
 	    /* Evaluates the invariant mass from the momentum. */
@@ -872,6 +902,12 @@ namespace Camgen
 	    /* Sampled branching by the multichannel: */
 
 	    typename std::list<branching_type*>::iterator branching_iterator;
+
+	    /* Alias table of the branching multichannel weights, and the
+	     * corresponding branching positions: */
+
+	    alias_table<value_type>branching_alias;
+	    std::vector<typename std::list<branching_type*>::iterator>alias_branchings;
 	    
 	    /* Update counters: */
 	    
@@ -897,6 +933,24 @@ namespace Camgen
 
 	    const value_type* threshold;
 
+	    /* Private methods: */
+	    /*------------------*/
+
+	    /* Rebuilds the alias table from the branching multichannel weights: */
+
+	    void refresh_alias_table()
+	    {
+		alias_branchings.clear();
+		std::vector<value_type>alphas;
+		alphas.reserve(branchings.size());
+		for(typename std::list<branching_type*>::iterator it=branchings.begin();it!=branchings.end();++it)
+		{
+		    alias_branchings.push_back(it);
+		    alphas.push_back((*it)->alpha);
+		}
+		branching_alias.build(alphas);
+	    }
+
 	    /* Private constructors: */
 	    /*-----------------------*/
 
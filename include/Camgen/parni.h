@@ -227,7 +227,7 @@ namespace Camgen
 	    bool generate()
 	    {
 		value_type rho=rn_stream::throw_number(0,root_bin->w);
-		reg_bin=root_bin->find_weight(rho);
+		reg_bin=find_weight(rho);
 		if(reg_bin->generate(this->object()))
 		{
 		    this->weight()=reg_bin->weight()*norm();
@@ -264,65 +264,85 @@ namespace Camgen
 		}
 	    }
 
+	    /// Clears the bin statistics collected since the last adaptation,
+	    /// keeping the grid structure intact.
+
+	    void reset_statistics()
+	    {
+		root_bin->reset_statistics();
+	    }
+
+	    /// Adds the bin statistics collected by the argument grid, which
+	    /// should be a copy of this grid, to this grid. Returns false if
+	    /// the bin structures differ.
+
+	    bool merge_statistics(const parni<value_t,D,rng_t,key_t>& other)
+	    {
+		return root_bin->merge_statistics(other.root_bin);
+	    }
+
 	    /// Overridden adaptation method.
 
 	    void adapt()
 	    {
 		root_bin->adapt();
+		leaf_index.rebuild(root_bin);
 		if(!final())
 		{
 		    std::vector<bin_type*>selection;
 		    value_type maxw(0),w;
-		    for(leaf_iterator it=begin_leaves();it!=end_leaves();++it)
+		    for(size_type i=0;i<leaf_index.size();++i)
 		    {
-			w=(*it)->w;
+			w=leaf_index.weight(i);
 			if(maxw<w)
 			{
 			    selection.resize(1);
-			    selection[0]=*it;
+			    selection[0]=leaf_index[i];
 			    maxw=w;
 			}
 			else if(maxw==w)
 			{
-			    selection.push_back(*it);
+			    selection.push_back(leaf_index[i]);
 			}
 		    }
 		    if(selection.size()==1)
 		    {
 			selection[0]->split();
+			leaf_index.clear();
 		    }
 		    else if(selection.size()>1)
 		    {
 			selection[rn_stream::throw_dice(selection.size())]->split();
+			leaf_index.clear();
 		    }
 		}
 		else
 		{
 		    std::vector<bin_type*>min_selection,max_selection;
 		    value_type maxw(0),minw(std::numeric_limits<value_type>::infinity()),w;
-		    for(leaf_iterator it=begin_leaves();it!=end_leaves();++it)
+		    for(size_type i=0;i<leaf_index.size();++i)
 		    {
-			w=(*it)->w;
+			w=leaf_index.weight(i);
 			if(maxw<w)
 			{
 			    max_selection.resize(1);
-			    max_selection[0]=*it;
+			    max_selection[0]=leaf_index[i];
 			    maxw=w;
 			}
 			else if(maxw==w)
 			{
-			    max_selection.push_back(*it);
+			    max_selection.push_back(leaf_index[i]);
 			}
-			w=(*it)->parent->w;
+			w=leaf_index[i]->parent->w;
 			if(minw>w)
 			{
 			    min_selection.resize(1);
-			    min_selection[0]=(*it)->parent;
+			    min_selection[0]=leaf_index[i]->parent;
 			    minw=w;
 			}
 			else if(minw==w)
 			{
-			    min_selection.push_back(*it);
+			    min_selection.push_back(leaf_index[i]->parent);
 			}
 		    }
 		    bin_type* minb;
@@ -359,6 +379,7 @@ namespace Camgen
 			}
 			minb->merge();
 			maxb->split();
+			leaf_index.clear();
 			if(reg_bin==maxb)
 			{
 			    reg_bin=rn_stream::throw_coin()?(maxb->child1):(maxb->child2);
@@ -374,6 +395,7 @@ namespace Camgen
 	    {
 		this->base_type::reset();
 		root_bin->reset();
+		leaf_index.clear();
 	    }
 
 	    /* Public readout functions: */
@@ -461,6 +483,7 @@ namespace Camgen
 		{
 		    delete root_bin;
 		    root_bin=root_bin_;
+		    leaf_index.clear();
 		}
 		reg_bin=root_bin;
 		return is;
@@ -607,6 +630,10 @@ namespace Camgen
 	    
 	    bin_type* reg_bin;
 
+	    /* Flattened leaf index, rebuilt after adaptation: */
+
+	    parni_leaf_index<value_t,D,rng_t,key_t>leaf_index;
+
 	    /* Sub-grid register: */
 
 	    std::set<parni_sub_grid<value_t,1,rng_t,key_t>*>subgrids;
@@ -625,6 +652,18 @@ namespace Camgen
 	    /* Private methods: */
 	    /*------------------*/
 
+	    /* Returns the leaf in which the cumulative bin weight crosses the
+	     * argument, rebuilding the leaf index if necessary: */
+
+	    bin_type* find_weight(const value_type& rho)
+	    {
+		if(leaf_index.empty())
+		{
+		    leaf_index.rebuild(root_bin);
+		}
+		return leaf_index.find_weight(rho);
+	    }
+
 	    /* Returns the lowest-level bin containing the argument point: */
 
 	    bin_type* find_leaf(const point_type& x)
@@ -859,7 +898,7 @@ namespace Camgen
 	    bool generate()
 	    {
 		value_type rho=rn_stream::throw_number(0,root_bin->w);
-		reg_bin=root_bin->find_weight(rho);
+		reg_bin=find_weight(rho);
 		if(reg_bin->generate(this->object()))
 		{
 		    this->weight()=reg_bin->weight()*norm();
@@ -900,65 +939,85 @@ namespace Camgen
 		}
 	    }
 
+	    /// Clears the bin statistics collected since the last adaptation,
+	    /// keeping the grid structure intact.
+
+	    void reset_statistics()
+	    {
+		root_bin->reset_statistics();
+	    }
+
+	    /// Adds the bin statistics collected by the argument grid, which
+	    /// should be a copy of this grid, to this grid. Returns false if
+	    /// the bin structures differ.
+
+	    bool merge_statistics(const parni<value_t,1,rng_t,key_t>& other)
+	    {
+		return root_bin->merge_statistics(other.root_bin);
+	    }
+
 	    /// Overridden adaptation method.
 	    
 	    void adapt()
 	    {
 		root_bin->adapt();
+		leaf_index.rebuild(root_bin);
 		if(!final())
 		{
 		    std::vector<bin_type*>selection;
 		    value_type maxw(0),w;
-		    for(leaf_iterator it=begin_leaves();it!=end_leaves();++it)
+		    for(size_type i=0;i<leaf_index.size();++i)
 		    {
-			w=(*it)->w;
+			w=leaf_index.weight(i);
 			if(maxw<w)
 			{
 			    selection.resize(1);
-			    selection[0]=*it;
+			    selection[0]=leaf_index[i];
 			    maxw=w;
 			}
 			else if(maxw==w)
 			{
-			    selection.push_back(*it);
+			    selection.push_back(leaf_index[i]);
 			}
 		    }
 		    if(selection.size()==1)
 		    {
 			selection[0]->split();
+			leaf_index.clear();
 		    }
 		    else if(selection.size()>1)
 		    {
 			selection[rn_stream::throw_dice(selection.size())]->split();
+			leaf_index.clear();
 		    }
 		}
 		else
 		{
 		    std::vector<bin_type*>min_selection,max_selection;
 		    value_type maxw(0),minw(std::numeric_limits<value_type>::infinity()),w;
-		    for(leaf_iterator it=begin_leaves();it!=end_leaves();++it)
+		    for(size_type i=0;i<leaf_index.size();++i)
 		    {
-			w=(*it)->w;
+			w=leaf_index.weight(i);
 			if(maxw<w)
 			{
 			    max_selection.resize(1);
-			    max_selection[0]=*it;
+			    max_selection[0]=leaf_index[i];
 			    maxw=w;
 			}
 			else if(maxw==w)
 			{
-			    max_selection.push_back(*it);
+			    max_selection.push_back(leaf_index[i]);
 			}
-			w=(*it)->parent->w;
+			w=leaf_index[i]->parent->w;
 			if(minw>w)
 			{
 			    min_selection.resize(1);
-			    min_selection[0]=(*it)->parent;
+			    min_selection[0]=leaf_index[i]->parent;
 			    minw=w;
 			}
 			else if(minw==w)
 			{
-			    min_selection.push_back((*it)->parent);
+			    min_selection.push_back(leaf_index[i]->parent);
 			}
 		    }
 		    bin_type* minb;
@@ -995,6 +1054,7 @@ namespace Camgen
 			}
 			minb->merge();
 			maxb->split();
+			leaf_index.clear();
 			if(reg_bin==maxb)
 			{
 			    reg_bin=rn_stream::throw_coin()?(maxb->child1):(maxb->child2);
@@ -1012,68 +1072,71 @@ namespace Camgen
 	    void adapt(const point_type& a,const point_type& b)
 	    {
 		root_bin->adapt();
+		leaf_index.rebuild(root_bin);
 		if(!final())
 		{
 		    std::vector<bin_type*>selection;
 		    value_type maxw(0),w;
-		    for(leaf_iterator it=begin_leaves();it!=end_leaves();++it)
+		    for(size_type i=0;i<leaf_index.size();++i)
 		    {
-			if((*it)->upper_bound()<a or (*it)->lower_bound()>b)
+			if(leaf_index[i]->upper_bound()<a or leaf_index[i]->lower_bound()>b)
 			{
 			    continue;
 			}
-			w=(*it)->w;
+			w=leaf_index.weight(i);
 			if(maxw<w)
 			{
 			    selection.resize(1);
-			    selection[0]=*it;
+			    selection[0]=leaf_index[i];
 			    maxw=w;
 			}
 			else if(maxw==w)
 			{
-			    selection.push_back(*it);
+			    selection.push_back(leaf_index[i]);
 			}
 		    }
 		    if(selection.size()==1)
 		    {
 			selection[0]->split();
+			leaf_index.clear();
 		    }
 		    else if(selection.size()>1)
 		    {
 			selection[rn_stream::throw_dice(selection.size())]->split();
+			leaf_index.clear();
 		    }
 		}
 		else
 		{
 		    std::vector<bin_type*>min_selection,max_selection;
 		    value_type maxw(0),minw(std::numeric_limits<value_type>::infinity()),w;
-		    for(leaf_iterator it=begin_leaves();it!=end_leaves();++it)
+		    for(size_type i=0;i<leaf_index.size();++i)
 		    {
-			if((*it)->upper_bound()<a or (*it)->lower_bound()>b)
+			if(leaf_index[i]->upper_bound()<a or leaf_index[i]->lower_bound()>b)
 			{
 			    continue;
 			}
-			w=(*it)->w;
+			w=leaf_index.weight(i);
 			if(maxw<w)
 			{
 			    max_selection.resize(1);
-			    max_selection[0]=*it;
+			    max_selection[0]=leaf_index[i];
 			    maxw=w;
 			}
 			else if(maxw==w)
 			{
-			    max_selection.push_back(*it);
+			    max_selection.push_back(leaf_index[i]);
 			}
-			w=(*it)->parent->w;
+			w=leaf_index[i]->parent->w;
 			if(minw>w)
 			{
 			    min_selection.resize(1);
-			    min_selection[0]=(*it)->parent;
+			    min_selection[0]=leaf_index[i]->parent;
 			    minw=w;
 			}
 			else if(minw==w)
 			{
-			    min_selection.push_back((*it)->parent);
+			    min_selection.push_back(leaf_index[i]->parent);
 			}
 		    }
 		    bin_type* minb;
@@ -1110,6 +1173,7 @@ namespace Camgen
 			}
 			minb->merge();
 			maxb->split();
+			leaf_index.clear();
 			if(reg_bin==maxb)
 			{
 			    reg_bin=rn_stream::throw_coin()?(maxb->child1):(maxb->child2);
@@ -1129,6 +1193,7 @@ namespace Camgen
 	    {
 		this->base_type::reset();
 		root_bin->reset();
+		leaf_index.clear();
 	    }
 
 	    /* Public readout functions: */
@@ -1210,6 +1275,7 @@ namespace Camgen
 		{
 		    delete root_bin;
 		    root_bin=root_bin_;
+		    leaf_index.clear();
 		}
 		reg_bin=root_bin;
 		return is;
@@ -1348,6 +1414,10 @@ namespace Camgen
 	    
 	    bin_type* reg_bin;
 
+	    /* Flattened leaf index, rebuilt after adaptation: */
+
+	    parni_leaf_index<value_t,1,rng_t,key_t>leaf_index;
+
 	    /* Sub-grid register: */
 
 	    std::set<parni_sub_grid<value_t,1,rng_t,key_t>*>subgrids;
@@ -1366,6 +1436,18 @@ namespace Camgen
 	    /* Private methods: */
 	    /*------------------*/
 
+	    /* Returns the leaf in which the cumulative bin weight crosses the
+	     * argument, rebuilding the leaf index if necessary: */
+
+	    bin_type* find_weight(const value_type& rho)
+	    {
+		if(leaf_index.empty())
+		{
+		    leaf_index.rebuild(root_bin);
+		}
+		return leaf_index.find_weight(rho);
+	    }
+
 	    /* Returns the lowest-level bin containing the argument point: */
 
 	    bin_type* find_leaf(const point_type& x)
@@ -54,6 +54,10 @@ namespace Camgen
     template<class value_t,std::size_t D,class rng_t,class key_t=std::size_t>class const_parni_leaf_iterator;
     template<class value_t,std::size_t D,class rng_t,class key_t=std::size_t>class reverse_parni_leaf_iterator;
     template<class value_t,std::size_t D,class rng_t,class key_t=std::size_t>class const_reverse_parni_leaf_iterator;
+    
+    /* Parni flattened leaf index forward declaration: */
+    
+    template<class value_t,std::size_t D,class rng_t,class key_t=std::size_t>class parni_leaf_index;
 
     /* Parni bin class: */
 
@@ -71,6 +75,7 @@ namespace Camgen
 	friend class const_parni_leaf_iterator<value_t,D,rng_t,key_t>;
 	friend class reverse_parni_leaf_iterator<value_t,D,rng_t,key_t>;
 	friend class const_reverse_parni_leaf_iterator<value_t,D,rng_t,key_t>;
+	friend class parni_leaf_index<value_t,D,rng_t,key_t>;
 
 	public:
 	    
@@ -149,6 +154,16 @@ namespace Camgen
 		{
 		    result->child2->parent=result;
 		}
+		if(result->child1!=NULL)
+		{
+		    for(size_type i=0;i<D;++i)
+		    {
+			if(result->child1->depth[i]!=result->depth[i])
+			{
+			    result->split_ind=i;
+			}
+		    }
+		}
 		return result;
 	    }
 
@@ -340,6 +355,63 @@ namespace Camgen
 		}
 	    }
 
+	    /* Clears the collected statistics of the bin and its subbins,
+	    leaving the bin structure and weights intact: */
+
+	    void reset_statistics()
+	    {
+		F0=0;
+		F1=0;
+		F2=0;
+		fmax=0;
+		fmax1=0;
+		fmax2=0;
+		if(child1!=NULL)
+		{
+		    child1->reset_statistics();
+		}
+		if(child2!=NULL)
+		{
+		    child2->reset_statistics();
+		}
+	    }
+
+	    /* Adds the statistics collected by the argument bin, which should
+	    have been cloned from the same grid, to this bin and its subbins.
+	    Returns false if the bin trees do not match: */
+
+	    bool merge_statistics(const parni_bin<value_t,D,rng_t,key_t>* other)
+	    {
+		if(other==NULL or (child1==NULL)!=(other->child1==NULL) or (child2==NULL)!=(other->child2==NULL))
+		{
+		    return false;
+		}
+		F0+=other->F0;
+		F1+=other->F1;
+		F2+=other->F2;
+		fmax=std::max(fmax,other->fmax);
+		if(split_ind==other->split_ind)
+		{
+		    fmax1=std::max(fmax1,other->fmax1);
+		    fmax2=std::max(fmax2,other->fmax2);
+		}
+		else
+		{
+		    fmax1=std::max(fmax1,other->fmax);
+		    fmax2=std::max(fmax2,other->fmax);
+		}
+		bool q=true;
+		if(child1!=NULL)
+		{
+		    q&=child1->merge_statistics(other->child1);
+		}
+		if(child2!=NULL)
+		{
+		    q&=child2->merge_statistics(other->child2);
+		}
+		return q;
+	    }
+
 	    /* Adapts the weight and all subbin weights: */
 
 	    void adapt()
@@ -1113,6 +1185,7 @@ namespace Camgen
 	friend class const_parni_leaf_iterator<value_t,1,rng_t,key_t>;
 	friend class reverse_parni_leaf_iterator<value_t,1,rng_t,key_t>;
 	friend class const_reverse_parni_leaf_iterator<value_t,1,rng_t,key_t>;
+	friend class parni_leaf_index<value_t,1,rng_t,key_t>;
 
 	public:
 	    
@@ -1341,6 +1414,55 @@ namespace Camgen
 		}
 	    }
 
+	    /* Clears the collected statistics of the bin and its subbins,
+	    leaving the bin structure and weights intact: */
+
+	    void reset_statistics()
+	    {
+		F0=0;
+		F1=0;
+		F2=0;
+		fmax=0;
+		fmax1=0;
+		fmax2=0;
+		if(child1!=NULL)
+		{
+		    child1->reset_statistics();
+		}
+		if(child2!=NULL)
+		{
+		    child2->reset_statistics();
+		}
+	    }
+
+	    /* Adds the statistics collected by the argument bin, which should
+	    have been cloned from the same grid, to this bin and its subbins.
+	    Returns false if the bin trees do not match: */
+
+	    bool merge_statistics(const parni_bin<value_t,1,rng_t,key_t>* other)
+	    {
+		if(other==NULL or (child1==NULL)!=(other->child1==NULL) or (child2==NULL)!=(other->child2==NULL))
+		{
+		    return false;
+		}
+		F0+=other->F0;
+		F1+=other->F1;
+		F2+=other->F2;
+		fmax=std::max(fmax,other->fmax);
+		fmax1=std::max(fmax1,other->fmax1);
+		fmax2=std::max(fmax2,other->fmax2);
+		bool q=true;
+		if(child1!=NULL)
+		{
+		    q&=child1->merge_statistics(other->child1);
+		}
+		if(child2!=NULL)
+		{
+		    q&=child2->merge_statistics(other->child2);
+		}
+		return q;
+	    }
+
 	    /* Adapts the weight and all subbin weights: */
 
 	    void adapt()
@@ -9,11 +9,15 @@
 #define CAMGEN_PARNI_IT_H_
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
- * Iterator definitions to traverse the parni binary tree. *
+ * Iterator definitions to traverse the parni binary tree, *
+ * and a flattened index of the tree leaves storing the    *
+ * cumulative leaf weights for binary-search sampling.     *
  *                                                         *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#include <vector>
 #include <iterator>
+#include <algorithm>
 #include <Camgen/parni_bin.h>
 
 namespace Camgen
@@ -801,6 +805,96 @@ namespace Camgen
 
 	    const parni_bin<value_t,D,rng_t,key_t>* bin;
     };
+
+    /* Flattened leaf index class definition. The leaves are stored in the
+     * left-to-right order of the tree, together with the cumulative sums of
+     * their weights, so that weight lookups are binary searches instead of
+     * tree descents: */
+
+    template<class value_t,std::size_t D,class rng_t,class key_t>class parni_leaf_index
+    {
+	public:
+
+	    /* Type definitions: */
+
+	    typedef value_t value_type;
+	    typedef parni_bin<value_t,D,rng_t,key_t> bin_type;
+	    typedef typename bin_type::size_type size_type;
+	    typedef typename bin_type::leaf_iterator leaf_iterator;
+
+	    /* Clears the index: */
+
+	    void clear()
+	    {
+		leaves.clear();
+		cumulants.clear();
+	    }
+
+	    /* Returns whether the index is empty, i.e. needs rebuilding: */
+
+	    bool empty() const
+	    {
+		return leaves.empty();
+	    }
+
+	    /* Returns the number of indexed leaves: */
+
+	    size_type size() const
+	    {
+		return leaves.size();
+	    }
+
+	    /* Returns the i-th leaf: */
+
+	    bin_type* operator [] (size_type i) const
+	    {
+		return leaves[i];
+	    }
+
+	    /* Returns the weight of the i-th leaf: */
+
+	    const value_type& weight(size_type i) const
+	    {
+		return leaves[i]->w;
+	    }
+
+	    /* Fills the index with the leaves of the argument tree: */
+
+	    void rebuild(bin_type* root)
+	    {
+		clear();
+		value_type s(0);
+		for(leaf_iterator it=root->begin_leaves();it!=root->end_leaves();++it)
+		{
+		    leaves.push_back(*it);
+		    s+=(*it)->w;
+		    cumulants.push_back(s);
+		}
+	    }
+
+	    /* Returns the leaf in which the cumulative weight crosses the
+	     * argument: */
+
+	    bin_type* find_weight(const value_type& rho) const
+	    {
+		typename std::vector<value_type>::const_iterator it=std::upper_bound(cumulants.begin(),cumulants.end(),rho);
+		if(it==cumulants.end())
+		{
+		    return leaves.back();
+		}
+		return leaves[it-cumulants.begin()];
+	    }
+
+	private:
+
+	    /* Leaf pointers: */
+
+	    std::vector<bin_type*>leaves;
+
+	    /* Cumulative leaf weights: */
+
+	    std::vector<value_type>cumulants;
+    };
 }
 
 #endif /*CAMGEN_PARNI_IT_H_*/
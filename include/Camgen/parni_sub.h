@@ -120,7 +120,7 @@ namespace Camgen
 		    return false;
 		}
 		value_type rho=rn_stream::throw_number(smin,smax);
-		reg_bin=grid->root_bin->find_weight(rho);
+		reg_bin=grid->find_weight(rho);
 		bool q=reg_bin->generate(this->object(),xmin,xmax);
 		if(!q)
 		{
@@ -556,6 +556,40 @@ namespace Camgen
 		return (flavour < other.flavour);
 	    }
 
+	    /* Returns whether the argument only differs from this particle by
+	     * its name, flavour and pdg id, i.e. whether it has the same mass
+	     * and width values and identical index structure, wave functions,
+	     * propagators and contractions: */
+
+	    bool is_equivalent(const particle<model_t>& other) const
+	    {
+		if(!(S==other.S) or col_dim!=other.col_dim or fermion_nr!=other.fermion_nr or auxiliary!=other.auxiliary or Majorana_tag!=other.Majorana_tag or coupled!=other.coupled)
+		{
+		    return false;
+		}
+		if((mass==NULL)!=(other.mass==NULL) or (width==NULL)!=(other.width==NULL) or get_mass()!=other.get_mass() or get_width()!=other.get_width())
+		{
+		    return false;
+		}
+		if((anti_particle==this)!=(other.anti_particle==&other))
+		{
+		    return false;
+		}
+		if(block_size!=other.block_size or decomposed_colours!=other.decomposed_colours or swapped_colours!=other.swapped_colours or swapped_anti_colours!=other.swapped_anti_colours)
+		{
+		    return false;
+		}
+		if(spacetime_index_ranges!=other.spacetime_index_ranges or colour_index_ranges!=other.colour_index_ranges or colour_numbers!=other.colour_numbers or index_ranges!=other.index_ranges)
+		{
+		    return false;
+		}
+		if(propagator!=other.propagator or refresh_prop!=other.refresh_prop or anti_propagator!=other.anti_propagator or refresh_anti_prop!=other.refresh_anti_prop or contraction!=other.contraction or conj_contraction!=other.conj_contraction)
+		{
+		    return false;
+		}
+		return (pos_hel_incoming_massless_states==other.pos_hel_incoming_massless_states and zero_hel_incoming_massless_state==other.zero_hel_incoming_massless_state and neg_hel_incoming_massless_states==other.neg_hel_incoming_massless_states and pos_hel_outgoing_massless_states==other.pos_hel_outgoing_massless_states and zero_hel_outgoing_massless_state==other.zero_hel_outgoing_massless_state and neg_hel_outgoing_massless_states==other.neg_hel_outgoing_massless_states and pos_hel_incoming_massive_states==other.pos_hel_incoming_massive_states and zero_hel_incoming_massive_state==other.zero_hel_incoming_massive_state and neg_hel_incoming_massive_states==other.neg_hel_incoming_massive_states and pos_hel_outgoing_massive_states==other.pos_hel_outgoing_massive_states and zero_hel_outgoing_massive_state==other.zero_hel_outgoing_massive_state and neg_hel_outgoing_massive_states==other.neg_hel_outgoing_massive_states);
+	    }
+
 	    /* Function returning the address of the anti-particle: */
 
 	    const particle<model_t>* get_anti_particle() const
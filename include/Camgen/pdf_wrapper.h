@@ -11,11 +11,17 @@
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * This class wraps the LHAPDF dependence, such that we do not have direct *
  * dependence on the configuration header in public headers, but only      *
- * implementation.                                                         *
+ * implementation. Upon initialisation, the pdfs of all partons are        *
+ * tabulated on a grid in x and log(Q^2), from which they are interpolated *
+ * afterwards. Grid lookups do not touch the global LHAPDF    *
+ * state and are therefore thread-safe; points outside the grid are passed *
+ * to LHAPDF under a lock.                                                 *
  *                                                                         *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 namespace Camgen
 {
@@ -79,6 +85,26 @@ namespace Camgen
 
 	    static double ff(double x1,double x2,int q1,int q2,double mu);
 
+	    /* Fills the argument array with x*f(x) evaluated at momentum
+	     * fraction x and qcd scale mu, for the partons -6,...,6: */
+
+	    static void xf(double x,double mu,double* xfs);
+
+	    /* Fills the argument array with the flux factors of the n parton
+	     * pairs (q1[i],q2[i]) at common momentum fractions x1,x2 and qcd
+	     * scale mu, evaluating each pdf only once: */
+
+	    static void ff(double x1,double x2,const int* q1,const int* q2,std::size_t n,double mu,double* result);
+
+	    /* Enables or disables the interpolation grid (enabled by default),
+	     * taking effect at the next initialisation: */
+
+	    static void set_cache(bool);
+
+	    /* Returns whether the pdfs are interpolated from the grid: */
+
+	    static bool cached();
+
 	    /* Returns the strong couplings constant: */
 
 	    static double alpha_s(double mu);
@@ -97,6 +123,42 @@ namespace Camgen
 
 	    static int setnr;
 
+	    /* Number of tabulated partons: */
+
+	    static const int n_partons=13;
+
+	    /* Interpolation grid flag: */
+
+	    static bool use_cache;
+
+	    /* Interpolation grid of x*f(x) for all partons, with the parton
+	     * index running fastest and the x index slowest: */
+
+	    static std::vector<double>grid;
+
+	    /* Grid dimensions: */
+
+	    static int nx,nq;
+
+	    /* Grid boundaries and spacings in the variable log(x)+c*x, which
+	     * resolves both the small-x and the large-x region, and in
+	     * log(Q^2): */
+
+	    static double vx0,vx1,dvx,lnq0,lnq1,dlnq;
+
+	    /* Fills the interpolation grid for the current pdf set: */
+
+	    static void fill_grid();
+
+	    /* Interpolates x*f(x) for partons qmin,...,qmax from the grid into
+	     * the argument array. Returns false outside the grid: */
+
+	    static bool interpolate(double x,double mu,int qmin,int qmax,double* xfs);
+
+	    /* Fills the argument array with x*f(x) for partons qmin,...,qmax,
+	     * falling back to LHAPDF outside the grid: */
+
+	    static void evaluate(double x,double mu,int qmin,int qmax,double* xfs);
     };
 }
 
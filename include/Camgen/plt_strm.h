@@ -15,6 +15,7 @@
 #include <vector>
 #include <fstream>
 #include <iostream>
+#include <Camgen/fmt_buffer.h>
 
 namespace Camgen
 {
@@ -116,7 +117,8 @@ namespace Camgen
 	    ~data_wrapper();
 
 	    /// Adds a new line to the output file with the values pointed to by
-	    /// the internal adresses.
+	    /// the internal adresses. The lines are collected in a buffer, which
+	    /// is written to the file when full and by the write() method.
 
 	    bool fill();
 
@@ -154,6 +156,10 @@ namespace Camgen
 	    
 	    std::ofstream datastream;
 
+	    /* Line buffer: */
+
+	    format_buffer buffer;
+
 	    /* Users counter: */
 
 	    unsigned users;
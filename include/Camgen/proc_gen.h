@@ -147,7 +147,7 @@ namespace Camgen
 
 	    /// Constructor configuring with static configurations settings.
 
-	    process_generator(CM_tree_iterator it):id(0),symmetry_factor(it->symmetry_factor()),evt_counter(0),pos_evt_counter(0),tot_weight(0),alpha(1),amplitude(it),zero_me(it->count_diagrams()==(long long unsigned)0),me(1),ps_gen(NULL),ps_weight(1),ps_factor(1),hel_gen(NULL),hel_weight(1),hel_factor(1),col_gen(NULL),col_weight(1),col_factor(1),update_counter(0),auto_update(false),grid_adaptations(0),auto_grid_adapt(0),channel_adaptations(0),auto_channel_adapt(0),max_rejects(std::numeric_limits<size_type>::max()),pre_init_evts(0),ps_cut(NULL),scale(NULL)
+	    process_generator(CM_tree_iterator it):id(0),symmetry_factor(it->symmetry_factor()),evt_counter(0),pos_evt_counter(0),tot_weight(0),alpha(1),amplitude(it),zero_me(it->count_diagrams()==(long long unsigned)0),me(1),ps_gen(NULL),ps_weight(1),ps_factor(1),hel_gen(NULL),hel_weight(1),hel_factor(1),col_gen(NULL),col_weight(1),col_factor(1),update_counter(0),auto_update(false),grid_adaptations(0),auto_grid_adapt(0),channel_adaptations(0),auto_channel_adapt(0),max_rejects(std::numeric_limits<size_type>::max()),pre_init_evts(0),ps_cut(NULL),scale(NULL),flavour(0),summed_proc(0)
 	    {
 		summed_spins.reset();
 		summed_colours.reset();
@@ -157,7 +157,7 @@ namespace Camgen
 	    /// Constructor configuring with static configurations settings.
 	    /// Takes the current subprocess in algo.
 
-	    process_generator(CM_algorithm<model_t,N_in,N_out>& algo):id(0),symmetry_factor(algo.get_tree_iterator()->symmetry_factor()),evt_counter(0),pos_evt_counter(0),tot_weight(0),alpha(1),amplitude(algo.get_tree_iterator()),zero_me(amplitude->count_diagrams()==(long long unsigned)0),me(1),ps_gen(NULL),ps_weight(1),ps_factor(1),hel_gen(NULL),hel_weight(1),hel_factor(1),col_gen(NULL),col_weight(1),col_factor(1),update_counter(0),auto_update(false),grid_adaptations(0),auto_grid_adapt(0),channel_adaptations(0),auto_channel_adapt(0),max_rejects(std::numeric_limits<size_type>::max()),pre_init_evts(0),ps_cut(NULL),scale(NULL)
+	    process_generator(CM_algorithm<model_t,N_in,N_out>& algo):id(0),symmetry_factor(algo.get_tree_iterator()->symmetry_factor()),evt_counter(0),pos_evt_counter(0),tot_weight(0),alpha(1),amplitude(algo.get_tree_iterator()),zero_me(amplitude->count_diagrams()==(long long unsigned)0),me(1),ps_gen(NULL),ps_weight(1),ps_factor(1),hel_gen(NULL),hel_weight(1),hel_factor(1),col_gen(NULL),col_weight(1),col_factor(1),update_counter(0),auto_update(false),grid_adaptations(0),auto_grid_adapt(0),channel_adaptations(0),auto_channel_adapt(0),max_rejects(std::numeric_limits<size_type>::max()),pre_init_evts(0),ps_cut(NULL),scale(NULL),flavour(0),summed_proc(0)
 	    {
 		summed_spins.reset();
 		summed_colours.reset();
@@ -166,7 +166,7 @@ namespace Camgen
 
 	    /// Constructor configuring with configuration class settings.
 	    
-	    process_generator(CM_tree_iterator it,generator_configuration<model_t>& settings):id(0),symmetry_factor(it->symmetry_factor()),evt_counter(0),pos_evt_counter(0),tot_weight(0),alpha(1),amplitude(it),zero_me(it->count_diagrams()==(long long unsigned)0),me(1),ps_gen(NULL),ps_weight(1),ps_factor(1),hel_gen(NULL),hel_weight(1),hel_factor(1),col_gen(NULL),col_weight(1),col_factor(1),update_counter(0),auto_update(false),grid_adaptations(0),auto_grid_adapt(0),channel_adaptations(0),auto_channel_adapt(0),max_rejects(std::numeric_limits<size_type>::max()),pre_init_evts(0),ps_cut(NULL),scale(NULL)
+	    process_generator(CM_tree_iterator it,generator_configuration<model_t>& settings):id(0),symmetry_factor(it->symmetry_factor()),evt_counter(0),pos_evt_counter(0),tot_weight(0),alpha(1),amplitude(it),zero_me(it->count_diagrams()==(long long unsigned)0),me(1),ps_gen(NULL),ps_weight(1),ps_factor(1),hel_gen(NULL),hel_weight(1),hel_factor(1),col_gen(NULL),col_weight(1),col_factor(1),update_counter(0),auto_update(false),grid_adaptations(0),auto_grid_adapt(0),channel_adaptations(0),auto_channel_adapt(0),max_rejects(std::numeric_limits<size_type>::max()),pre_init_evts(0),ps_cut(NULL),scale(NULL),flavour(0),summed_proc(0)
 	    {
 		summed_spins.reset();
 		summed_colours.reset();
@@ -176,7 +176,7 @@ namespace Camgen
 	    /// Constructor configuring with configuration class settings.
 	    /// Takes the current subprocess in algo.
 	    
-	    process_generator(CM_algorithm<model_t,N_in,N_out>& algo,generator_configuration<model_t>& settings):id(0),symmetry_factor(algo.get_tree_iterator()->symmetry_factor()),evt_counter(0),pos_evt_counter(0),tot_weight(0),alpha(1),amplitude(algo.get_tree_iterator()),zero_me(amplitude->count_diagrams()==(long long unsigned)0),me(1),ps_gen(NULL),ps_weight(1),ps_factor(1),hel_gen(NULL),hel_weight(1),hel_factor(1),col_gen(NULL),col_weight(1),col_factor(1),update_counter(0),auto_update(false),grid_adaptations(0),auto_grid_adapt(0),channel_adaptations(0),auto_channel_adapt(0),max_rejects(std::numeric_limits<size_type>::max()),pre_init_evts(0),ps_cut(NULL),scale(NULL)
+	    process_generator(CM_algorithm<model_t,N_in,N_out>& algo,generator_configuration<model_t>& settings):id(0),symmetry_factor(algo.get_tree_iterator()->symmetry_factor()),evt_counter(0),pos_evt_counter(0),tot_weight(0),alpha(1),amplitude(algo.get_tree_iterator()),zero_me(amplitude->count_diagrams()==(long long unsigned)0),me(1),ps_gen(NULL),ps_weight(1),ps_factor(1),hel_gen(NULL),hel_weight(1),hel_factor(1),col_gen(NULL),col_weight(1),col_factor(1),update_counter(0),auto_update(false),grid_adaptations(0),auto_grid_adapt(0),channel_adaptations(0),auto_channel_adapt(0),max_rejects(std::numeric_limits<size_type>::max()),pre_init_evts(0),ps_cut(NULL),scale(NULL),flavour(0),summed_proc(0)
 	    {
 		summed_spins.reset();
 		summed_colours.reset();
@@ -409,9 +409,74 @@ namespace Camgen
 		    delete ps_gen;
 		}
 		ps_gen=ps_generator_factory<model_t,N_in,N_out,rng_t>::create_instance(amplitude,t1,t2);
+		refresh_equivalent_partons();
 		return ps_gen;
 	    }
 
+	    /// Adds a subprocess sharing the amplitude of this generator (see
+	    /// CM_algorithm::share_equivalent_trees), given by the pdg ids of its
+	    /// external legs in the order of the amplitude. The generator then
+	    /// produces the events of all these subprocesses, summing their
+	    /// incoming fluxes and selecting the subprocess of every event
+	    /// according to its flux. Returns false if the subprocess was
+	    /// already added.
+
+	    bool add_equivalent_process(const vector<int,N_in+N_out>& ids)
+	    {
+		if(flavours.empty())
+		{
+		    vector<int,N_in+N_out>own;
+		    for(size_type i=0;i<N_in+N_out;++i)
+		    {
+			own[i]=amplitude->get_phase_space(i)->particle_type->get_pdg_id();
+		    }
+		    flavours.push_back(own);
+		}
+		if(std::find(flavours.begin(),flavours.end(),ids)!=flavours.end())
+		{
+		    return false;
+		}
+		flavours.push_back(ids);
+		refresh_equivalent_partons();
+		return true;
+	    }
+
+	    /// Adds the generator of a subprocess with the same external masses
+	    /// and colour representations. Its matrix element, summed over all
+	    /// helicities and colours, is evaluated at every phase space point
+	    /// generated by this instance and added to the integrand with its
+	    /// own incoming fluxes, and the subprocess recorded in the event is
+	    /// selected according to the contributions. The cuts, scales and
+	    /// sampled helicities and colours are those of this instance. The
+	    /// argument is not deleted by this generator. Returns false if the
+	    /// subprocess is not compatible or was already added.
+
+	    bool add_summed_process(process_generator<model_t,N_in,N_out,rng_t>* other)
+	    {
+		if(other==NULL or other==this or other->amplitude==amplitude)
+		{
+		    return false;
+		}
+		for(size_type i=0;i<N_in+N_out;++i)
+		{
+		    const phase_space_type* p1=amplitude->get_phase_space(i);
+		    const phase_space_type* p2=other->amplitude->get_phase_space(i);
+		    if(p1->particle_type->get_mass()!=p2->particle_type->get_mass() or p1->particle_type->get_colour_tensor_size()!=p2->particle_type->get_colour_tensor_size())
+		    {
+			return false;
+		    }
+		}
+		if(std::find(summed_procs.begin(),summed_procs.end(),other)!=summed_procs.end())
+		{
+		    return false;
+		}
+		other->set_helicity_generator(helicity_generators::summation);
+		other->set_colour_generator(colour_generators::summation);
+		summed_procs.push_back(other);
+		summed_integrands.assign(summed_procs.size()+1,(value_type)0);
+		return true;
+	    }
+
 	    /// Sets the i-th beam energy.
 
 	    bool set_beam_energy(int i,const value_type& E)
@@ -754,9 +819,10 @@ namespace Camgen
 		    set_integrands(0);
 		    return false;
 		}
+		select_flavour();
 		this->weight()=ps_weight*hel_weight*col_weight;
 		value_type f=pb_conversion*symmetry_factor*ps_factor*hel_factor*col_factor;
-		if(f!=(value_type)0)
+		if(f!=(value_type)0 or !summed_procs.empty())
 		{
 		    evaluate_amplitude();
 		    if(!accept(me))
@@ -765,7 +831,7 @@ namespace Camgen
 			set_integrands(0);
 			return false;
 		    }
-		    f*=me;
+		    f=add_summed_integrands(me*f);
 		}
 		set_integrands(f);
 		if(auto_update)
@@ -836,7 +902,8 @@ namespace Camgen
 		}
 	    }
 
-	    /// Adapts the momentum generator grids.
+	    /// Adapts the momentum generator grids and the helicity and colour
+	    /// generators.
 
 	    void adapt_grids()
 	    {
@@ -845,6 +912,14 @@ namespace Camgen
 		    ps_gen->adapt_grids();
 		    ++grid_adaptations;
 		}
+		if(hel_gen!=NULL)
+		{
+		    hel_gen->adapt();
+		}
+		if(col_gen!=NULL)
+		{
+		    col_gen->adapt();
+		}
 	    }
 
 	    /// Adapts the momentum generator multichannels.
@@ -885,6 +960,51 @@ namespace Camgen
 		}
 	    }
 
+	    /// Throws n positive-weight events, updating the grids and channel
+	    /// statistics without adapting them. Returns false for a vanishing
+	    /// matrix element, in which case no events are thrown.
+
+	    bool collect_statistics(size_type n)
+	    {
+		if(zero_me)
+		{
+		    return false;
+		}
+		for(size_type i=0;i<n;++i)
+		{
+		    throw_pos_weight_event();
+		}
+		return true;
+	    }
+
+	    /// Clears the grid and multichannel statistics collected since the
+	    /// last adaptation, keeping the grids and channel weights intact.
+
+	    void reset_statistics()
+	    {
+		if(ps_gen!=NULL)
+		{
+		    ps_gen->reset_statistics();
+		}
+		update_counter=0;
+	    }
+
+	    /// Adds the grid and multichannel statistics collected by the
+	    /// argument, a copy of this generator, to this instance. The
+	    /// statistics of several copies can thus be combined into a single
+	    /// adaptation step. Returns false if the generators are
+	    /// incompatible.
+
+	    bool merge_statistics(const process_generator<model_t,N_in,N_out,rng_t>& other)
+	    {
+		update_counter+=other.update_counter;
+		if(ps_gen!=NULL and other.ps_gen!=NULL)
+		{
+		    return ps_gen->merge_statistics(other.ps_gen);
+		}
+		return (ps_gen==NULL and other.ps_gen==NULL);
+	    }
+
 	    /// Resets cross section, multichannel weights and adaptive grids of
 	    /// phase space, helicity and colour generators.
 
@@ -1058,6 +1178,14 @@ namespace Camgen
 		return id;
 	    }
 
+	    /// Returns the time (in seconds) spent by the phase space generator
+	    /// selecting channels since the last reset.
+
+	    double channel_selection_time() const
+	    {
+		return (ps_gen==NULL)?0:(ps_gen->channel_selection_time());
+	    }
+
 	    /// Returns the const reference to the i-th incoming momentum (no
 	    /// range checking on i).
 
@@ -1143,6 +1271,14 @@ namespace Camgen
 
 	    int id_in(size_type i) const
 	    {
+		if(summed_proc!=0)
+		{
+		    return summed_procs[summed_proc-1]->id_in(i);
+		}
+		if(flavours.size()>1)
+		{
+		    return flavours[flavour][i];
+		}
 		return particle_in(i)->particle_type->get_pdg_id();
 	    }
 
@@ -1150,9 +1286,32 @@ namespace Camgen
 
 	    int id_out(size_type i) const
 	    {
+		if(summed_proc!=0)
+		{
+		    return summed_procs[summed_proc-1]->id_out(i);
+		}
+		if(flavours.size()>1)
+		{
+		    return flavours[flavour][N_in+i];
+		}
 		return particle_out(i)->particle_type->get_pdg_id();
 	    }
 
+	    /// Returns the number of subprocesses generated by this instance.
+
+	    size_type n_equivalent_processes() const
+	    {
+		return flavours.empty()?1:flavours.size();
+	    }
+
+	    /// Returns the number of subprocesses summed at the phase space
+	    /// points of this instance, including its own.
+
+	    size_type n_summed_processes() const
+	    {
+		return summed_procs.size()+1;
+	    }
+
 	    /// Method determining the colour connection for the event.
 
 	    void fill_colours(std::vector<int>& c,std::vector<int>& cbar) const
@@ -1361,6 +1520,13 @@ namespace Camgen
 		return me;
 	    }
 
+	    /// Returns whether the matrix element vanishes identically.
+
+	    bool zero_matrix_element() const
+	    {
+		return zero_me;
+	    }
+
 	    /// Returns the number of parameter updates performed since the last
 	    /// adapt() call.
 
@@ -1441,6 +1607,7 @@ namespace Camgen
 		os<<"Nr of grid adaptations performed:                  "<<std::scientific<<grid_adaptations<<std::endl;
 		os<<"Nr of channel adaptations performed:               "<<std::scientific<<channel_adaptations<<std::endl;
 		os<<"Monte Carlo efficiency (%):                        "<<std::scientific<<this->efficiency()<<std::endl;
+		os<<"Channel selection time (s):                        "<<std::scientific<<channel_selection_time()<<std::endl;
 		os<<"Cross section (pb):                                "<<std::scientific<<this->cross_section()<<std::endl;
 		os<<"###############################################################################################"<<std::endl;
 		return os;
@@ -1783,9 +1950,33 @@ namespace Camgen
 
 	    bool alpha_pdf;
 
+	    /* External pdg ids of the subprocesses sharing the amplitude, the
+	     * first entry denoting the amplitude's own subprocess: */
+
+	    std::vector< vector<int,N_in+N_out> >flavours;
+
+	    /* Index of the subprocess selected for the current event: */
+
+	    size_type flavour;
+
+	    /* Generators of the subprocesses summed at the phase space points of
+	     * this instance: */
+
+	    std::vector<process_generator<model_t,N_in,N_out,rng_t>*>summed_procs;
+
+	    /* Integrand contributions of this instance and the summed
+	     * subprocesses in the current event: */
+
+	    std::vector<value_type>summed_integrands;
+
+	    /* Summed subprocess recorded in the current event, zero denoting
+	     * this instance: */
+
+	    size_type summed_proc;
+
 	    /* Private constructor, no configuration performed: */
 
-	    process_generator(CM_tree_iterator it,size_type id_):id(id_),symmetry_factor(it->symmetry_factor()),evt_counter(0),pos_evt_counter(0),tot_weight(0),alpha(1),amplitude(it),zero_me(it->count_diagrams()==(long long unsigned)0),me(1),ps_gen(NULL),ps_weight(1),ps_factor(1),hel_gen(NULL),hel_weight(1),hel_factor(1),col_gen(NULL),col_weight(1),col_factor(1),update_counter(0),auto_update(false),grid_adaptations(0),auto_grid_adapt(0),channel_adaptations(0),auto_channel_adapt(0),max_rejects(std::numeric_limits<size_type>::max()),pre_init_evts(0),ps_cut(NULL),scale(NULL),alpha_pdf(Camgen::use_pdf_alpha_s())
+	    process_generator(CM_tree_iterator it,size_type id_):id(id_),symmetry_factor(it->symmetry_factor()),evt_counter(0),pos_evt_counter(0),tot_weight(0),alpha(1),amplitude(it),zero_me(it->count_diagrams()==(long long unsigned)0),me(1),ps_gen(NULL),ps_weight(1),ps_factor(1),hel_gen(NULL),hel_weight(1),hel_factor(1),col_gen(NULL),col_weight(1),col_factor(1),update_counter(0),auto_update(false),grid_adaptations(0),auto_grid_adapt(0),channel_adaptations(0),auto_channel_adapt(0),max_rejects(std::numeric_limits<size_type>::max()),pre_init_evts(0),ps_cut(NULL),scale(NULL),alpha_pdf(Camgen::use_pdf_alpha_s()),flavour(0),summed_proc(0)
 	    {
 		summed_spins.reset();
 		summed_colours.reset();
@@ -1811,6 +2002,177 @@ namespace Camgen
 		}
 	    }
 
+	    /* Passes the incoming partons of the subprocesses sharing the
+	     * amplitude to the phase space generator: */
+
+	    void refresh_equivalent_partons()
+	    {
+		if(ps_gen!=NULL and flavours.size()>1)
+		{
+		    std::vector< vector<int,N_in> >partons(flavours.size());
+		    for(size_type k=0;k<flavours.size();++k)
+		    {
+			for(size_type i=0;i<N_in;++i)
+			{
+			    partons[k][i]=flavours[k][i];
+			}
+		    }
+		    ps_gen->set_equivalent_partons(partons);
+		}
+	    }
+
+	    /* Selects the subprocess of the event according to the incoming
+	     * fluxes: */
+
+	    void select_flavour()
+	    {
+		flavour=0;
+		summed_proc=0;
+		if(flavours.size()<2 or ps_gen==NULL)
+		{
+		    return;
+		}
+		const std::vector<value_type>& fluxes=ps_gen->get_equivalent_fluxes();
+		value_type f(0);
+		for(size_type k=0;k<fluxes.size();++k)
+		{
+		    f+=fluxes[k];
+		}
+		if(!(f>(value_type)0))
+		{
+		    return;
+		}
+		value_type rho=rn_stream::throw_number((value_type)0,f);
+		for(flavour=0;flavour<fluxes.size()-1;++flavour)
+		{
+		    rho-=fluxes[flavour];
+		    if(rho<(value_type)0)
+		    {
+			break;
+		    }
+		}
+	    }
+
+	    /* Adds the contributions of the summed subprocesses to the argument
+	     * integrand of this instance and selects the subprocess recorded in
+	     * the event: */
+
+	    value_type add_summed_integrands(const value_type& f)
+	    {
+		summed_proc=0;
+		if(summed_procs.empty())
+		{
+		    return f;
+		}
+		value_type w=hel_weight*col_weight;
+		value_type result=f;
+		summed_integrands[0]=f;
+		for(size_type k=0;k<summed_procs.size();++k)
+		{
+		    summed_integrands[k+1]=(w==(value_type)0)?(value_type)0:(summed_procs[k]->summed_integrand(this)/w);
+		    result+=summed_integrands[k+1];
+		}
+		if(!(result>(value_type)0))
+		{
+		    return result;
+		}
+		value_type rho=rn_stream::throw_number((value_type)0,result);
+		for(summed_proc=0;summed_proc<summed_procs.size();++summed_proc)
+		{
+		    rho-=summed_integrands[summed_proc];
+		    if(rho<(value_type)0)
+		    {
+			break;
+		    }
+		}
+		if(summed_proc!=0)
+		{
+		    summed_procs[summed_proc-1]->select_summed_flavour(this);
+		}
+		return result;
+	    }
+
+	    /* Returns the incoming partons of the k-th subprocess sharing the
+	     * amplitude: */
+
+	    vector<int,N_in> equivalent_partons(size_type k) const
+	    {
+		vector<int,N_in>result;
+		for(size_type i=0;i<N_in;++i)
+		{
+		    result[i]=flavours.empty()?(particle_in(i)->particle_type->get_pdg_id()):(flavours[k][i]);
+		}
+		return result;
+	    }
+
+	    /* Evaluates the matrix element, summed over all helicities and
+	     * colours, at the phase space point of the argument generator and
+	     * returns the contribution to its integrand: */
+
+	    value_type summed_integrand(process_generator<model_t,N_in,N_out,rng_t>* gen)
+	    {
+		value_type flux(0);
+		for(size_type k=0;k<n_equivalent_processes();++k)
+		{
+		    flux+=gen->ps_gen->flux_factor(equivalent_partons(k));
+		}
+		if(flux==(value_type)0)
+		{
+		    return flux;
+		}
+		for(size_type i=0;i<N_in+N_out;++i)
+		{
+		    amplitude->get_phase_space(i)->momentum()=gen->amplitude->get_phase_space(i)->momentum();
+		}
+		amplitude->reset();
+		if(summed_spins.any() or summed_colours.any())
+		{
+		    me=amplitude->evaluate(summed_spins,summed_colours);
+		}
+		else
+		{
+		    me=std::norm(amplitude->evaluate());
+		}
+		if(!accept(me))
+		{
+		    return (value_type)0;
+		}
+		return pb_conversion*symmetry_factor*gen->ps_gen->ps_factor*hel_factor*col_factor*flux*me;
+	    }
+
+	    /* Selects the subprocess sharing the amplitude for the event record
+	     * according to the incoming fluxes at the phase space point of the
+	     * argument generator: */
+
+	    void select_summed_flavour(process_generator<model_t,N_in,N_out,rng_t>* gen)
+	    {
+		flavour=0;
+		if(flavours.size()<2)
+		{
+		    return;
+		}
+		std::vector<value_type>fluxes(flavours.size());
+		value_type f(0);
+		for(size_type k=0;k<flavours.size();++k)
+		{
+		    fluxes[k]=gen->ps_gen->flux_factor(equivalent_partons(k));
+		    f+=fluxes[k];
+		}
+		if(!(f>(value_type)0))
+		{
+		    return;
+		}
+		value_type rho=rn_stream::throw_number((value_type)0,f);
+		for(flavour=0;flavour<fluxes.size()-1;++flavour)
+		{
+		    rho-=fluxes[flavour];
+		    if(rho<(value_type)0)
+		    {
+			break;
+		    }
+		}
+	    }
+
 	    /* Event generation helper: */
 
 	    bool throw_event()
@@ -1824,18 +2186,19 @@ namespace Camgen
 		}
 		else
 		{
+		    select_flavour();
 		    this->weight()=ps_weight*hel_weight*col_weight;
 		    value_type f=pb_conversion*symmetry_factor*ps_factor*hel_factor*col_factor;
-		    if(f!=(value_type)0)
+		    if(f!=(value_type)0 or !summed_procs.empty())
 		    {
 			evaluate_amplitude();
 			if(accept(me))
 			{
-			    set_integrands(me*f);
+			    set_integrands(add_summed_integrands(me*f));
 			}
 			else
 			{
-			    set_integrands(0);
+			    set_integrands(add_summed_integrands(0));
 			}
 		    }
 		    else
@@ -272,6 +272,13 @@ namespace Camgen
 		return tree_it;
 	    }
 
+	    /* Tree iterator assignment (used when copying tree lists): */
+
+	    void set_tree(tree_iterator it)
+	    {
+		tree_it=it;
+	    }
+
 	    /* Function returning the vector of flavour integers corresponding
 	     * to the process: */
 
@@ -10,9 +10,14 @@
 
 #include <list>
 #include <set>
+#include <map>
+#include <functional>
 #include <Camgen/current_tree.h>
 #include <Camgen/interaction.h>
 #include <Camgen/bspart.h>
+#include <Camgen/int_sched.h>
+#include <Camgen/dof_amps.h>
+#include <Camgen/bin_io.h>
 #include <Camgen/def_args.h>
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -98,7 +103,8 @@ namespace Camgen
 		/* Copying initial current addresses to the process tree: */
 
 		init_currents.reserve(N_bits);
-		current_iterator it=current_tree_type::begin();
+		bit_string<N_bits>b;
+		b.set(0);
 		for(size_type i=0;i<N_in;++i)
 		{
 		    if(in[i]==NULL)
@@ -107,8 +113,8 @@ namespace Camgen
 		    }
 		    if(i != current_tree_type::final_current())
 		    {
-			init_currents.push_back(it+in[i]->get_flavour());
-			it+=flavours;
+			init_currents.push_back(current_tree_type::find_current(b,in[i]));
+			b.next();
 		    }
 		}
 		for(size_type i=0;i<N_out;++i)
@@ -119,21 +125,21 @@ namespace Camgen
 		    }
 		    if(i != (N_final-N_in))
 		    {
-			init_currents.push_back(it+out[i]->get_flavour());
-			it+=flavours;
+			init_currents.push_back(current_tree_type::find_current(b,out[i]));
+			b.next();
 		    }
 		}
 
 		/* Copying final current addresses to the process tree: */
 
-		it=current_tree_type::end()-flavours;
+		b.reset();
 		if(N_final<N_in)
 		{
-		    final_current=it+in[N_final]->get_flavour();
+		    final_current=current_tree_type::find_current(b,in[N_final]);
 		}
 		else
 		{
-		    final_current=it+out[N_final-N_in]->get_flavour();
+		    final_current=current_tree_type::find_current(b,out[N_final-N_in]);
 		}
 		evaluate_symmetry_factor();
 	    }
@@ -145,11 +151,296 @@ namespace Camgen
 	    {
 		for(size_type i=0;i<init_currents.size();++i)
 		{
-		    init_currents[i]->mark();
+		    current_tree_type::mark(init_currents[i]);
 		}
 		B.set(N_bits-1);
 		level=1;
-		final_current->mark();
+		current_tree_type::mark(final_current);
+		schedule.clear();
+		dof_amps.clear();
+	    }
+
+	    /* Requests the currents that can be produced during the
+	     * construction of the tree from the current tree. The momentum
+	     * channels are traversed in the order of the build, combining the
+	     * flavours reachable in the partitions of each channel: */
+
+	    void request_currents() const
+	    {
+		std::vector< std::vector<const particle_type*> >produced(1<<N_bits);
+		for(size_type i=0;i<N_bits;++i)
+		{
+		    produced[init_currents[i]->get_bit_string().to_integer()].push_back(init_currents[i]->get_produced_particle());
+		}
+		const particle_type* final_anti_particle=final_current->get_produced_particle()->get_anti_particle();
+		bit_string<N_bits>b;
+		b.set(N_bits-1);
+		for(size_type i=0;i<(1<<N_bits)-N_bits-1;++i)
+		{
+		    b.next();
+		    bool last=(b.count()==N_bits);
+		    std::vector<const particle_type*>& prod=produced[b.to_integer()];
+		    size_type legs=std::min(b.count(),max_rank-1);
+		    for(size_type n=2;n<=legs;++n)
+		    {
+			std::vector< std::vector< bit_string<N_bits> > >parts=bit_string_partition<N_bits>::make_partition(b,n);
+			std::vector<const std::vector<const particle_type*>*>lists(n);
+			std::vector<size_type>indices(n);
+			std::vector<const particle_type*>partvec(n);
+			for(size_type j=0;j<parts.size();++j)
+			{
+			    bool abort=false;
+			    for(size_type k=0;k<n;++k)
+			    {
+				lists[k]=&produced[parts[j][k].to_integer()];
+				indices[k]=0;
+				if(lists[k]->empty())
+				{
+				    abort=true;
+				    break;
+				}
+			    }
+			    if(abort)
+			    {
+				continue;
+			    }
+
+			    /* Loop over all flavour combinations of the
+			     * partition: */
+
+			    size_type k;
+			    do
+			    {
+				for(k=0;k<n;++k)
+				{
+				    partvec[k]=(*lists[k])[indices[k]];
+				}
+				std::pair<fusion_iterator,fusion_iterator>iterpair=model_wrapper<model_t>::find_fusion(partvec);
+				for(fusion_iterator f_iter=iterpair.first;f_iter!=iterpair.second;++f_iter)
+				{
+				    const particle_type* phi=f_iter->second.get_produced_particle();
+				    if(last and phi!=final_anti_particle)
+				    {
+					continue;
+				    }
+				    if(std::find(prod.begin(),prod.end(),phi)==prod.end())
+				    {
+					prod.push_back(phi);
+					current_tree_type::request_current(b,phi->get_flavour());
+				    }
+				}
+				for(k=n;k!=0;--k)
+				{
+				    if(++indices[k-1]<lists[k-1]->size())
+				    {
+					break;
+				    }
+				    indices[k-1]=0;
+				}
+			    }
+			    while(k!=0);
+			}
+		    }
+		}
+	    }
+
+	    /* Returns whether the tree refers to current data in the argument
+	     * range: */
+
+	    bool refers_to(const_current_iterator first,const_current_iterator last) const
+	    {
+		if(first==last)
+		{
+		    return false;
+		}
+		std::less<const current_type*>less;
+		const current_type* c=&(*final_current);
+		return !less(c,&(*first)) and less(c,&(*first)+(last-first));
+	    }
+
+	    /* Returns whether the argument tree is identical to this one up to a
+	     * relabelling of external and internal particles by equivalent
+	     * flavours (equal masses, widths and couplings), leg by leg. Such
+	     * trees yield the same amplitude for the same external momenta,
+	     * helicities and colours. Interactions producing the same momentum
+	     * channel are matched greedily, so equivalences may be missed, but
+	     * are never reported falsely: */
+
+	    bool is_equivalent(const process_tree<model_t,N_in,N_out>& other) const
+	    {
+		if(empty or other.empty or symm_factor!=other.symm_factor or interactions.size()!=other.interactions.size())
+		{
+		    return false;
+		}
+		current_map fwd,bwd;
+		std::vector<const current_type*>added;
+		for(size_type i=0;i<init_currents.size();++i)
+		{
+		    if(!map_current(&(*init_currents[i]),&(*other.init_currents[i]),fwd,bwd,added))
+		    {
+			return false;
+		    }
+		}
+		if(!map_current(&(*final_current),&(*other.final_current),fwd,bwd,added))
+		{
+		    return false;
+		}
+		const_interaction_iterator it=interactions.begin();
+		const_interaction_iterator it2=other.interactions.begin();
+		while(it!=interactions.end())
+		{
+		    /* Delimit the interactions producing the current channel in
+		     * both trees: */
+
+		    bit_string<N_bits>b=it->get_produced_bit_string();
+		    const_interaction_iterator last=it;
+		    size_type n=0;
+		    while(last!=interactions.end() and last->get_produced_bit_string()==b)
+		    {
+			++last;
+			++n;
+		    }
+		    const_interaction_iterator last2=it2;
+		    size_type n2=0;
+		    while(last2!=other.interactions.end() and last2->get_produced_bit_string()==b)
+		    {
+			++last2;
+			++n2;
+		    }
+		    if(n!=n2)
+		    {
+			return false;
+		    }
+
+		    /* Match each interaction to an unmatched one in the other
+		     * tree: */
+
+		    std::vector<bool>matched(n,false);
+		    for(;it!=last;++it)
+		    {
+			size_type k=0;
+			const_interaction_iterator it3=it2;
+			for(;it3!=last2;++it3,++k)
+			{
+			    if(!matched[k] and match_interaction(*it,*it3,fwd,bwd))
+			    {
+				matched[k]=true;
+				break;
+			    }
+			}
+			if(it3==last2)
+			{
+			    return false;
+			}
+		    }
+		    it2=last2;
+		}
+		return true;
+	    }
+
+	    /* Writes the external currents and interactions of the constructed
+	     * tree to a binary stream. Currents are labelled by their momentum
+	     * channel and flavour, and vertices by their index in the argument
+	     * map: */
+
+	    void write_cache(std::ostream& os,const std::map<const vertex_type*,unsigned>& vertex_indices) const
+	    {
+		for(size_type i=0;i<init_currents.size();++i)
+		{
+		    write_current(os,&(*init_currents[i]));
+		}
+		write_current(os,&(*final_current));
+		write_binary(os,(char)(empty?1:0));
+		write_binary(os,(unsigned)interactions.size());
+		for(const_interaction_iterator it=interactions.begin();it!=interactions.end();++it)
+		{
+		    write_binary(os,vertex_indices.find(it->get_vertex())->second);
+		    write_binary(os,(unsigned)(it->produced_current));
+		    write_binary(os,(unsigned)(it->currents.size()));
+		    for(size_type i=0;i<it->currents.size();++i)
+		    {
+			write_current(os,&(*(it->currents[i])));
+		    }
+		}
+	    }
+
+	    /* Reads a tree written by write_cache. Returns false if the data is
+	     * corrupt or its external currents differ from the ones of this
+	     * tree. If the second argument is false, only the produced currents
+	     * are requested from the current tree; otherwise, they should be
+	     * allocated and the interactions are inserted. The tree still needs
+	     * to be initialised and compiled afterwards: */
+
+	    bool read_cache(binary_reader& r,bool insert)
+	    {
+		for(size_type i=0;i<init_currents.size();++i)
+		{
+		    if(!read_current(r,&(*init_currents[i])))
+		    {
+			return false;
+		    }
+		}
+		if(!read_current(r,&(*final_current)))
+		{
+		    return false;
+		}
+		char e;
+		unsigned n;
+		if(!r.read(e) or !r.read(n))
+		{
+		    return false;
+		}
+		if(insert)
+		{
+		    interactions.clear();
+		    schedule.clear();
+		    dof_amps.clear();
+		    empty=(e!=0);
+		}
+		for(unsigned k=0;k<n;++k)
+		{
+		    unsigned v,leg,rank;
+		    if(!r.read(v) or !r.read(leg) or !r.read(rank) or v>=model_wrapper<model_t>::vertices())
+		    {
+			return false;
+		    }
+		    const vertex_type* vertex=model_wrapper<model_t>::get_vertex(v);
+		    if(rank!=vertex->get_rank() or leg>=rank)
+		    {
+			return false;
+		    }
+		    std::vector<current_iterator>currents(rank);
+		    for(unsigned i=0;i<rank;++i)
+		    {
+			long unsigned b;
+			unsigned flav;
+			if(!r.read(b) or !r.read(flav) or flav>=flavours)
+			{
+			    return false;
+			}
+			bit_string<N_bits>B=std::bitset<N_bits>(b);
+			if(insert)
+			{
+			    currents[i]=current_tree_type::find_current(B,(size_type)flav);
+			    if(currents[i]==current_tree_type::end())
+			    {
+				return false;
+			    }
+			}
+			else
+			{
+			    current_tree_type::request_current(B,flav);
+			}
+		    }
+		    if(insert)
+		    {
+			interaction_type node(vertex,leg);
+			node.insert_currents(currents);
+			node.fetch_Feynman_rule();
+			interactions.push_back(node);
+		    }
+		}
+		return r.good();
 	    }
 
 	    /* Tree building function: */
@@ -201,10 +492,13 @@ namespace Camgen
 		     * participating currents and their interactions: */
 
 		    reverse_interaction_iterator it=interactions.rbegin();
-		    it->mark();
+		    mark(*it);
 		    for(;it != interactions.rend();++it)
 		    {
-			it->mark_if();
+			if(current_tree_type::is_marked(it->get_produced_current()))
+			{
+			    mark(*it);
+			}
 		    }
 
 		    /* If the initial currents don't end up being marked, the
@@ -212,7 +506,7 @@ namespace Camgen
 
 		    for(size_type i=0;i<N_bits;++i)
 		    {
-			if(!(init_currents[i]->is_marked()))
+			if(!current_tree_type::is_marked(init_currents[i]))
 			{
 			    empty=true;
 			    interactions.clear();
@@ -338,6 +632,49 @@ namespace Camgen
 		}
 	    }
 
+	    /* Relocates the tree to a copy of the current data starting at the
+	     * second argument, where the first argument denotes the beginning of
+	     * the data the tree currently refers to: */
+
+	    void relocate(const_current_iterator from,current_iterator to)
+	    {
+		for(size_type i=0;i<init_currents.size();++i)
+		{
+		    init_currents[i]=to+(init_currents[i]-from);
+		}
+		final_current=to+(final_current-from);
+		for(interaction_iterator it=interactions.begin();it != interactions.end();++it)
+		{
+		    it->relocate(from,to);
+		}
+		assign_momenta();
+		if(!empty)
+		{
+		    final_current->set_argument(&(interactions.back().get_produced_current()->amplitude));
+		}
+		if(schedule.is_compiled())
+		{
+		    compile();
+		}
+	    }
+
+	    /* Lowers the interaction list to a flat instruction schedule, which
+	     * is used by the evaluation function afterwards. The schedule is
+	     * invalidated by rebuilding the tree and recompiled upon relocation:
+	     * */
+
+	    void compile()
+	    {
+		if(empty)
+		{
+		    schedule.clear();
+		}
+		else
+		{
+		    schedule.compile(interactions.begin(),interactions.end());
+		}
+	    }
+
 	    /* Computes all the coupling flags (this is done every evaluation
 	     * round...)*/
 
@@ -649,47 +986,101 @@ namespace Camgen
 
 	    r_value_type evaluate(std::bitset<N_in+N_out> summed_spins,std::bitset<N_in+N_out> summed_cols)
 	    {
+		return evaluate(summed_spins,summed_cols,dof_amplitude_values);
+	    }
+
+	    /* Spin summed amplitude evaluation, storing the amplitudes of all
+	     * summed configurations in the last argument, where the first
+	     * external leg runs fastest: */
+
+	    r_value_type evaluate(std::bitset<N_in+N_out> summed_spins,std::bitset<N_in+N_out> summed_cols,std::vector<value_type>& amplitudes)
+	    {
+		amplitudes.clear();
 		if(empty){return 0;}
 		r_value_type colsum_factor(1);
 		for(size_type i=0;i<N_final;++i)
 		{
-		    init_currents[i]->init_dof_sum(summed_spins[i],summed_cols[i]);
 		    if(summed_cols[i])
 		    {
 			colsum_factor*=(init_currents[i]->colour_sum_factor());
 		    }
 		}
-		final_current->init_dof_sum(summed_spins[N_final],summed_cols[N_final]);
 		if(summed_cols[N_final])
 		{
 		    colsum_factor*=(final_current->colour_sum_factor());
 		}
 		for(size_type i=N_final;i<init_currents.size();++i)
 		{
-		    init_currents[i]->init_dof_sum(summed_spins[i+1],summed_cols[i+1]);
 		    if(summed_cols[i+1])
 		    {
 			colsum_factor*=(init_currents[i]->colour_sum_factor());
 		    }
 		}
 		r_value_type summed_amplitude(0);
-		size_type counter=0;
-		do
+
+		/* Compute all configurations in a single pass if possible: */
+
+		if(dof_amps.evaluate(interactions.begin(),interactions.end(),init_currents,final_current,N_final,summed_spins,summed_cols,amplitudes))
 		{
-		    for(interaction_iterator it=interactions.begin();it!=interactions.end();++it)
+		    for(size_type i=0;i<amplitudes.size();++i)
 		    {
-			it->evaluate();
+			summed_amplitude+=std::norm(amplitudes[i]);
 		    }
-		    r_value_type M=std::norm(final_current->contract_wave_function());
-		    summed_amplitude+=M;
-		    ++counter;
+		    return colsum_factor*summed_amplitude;
+		}
+
+		/* Otherwise, loop over the configurations: */
+
+		for(size_type i=0;i<N_final;++i)
+		{
+		    init_currents[i]->init_dof_sum(summed_spins[i],summed_cols[i]);
+		}
+		final_current->init_dof_sum(summed_spins[N_final],summed_cols[N_final]);
+		for(size_type i=N_final;i<init_currents.size();++i)
+		{
+		    init_currents[i]->init_dof_sum(summed_spins[i+1],summed_cols[i+1]);
+		}
+
+		/* Only the interactions producing a current that depends on one
+		 * of the external legs changed by the last step of the dof loop
+		 * have to be reevaluated. Initially, all interactions are: */
+
+		std::bitset<N_bits>changed;
+		changed.set();
+		interaction_iterator last=--interactions.end();
+		bool proceed=true;
+		while(proceed)
+		{
 		    for(interaction_iterator it=interactions.begin();it!=interactions.end();++it)
 		    {
-			it->reset();
+			if((changed&(it->get_produced_bit_string())).any())
+			{
+			    it->evaluate();
+			}
 		    }
-		    (--interactions.end())->get_produced_current()->reset();
+		    amplitudes.push_back(final_current->contract_wave_function());
+		    summed_amplitude+=std::norm(amplitudes.back());
+		    proceed=next_dof_configuration(summed_spins,summed_cols,changed);
+		    if(proceed)
+		    {
+			for(interaction_iterator it=interactions.begin();it!=interactions.end();++it)
+			{
+			    if((changed&(it->get_produced_bit_string())).any())
+			    {
+				it->reset();
+			    }
+			}
+			if((changed&(last->get_produced_bit_string())).any())
+			{
+			    last->get_produced_current()->reset();
+			}
+		    }
+		}
+		for(interaction_iterator it=interactions.begin();it!=interactions.end();++it)
+		{
+		    it->reset();
 		}
-		while(next_dof_configuration(summed_spins,summed_cols));
+		last->get_produced_current()->reset();
 		return colsum_factor*summed_amplitude;
 	    }
 
@@ -708,9 +1099,16 @@ namespace Camgen
 
 		/* Evaluate all recursive relations: */
 
-		for(interaction_iterator it=interactions.begin();it != interactions.end();++it)
+		if(schedule.is_compiled())
 		{
-		    it->evaluate();
+		    schedule.evaluate();
+		}
+		else
+		{
+		    for(interaction_iterator it=interactions.begin();it != interactions.end();++it)
+		    {
+			it->evaluate();
+		    }
 		}
 
 		/* Evaluate the final-particle wave function: */
@@ -723,6 +1121,79 @@ namespace Camgen
 		return final_current->contract_wave_function();
 	    }
 
+	    /* Batched tree evaluation function. The argument trees should be
+	     * copies of the same tree, relocated to distinct current storage.
+	     * The recursion steps of the trees are interleaved, i.e. every
+	     * interaction is evaluated for all trees before proceeding to the
+	     * next one, and the amplitudes are written to the second argument: */
+
+	    static void evaluate_batch(const std::vector<process_tree<model_t,N_in,N_out>*>& trees,std::vector<value_type>& amplitudes)
+	    {
+		size_type n=trees.size();
+		amplitudes.assign(n,value_type(0,0));
+		if(n==0 or trees[0]->empty)
+		{
+		    return;
+		}
+
+		/* Reset the trees and evaluate the initial external wave
+		 * functions: */
+
+		for(size_type b=0;b<n;++b)
+		{
+		    trees[b]->reset();
+		}
+		for(size_type i=0;i<trees[0]->init_currents.size();++i)
+		{
+		    for(size_type b=0;b<n;++b)
+		    {
+			trees[b]->init_currents[i]->evaluate();
+		    }
+		}
+
+		/* Evaluate all recursive relations, one interaction at a time: */
+
+		bool compiled=true;
+		for(size_type b=0;b<n;++b)
+		{
+		    compiled&=trees[b]->schedule.is_compiled();
+		}
+		if(compiled)
+		{
+		    for(size_type i=0;i<trees[0]->schedule.size();++i)
+		    {
+			for(size_type b=0;b<n;++b)
+			{
+			    trees[b]->schedule.evaluate(i);
+			}
+		    }
+		}
+		else
+		{
+		    std::vector<interaction_iterator>its(n);
+		    for(size_type b=0;b<n;++b)
+		    {
+			its[b]=trees[b]->interactions.begin();
+		    }
+		    for(interaction_iterator it=trees[0]->interactions.begin();it!=trees[0]->interactions.end();++it)
+		    {
+			for(size_type b=0;b<n;++b)
+			{
+			    its[b]->evaluate();
+			    ++its[b];
+			}
+		    }
+		}
+
+		/* Evaluate the final wave functions and contract: */
+
+		for(size_type b=0;b<n;++b)
+		{
+		    trees[b]->final_current->evaluate();
+		    amplitudes[b]=trees[b]->final_current->contract_wave_function();
+		}
+	    }
+
 	    /* Function evaluating the next interaction/wave function w.r.t. the
 	     * counter: */
 
@@ -926,6 +1397,8 @@ namespace Camgen
 		B.reset();
 		interactions.clear();
 		empty=true;
+		schedule.clear();
+		dof_amps.clear();
 	    }
 
 	    /* Returns the symmetry factor: */
@@ -1012,6 +1485,18 @@ namespace Camgen
 	    /* List of interaction objects participating in the tree: */
 
 	    std::list<interaction_type>interactions;
+
+	    /* Compiled form of the interaction list: */
+
+	    interaction_schedule<model_t,N_bits,decomposes>schedule;
+
+	    /* Single-pass evaluation of summed dof configurations: */
+
+	    dof_amplitudes<model_t,N_in,N_out,decomposes>dof_amps;
+
+	    /* Amplitudes of the last summed dof configurations: */
+
+	    std::vector<value_type>dof_amplitude_values;
 	    
 	    /* Utility bit string: */
 	    
@@ -1049,13 +1534,110 @@ namespace Camgen
 	    
 	    std::vector< std::vector< bit_string<N_bits> > >partition;
 
+	    /* Writes the momentum channel and flavour of a current to a binary
+	     * stream: */
+
+	    static void write_current(std::ostream& os,const current_type* c)
+	    {
+		write_binary(os,(long unsigned)(c->get_bit_string().to_ulong()));
+		write_binary(os,(unsigned)(c->get_particle_type()->get_flavour()));
+	    }
+
+	    /* Reads a current label written by write_current and compares it
+	     * with the argument current: */
+
+	    static bool read_current(binary_reader& r,const current_type* c)
+	    {
+		long unsigned b;
+		unsigned flav;
+		if(!r.read(b) or !r.read(flav))
+		{
+		    return false;
+		}
+		return b==c->get_bit_string().to_ulong() and flav==(unsigned)(c->get_particle_type()->get_flavour());
+	    }
+
+	    /* Current correspondence map used by the equivalence analysis: */
+
+	    typedef std::map<const current_type*,const current_type*> current_map;
+
+	    /* Maps the current c1 to c2 in the forward map and vice versa in
+	     * the backward map, if consistent with the existing correspondence.
+	     * New entries are registered in the last argument: */
+
+	    static bool map_current(const current_type* c1,const current_type* c2,current_map& fwd,current_map& bwd,std::vector<const current_type*>& added)
+	    {
+		typename current_map::const_iterator it=fwd.find(c1);
+		if(it!=fwd.end())
+		{
+		    return (it->second==c2);
+		}
+		if(bwd.find(c2)!=bwd.end())
+		{
+		    return false;
+		}
+		if(!(c1->get_bit_string()==c2->get_bit_string()) or !(c1->get_particle_type()->is_equivalent(*(c2->get_particle_type()))))
+		{
+		    return false;
+		}
+		fwd[c1]=c2;
+		bwd[c2]=c1;
+		added.push_back(c1);
+		return true;
+	    }
+
+	    /* Returns whether the interactions are identical up to the current
+	     * correspondence, which is extended by the produced current upon
+	     * success and left untouched otherwise: */
+
+	    static bool match_interaction(const interaction_type& i1,const interaction_type& i2,current_map& fwd,current_map& bwd)
+	    {
+		if(i1.Feynman_rule!=i2.Feynman_rule or i1.produced_current!=i2.produced_current or i1.swap_fermions!=i2.swap_fermions or i1.Fermi_sign!=i2.Fermi_sign or i1.flow!=i2.flow or i1.coupled!=i2.coupled or i1.prop_policy!=i2.prop_policy or i1.currents.size()!=i2.currents.size())
+		{
+		    return false;
+		}
+		const std::vector<const value_type*>& g1=i1.get_vertex()->get_couplings();
+		const std::vector<const value_type*>& g2=i2.get_vertex()->get_couplings();
+		if(g1.size()!=g2.size())
+		{
+		    return false;
+		}
+		for(size_type i=0;i<g1.size();++i)
+		{
+		    if(*(g1[i])!=*(g2[i]))
+		    {
+			return false;
+		    }
+		}
+		std::vector<const current_type*>added;
+		for(size_type i=0;i<i1.currents.size();++i)
+		{
+		    if(!map_current(&(*(i1.currents[i])),&(*(i2.currents[i])),fwd,bwd,added))
+		    {
+			for(size_type j=0;j<added.size();++j)
+			{
+			    bwd.erase(fwd[added[j]]);
+			    fwd.erase(added[j]);
+			}
+			return false;
+		    }
+		}
+		return true;
+	    }
+
 	    /* function moving to the next helicity configuration of external
-	     * particles in a spin sum: */
+	     * particles in a spin sum. The bits of the external legs whose
+	     * wave functions were changed are set in the last argument: */
 
-	    bool next_dof_configuration(std::bitset<N_in+N_out>summed_spins,std::bitset<N_in+N_out>summed_cols)
+	    bool next_dof_configuration(std::bitset<N_in+N_out>summed_spins,std::bitset<N_in+N_out>summed_cols,std::bitset<N_bits>& changed)
 	    {
+		changed.reset();
 		for(size_type n=0;n<N_final;++n)
 		{
+		    if(summed_spins[n] or summed_cols[n])
+		    {
+			changed|=init_currents[n]->get_bit_string();
+		    }
 		    if(!init_currents[n]->evaluate_dof_sum(summed_spins[n],summed_cols[n]))
 		    {
 			return true;
@@ -1067,6 +1649,10 @@ namespace Camgen
 		}
 		for(size_type n=N_final+1;n<N_in+N_out;++n)
 		{
+		    if(summed_spins[n] or summed_cols[n])
+		    {
+			changed|=init_currents[n-1]->get_bit_string();
+		    }
 		    if(!init_currents[n-1]->evaluate_dof_sum(summed_spins[n],summed_cols[n]))
 		    {
 			return true;
@@ -1165,7 +1751,7 @@ namespace Camgen
 
 				    /* Mark it for future iterations: */
 
-				    prod_curr->mark();
+				    current_tree_type::mark(prod_curr);
 
 				    /* Construct the interaction from the fusion
 				     * class data: */
@@ -1300,7 +1886,7 @@ namespace Camgen
 
 					/* Mark it: */
 
-					prod_curr->mark();
+					current_tree_type::mark(prod_curr);
 
 					/* Construct the interaction from the fusion
 					 * class data: */
@@ -1342,34 +1928,15 @@ namespace Camgen
 		}
 	    }
 
-	    /* Function marking all currents participating in the tree: */
+	    /* Marks the argument interaction and its currents: */
 
-	    void mark_currents()
+	    static void mark(interaction_type& I)
 	    {
-		for(size_type i=0;i<N_bits;++i)
-		{
-		    init_currents[i]->mark();
-		}
-		for(interaction_iterator it=interactions.begin();it != interactions.end();++it)
-		{
-		    it->produced_current->mark();
-		}
-		final_current->mark();
-	    }
-
-	    /* Function unmarking all currents participating in the tree: */
-
-	    void unmark_currents()
-	    {
-		for(size_type i=0;i<N_bits;++i)
-		{
-		    init_currents[i]->unmark();
-		}
-		for(interaction_iterator it=interactions.begin();it != interactions.end();++it)
+		I.CM_tag=true;
+		for(size_type i=0;i<I.currents.size();++i)
 		{
-		    it->produced_current->unmark();
+		    current_tree_type::mark(I.currents[i]);
 		}
-		final_current->unmark();
 	    }
     };
     template<class model_t,std::size_t N_in,std::size_t N_out>const std::size_t process_tree<model_t,N_in,N_out>::N_bits;
@@ -528,6 +528,35 @@ namespace Camgen
 		}
 	    }
 
+	    /* Clears the statistics of all subchannels: */
+
+	    void reset_statistics()
+	    {
+		for(particle_channel_iterator it=particle_channels.begin();it!=particle_channels.end();++it)
+		{
+		    (*it)->reset_statistics();
+		}
+	    }
+
+	    /* Merges the statistics of the subchannels of the argument, a copy
+	     * of this channel: */
+
+	    bool merge_statistics(const momentum_channel<model_t,N_in,N_out,rng_t>* other)
+	    {
+		if(other==NULL or other->bitstring!=bitstring or other->particle_channels.size()!=particle_channels.size())
+		{
+		    return false;
+		}
+		bool q=true;
+		const_particle_channel_iterator it2=other->particle_channels.begin();
+		for(particle_channel_iterator it=particle_channels.begin();it!=particle_channels.end();++it)
+		{
+		    q&=(*it)->merge_statistics(*it2);
+		    ++it2;
+		}
+		return q;
+	    }
+
 	    /* Adapts all subchannels: */
 
 	    void adapt_grids()
@@ -20,6 +20,7 @@
 #include <Camgen/unused.h>
 #include <Camgen/CM_algo.h>
 #include <Camgen/MC_config.h>
+#include <Camgen/mt_utils.h>
 #include <Camgen/init_state.h>
 #include <Camgen/gen_conf.h>
 
@@ -62,7 +63,7 @@ namespace Camgen
 
 	    /// Constructor with initial state argument.
 
-	    ps_generator(init_state_type* is_):s_hat_sampling(!is_->s_hat_sampling),fsw(0),is(is_),isw(0),ps_cut(NULL),scale(NULL)
+	    ps_generator(init_state_type* is_):s_hat_sampling(!is_->s_hat_sampling),fsw(0),channel_time(0),is(is_),isw(0),ps_cut(NULL),scale(NULL)
 	    {
 		for(size_type i=0;i<N_in;++i)
 		{
@@ -393,6 +394,24 @@ namespace Camgen
 		adapt_channels();
 	    }
 
+	    /// Clears the grid and multichannel statistics collected since the
+	    /// last adaptation, keeping the grids and channel weights intact.
+
+	    virtual void reset_statistics()
+	    {
+		is->reset_statistics();
+	    }
+
+	    /// Adds the grid and multichannel statistics collected by the
+	    /// argument, a copy of this generator, to this instance. A
+	    /// subsequent adaptation then uses the statistics of both
+	    /// generators. Returns false if the generators are incompatible.
+
+	    virtual bool merge_statistics(const ps_generator<model_t,N_in,N_out>* other)
+	    {
+		return (other!=NULL and is->merge_statistics(other->is));
+	    }
+
 	    /// Replaces current multichannel weights by there optimal values,
 	    /// collected over several adaptations.
 
@@ -405,6 +424,7 @@ namespace Camgen
 	    {
 		this->base_type::reset();
 		is->reset();
+		channel_time=0;
 	    }
 
 	    /// Resets cross section of initial and final state generators.
@@ -622,6 +642,14 @@ namespace Camgen
 		return fsw;
 	    }
 
+	    /// Returns the time (in seconds) spent selecting channels since the
+	    /// last reset.
+
+	    double channel_selection_time() const
+	    {
+		return channel_time;
+	    }
+
 	    /// Returns the i-th beam energy.
 
 	    value_type beam_energy(int i) const
@@ -652,6 +680,52 @@ namespace Camgen
 		return is->flux_factor();
 	    }
 
+	    /// Incoming state flux factor of the argument partons. The partons
+	    /// of the instance are restored afterwards.
+
+	    value_type flux_factor(const vector<int,N_in>& partons)
+	    {
+		vector<int,N_in>own;
+		for(size_type i=0;i<N_in;++i)
+		{
+		    own[i]=is->parton_id(i);
+		    is->set_parton(i,partons[i]);
+		}
+		value_type result=flux_factor();
+		for(size_type i=0;i<N_in;++i)
+		{
+		    is->set_parton(i,own[i]);
+		}
+		return result;
+	    }
+
+	    /// Sets the incoming partons of the subprocesses sharing the
+	    /// amplitude, where the first entry should contain the partons of
+	    /// the instance tree. For more than one entry, the integrand
+	    /// contains the sum of the flux factors of all entries.
+
+	    void set_equivalent_partons(const std::vector< vector<int,N_in> >& v)
+	    {
+		equivalent_partons=v;
+		equivalent_fluxes.assign(v.size(),(value_type)0);
+	    }
+
+	    /// Returns the incoming partons of the subprocesses sharing the
+	    /// amplitude.
+
+	    const std::vector< vector<int,N_in> >& get_equivalent_partons() const
+	    {
+		return equivalent_partons;
+	    }
+
+	    /// Returns the flux factors of the subprocesses sharing the
+	    /// amplitude in the last generated or evaluated event.
+
+	    const std::vector<value_type>& get_equivalent_fluxes() const
+	    {
+		return equivalent_fluxes;
+	    }
+
 	    /// Returns the current factorisation scale.
 
 	    value_type mu_F() const
@@ -752,18 +826,18 @@ namespace Camgen
 		for(size_type i=0;i<N_in;++i)
 		{
 		    value_type s=spacetime_type::dot(p_in(i),p_in(i));
-		    if(!equals(s,s_in(i)))
+		    if(!equals(s,this->s_in(i)))
 		    {
-			log(log_level::warning)<<"incoming momentum "<<i<<": "<<p_in(i)<<" with mass-squared "<<s<<" not equal to "<<s_in(i)<<" detected"<<endlog;
+			log(log_level::warning)<<"incoming momentum "<<i<<": "<<p_in(i)<<" with mass-squared "<<s<<" not equal to "<<this->s_in(i)<<" detected"<<endlog;
 			q=false;
 		    }
 		}
 		for(size_type i=0;i<N_out;++i)
 		{
 		    value_type s=spacetime_type::dot(p_out(i),p_out(i));
-		    if(!equals(s,s_out(i)))
+		    if(!equals(s,this->s_out(i)))
 		    {
-			log(log_level::warning)<<"outgoing momentum "<<i<<": "<<p_out(i)<<" with mass-squared "<<s<<" not equal to "<<s_out(i)<<" detected"<<endlog;
+			log(log_level::warning)<<"outgoing momentum "<<i<<": "<<p_out(i)<<" with mass-squared "<<s<<" not equal to "<<this->s_out(i)<<" detected"<<endlog;
 			q=false;
 		    }
 		}
@@ -960,6 +1034,10 @@ namespace Camgen
 
 	    value_type fsw;
 
+	    /* Time spent in channel selection: */
+
+	    double channel_time;
+
 	    /// Sets the i-th incoming momentum (no range checking on i)
 
 	    void set_p_in(size_type i,momentum_type* p)
@@ -1040,7 +1118,26 @@ namespace Camgen
 
 	    void collect_integrand()
 	    {
-		this->integrand()=ps_factor*flux_factor();
+		if(equivalent_partons.size()<2)
+		{
+		    this->integrand()=ps_factor*flux_factor();
+		    return;
+		}
+		value_type f(0);
+		for(size_type k=0;k<equivalent_partons.size();++k)
+		{
+		    for(size_type i=0;i<N_in;++i)
+		    {
+			is->set_parton(i,equivalent_partons[k][i]);
+		    }
+		    equivalent_fluxes[k]=flux_factor();
+		    f+=equivalent_fluxes[k];
+		}
+		for(size_type i=0;i<N_in;++i)
+		{
+		    is->set_parton(i,equivalent_partons[0][i]);
+		}
+		this->integrand()=ps_factor*f;
 	    }
 
 	    /* Evaluates the generated weight: */
@@ -1091,6 +1188,14 @@ namespace Camgen
 	    /* Phase space cuts not depending on this instance: */
 
 	    scale_expression<value_type>* scale;
+
+	    /* Incoming partons of the subprocesses sharing the amplitude: */
+
+	    std::vector< vector<int,N_in> >equivalent_partons;
+
+	    /* Flux factors of the subprocesses sharing the amplitude: */
+
+	    std::vector<value_type>equivalent_fluxes;
     };
     template<class model_t,std::size_t N_in,std::size_t N_out>typename ps_generator<model_t,N_in,N_out>::value_type ps_generator<model_t,N_in,N_out>::ps_factor=std::pow((typename model_t::value_type)2*std::acos(-(typename model_t::value_type)1),(int)model_t::dimension-(int)(model_t::dimension-1)*(int)N_out);
 }
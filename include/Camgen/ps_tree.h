@@ -228,10 +228,13 @@ namespace Camgen
 
 	    bool choose_channel()
 	    {
+		double t0=wall_clock();
 		branching_sequence.clear();
 		branching_sequence.reserve(2*(1+N_out));
 		incoming_particle_channel->reset_generation_flags();
-		return incoming_particle_channel->choose_branching(branching_sequence);
+		bool q=incoming_particle_channel->choose_branching(branching_sequence);
+		this->channel_time+=(wall_clock()-t0);
+		return q;
 	    }
 
 	    /* Partonic CM-energy generation: */
@@ -429,6 +432,56 @@ namespace Camgen
 		incoming_momentum_channel->update(f);
 	    }
 
+	    /* Overrides the statistics resetting method: */
+
+	    void reset_statistics()
+	    {
+		this->base_type::reset_statistics();
+		for(typename branching_container::iterator it=ps_branchings.begin();it!=ps_branchings.end();++it)
+		{
+		    (*it)->reset_statistics();
+		}
+		for(size_type i=0;i<N_out;++i)
+		{
+		    outgoing_momentum_channels[i]->reset_statistics();
+		}
+		for(typename momentum_channel_container::iterator it=momentum_channels.begin();it!=momentum_channels.end();++it)
+		{
+		    (*it)->reset_statistics();
+		}
+		incoming_momentum_channel->reset_statistics();
+	    }
+
+	    /* Overrides the statistics merging method: */
+
+	    bool merge_statistics(const base_type* other)
+	    {
+		const ps_tree<model_t,1,N_out,rng_t>* t=dynamic_cast<const ps_tree<model_t,1,N_out,rng_t>*>(other);
+		if(t==NULL or t->ps_branchings.size()!=ps_branchings.size() or t->momentum_channels.size()!=momentum_channels.size())
+		{
+		    return false;
+		}
+		bool q=this->base_type::merge_statistics(other);
+		typename branching_container::const_iterator it2=t->ps_branchings.begin();
+		for(typename branching_container::iterator it=ps_branchings.begin();it!=ps_branchings.end();++it)
+		{
+		    q&=(*it)->merge_statistics(*it2);
+		    ++it2;
+		}
+		for(size_type i=0;i<N_out;++i)
+		{
+		    q&=outgoing_momentum_channels[i]->merge_statistics(t->outgoing_momentum_channels[i]);
+		}
+		typename momentum_channel_container::const_iterator it3=t->momentum_channels.begin();
+		for(typename momentum_channel_container::iterator it=momentum_channels.begin();it!=momentum_channels.end();++it)
+		{
+		    q&=(*it)->merge_statistics(*it3);
+		    ++it3;
+		}
+		q&=incoming_momentum_channel->merge_statistics(t->incoming_momentum_channel);
+		return q;
+	    }
+
 	    /* Overrides the vegas-grid adaptation method: */
 
 	    void adapt_grids()
@@ -1129,10 +1182,12 @@ namespace Camgen
 
 	    bool choose_channel()
 	    {
+		double t0=wall_clock();
 		branching_sequence.clear();
 		branching_sequence.reserve(2*(2+N_out));
 		incoming_particle_channels[0]->reset_generation_flags();
 		bool q=incoming_particle_channels[0]->choose_branching(branching_sequence);
+		this->channel_time+=(wall_clock()-t0);
 		return q;
 	    }
 
@@ -1438,6 +1493,58 @@ namespace Camgen
 		incoming_momentum_channels[1]->update(f);
 	    }
 
+	    /* Overrides the statistics resetting method: */
+
+	    void reset_statistics()
+	    {
+		this->base_type::reset_statistics();
+		for(typename branching_container::iterator it=ps_branchings.begin();it!=ps_branchings.end();++it)
+		{
+		    (*it)->reset_statistics();
+		}
+		for(size_type i=0;i<N_out;++i)
+		{
+		    outgoing_momentum_channels[i]->reset_statistics();
+		}
+		for(typename momentum_channel_container::iterator it=momentum_channels.begin();it!=momentum_channels.end();++it)
+		{
+		    (*it)->reset_statistics();
+		}
+		incoming_momentum_channels[0]->reset_statistics();
+		incoming_momentum_channels[1]->reset_statistics();
+	    }
+
+	    /* Overrides the statistics merging method: */
+
+	    bool merge_statistics(const base_type* other)
+	    {
+		const ps_tree<model_t,2,N_out,rng_t>* t=dynamic_cast<const ps_tree<model_t,2,N_out,rng_t>*>(other);
+		if(t==NULL or t->ps_branchings.size()!=ps_branchings.size() or t->momentum_channels.size()!=momentum_channels.size())
+		{
+		    return false;
+		}
+		bool q=this->base_type::merge_statistics(other);
+		typename branching_container::const_iterator it2=t->ps_branchings.begin();
+		for(typename branching_container::iterator it=ps_branchings.begin();it!=ps_branchings.end();++it)
+		{
+		    q&=(*it)->merge_statistics(*it2);
+		    ++it2;
+		}
+		for(size_type i=0;i<N_out;++i)
+		{
+		    q&=outgoing_momentum_channels[i]->merge_statistics(t->outgoing_momentum_channels[i]);
+		}
+		typename momentum_channel_container::const_iterator it3=t->momentum_channels.begin();
+		for(typename momentum_channel_container::iterator it=momentum_channels.begin();it!=momentum_channels.end();++it)
+		{
+		    q&=(*it)->merge_statistics(*it3);
+		    ++it3;
+		}
+		q&=incoming_momentum_channels[0]->merge_statistics(t->incoming_momentum_channels[0]);
+		q&=incoming_momentum_channels[1]->merge_statistics(t->incoming_momentum_channels[1]);
+		return q;
+	    }
+
 	    /* Overrides the vegas-grid adaptation method: */
 
 	    void adapt_grids()
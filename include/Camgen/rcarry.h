@@ -12,6 +12,8 @@
 #ifndef CAMGEN_RCARRY_H_
 #define CAMGEN_RCARRY_H_
 
+#include <cstddef>
+
 namespace Camgen
 {
     /// RCARRY random number stream, based on a 24-integer registry.
@@ -37,6 +39,16 @@ namespace Camgen
 
 	    rcarry();
 
+	    /// Substream constructor. Stream 0 coincides with the default
+	    /// sequence, other indices initialise the register by hashing the
+	    /// seeds with the stream index.
+
+	    rcarry(std::size_t stream);
+
+	    /// Resets the register to the argument substream.
+
+	    void set_stream(std::size_t stream);
+
 	    /// Throwing operator.
 
 	    result_type operator ()(void);
@@ -14,6 +14,7 @@
 
 #include <iostream>
 #include <cmath>
+#include <Camgen/mt_utils.h>
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * Wrapper class for random number generators. The first template parameter      *
@@ -21,7 +22,9 @@
  * template parameter denotes the random number generator class used. This class *
  * should contain the const static data members min_value and max_value,         *
  * denoting the minimum and maximum integers thrown and the operator (void) for  *
- * a throw.                                                                      *
+ * a throw. Engines supporting independent substreams provide a constructor    *
+ * from a stream index; the engine instance and call counter are thread-local,   *
+ * so every thread may select its own substream by set_stream().                 *
  *                                                                               *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
@@ -139,7 +142,7 @@ namespace Camgen
 		return (value_type)((*rng)()-min_value)*std::abs(max-min)/range+std::min(min,max);
 	    }
 
-	    /// Resets the engine.
+	    /// Resets the engine of the calling thread.
 
 	    static void reset_engine()
 	    {
@@ -148,6 +151,18 @@ namespace Camgen
 		counter=0;
 	    }
 
+	    /// Resets the engine of the calling thread to the n-th independent
+	    /// substream. Requires rng_t to be constructible from a stream
+	    /// index. Throws reproduce for equal stream indices and engine
+	    /// seeds, irrespective of the thread invoking them.
+
+	    static void set_stream(std::size_t n)
+	    {
+		delete rng;
+		rng=new rn_engine(n);
+		counter=0;
+	    }
+
 	    value_type operator()(const value_type& min,const value_type& max) const
 	    {
 		return throw_number(min,max);
@@ -173,21 +188,21 @@ namespace Camgen
 		}
 	    }
 
-	    /* Static random number generator instance: */
+	    /* Static (thread-local) random number generator instance: */
 
-	    static rn_engine* rng;
+	    static CAMGEN_THREAD_LOCAL rn_engine* rng;
 	    
 	    /* Call counter: */
 	    
-	    static std::size_t counter;
+	    static CAMGEN_THREAD_LOCAL std::size_t counter;
     };
 
     template<class value_t,class rng_t>const typename random_number_stream<value_t,rng_t>::int_type random_number_stream<value_t,rng_t>::min_value;
     template<class value_t,class rng_t>const typename random_number_stream<value_t,rng_t>::int_type random_number_stream<value_t,rng_t>::max_value;
     template<class value_t,class rng_t>const typename random_number_stream<value_t,rng_t>::int_type random_number_stream<value_t,rng_t>::range_value;
-    template<class value_t,class rng_t>typename random_number_stream<value_t,rng_t>::rn_engine* random_number_stream<value_t,rng_t>::rng=NULL;
+    template<class value_t,class rng_t>CAMGEN_THREAD_LOCAL typename random_number_stream<value_t,rng_t>::rn_engine* random_number_stream<value_t,rng_t>::rng=NULL;
     template<class value_t,class rng_t>const typename random_number_stream<value_t,rng_t>::value_type random_number_stream<value_t,rng_t>::range=random_number_stream<value_t,rng_t>::range_value;
-    template<class value_t,class rng_t>std::size_t random_number_stream<value_t,rng_t>::counter=0;
+    template<class value_t,class rng_t>CAMGEN_THREAD_LOCAL std::size_t random_number_stream<value_t,rng_t>::counter=0;
 }
 
 #endif /*CAMGEN_RN_STRM_H_*/
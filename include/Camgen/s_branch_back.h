@@ -382,6 +382,33 @@ namespace Camgen
 		}
 	    }
 
+	    /* Statistics resetting method implementation: */
+
+	    void reset_statistics()
+	    {
+		this->base_type::reset_statistics();
+		if(theta_grid!=NULL)
+		{
+		    theta_grid->reset_statistics();
+		}
+	    }
+
+	    /* Statistics merging method implementation: */
+
+	    bool merge_statistics(const ps_branching<model_t,N_in,N_out,rng_t>* other)
+	    {
+		const backward_s_branching<model_t,N_in,N_out,rng_t,spacetime_type>* b=dynamic_cast<const backward_s_branching<model_t,N_in,N_out,rng_t,spacetime_type>*>(other);
+		if(b==NULL or !(this->base_type::merge_statistics(other)))
+		{
+		    return false;
+		}
+		if(theta_grid!=NULL and b->theta_grid!=NULL)
+		{
+		    return theta_grid->merge_statistics(*(b->theta_grid));
+		}
+		return (theta_grid==NULL and b->theta_grid==NULL);
+	    }
+
 	    /* Returns whether the branchings are equivalent: */
 
 	    bool equiv(const ps_branching<model_t,N_in,N_out,rng_t>* other) const
@@ -405,6 +405,19 @@ namespace Camgen
 
 	    virtual void update_weight(){}
 
+	    /// Clears the statistics collected by the adaptive grids.
+
+	    virtual void reset_statistics(){}
+
+	    /// Adds the grid statistics collected by the argument, a copy of
+	    /// this generator, to the adaptive grids. Returns false if the
+	    /// generators are incompatible.
+
+	    virtual bool merge_statistics(const s_generator<value_t,rng_t>* other)
+	    {
+		return true;
+	    }
+
 	    /* Public constant methods: */
 	    /*--------------------------*/
 
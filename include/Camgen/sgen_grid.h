@@ -232,6 +232,25 @@ namespace Camgen
 		}
 	    }
 
+	    /* Statistics resetting method: */
+
+	    void reset_statistics()
+	    {
+		grid->reset_statistics();
+	    }
+
+	    /* Statistics merging method: */
+
+	    bool merge_statistics(const map_type* other)
+	    {
+		const adaptive_s_generator<value_t,rng_t>* s=dynamic_cast<const adaptive_s_generator<value_t,rng_t>*>(other);
+		if(s==NULL)
+		{
+		    return false;
+		}
+		return grid->merge_statistics(*(s->grid));
+	    }
+
 	    /* Adaptive method: */
 
 	    void adapt()
@@ -13,6 +13,7 @@
 #include <Camgen/utils.h>
 #include <Camgen/tensor.h>
 #include <Camgen/vector.h>
+#include <Camgen/mt_utils.h>
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * Massless spinor factory class definition. It constructs the massless basic  *
@@ -635,9 +636,9 @@ namespace Camgen
 
 	    /* temporary spinors: */
 
-	    static tensor_type temp1;
-	    static tensor_type temp2;
-	    static tensor_type temp3;
+	    static CAMGEN_THREAD_LOCAL tensor_type temp1;
+	    static CAMGEN_THREAD_LOCAL tensor_type temp2;
+	    static CAMGEN_THREAD_LOCAL tensor_type temp3;
     };
 
     template<class Dirac_alg_t,int beam_dir>typename massless_spinor_factory<Dirac_alg_t,beam_dir,4>::tensor_type massless_spinor_factory<Dirac_alg_t,beam_dir,4>::u_p(1,4);
@@ -646,9 +647,9 @@ namespace Camgen
     template<class Dirac_alg_t,int beam_dir>typename massless_spinor_factory<Dirac_alg_t,beam_dir,4>::tensor_type massless_spinor_factory<Dirac_alg_t,beam_dir,4>::u_m_bar(1,4);
     template<class Dirac_alg_t,int beam_dir>typename massless_spinor_factory<Dirac_alg_t,beam_dir,4>::tensor_type massless_spinor_factory<Dirac_alg_t,beam_dir,4>::u_2_p(1,4);
     template<class Dirac_alg_t,int beam_dir>typename massless_spinor_factory<Dirac_alg_t,beam_dir,4>::tensor_type massless_spinor_factory<Dirac_alg_t,beam_dir,4>::u_2_m(1,4);
-    template<class Dirac_alg_t,int beam_dir>typename massless_spinor_factory<Dirac_alg_t,beam_dir,4>::tensor_type massless_spinor_factory<Dirac_alg_t,beam_dir,4>::temp1(1,4);
-    template<class Dirac_alg_t,int beam_dir>typename massless_spinor_factory<Dirac_alg_t,beam_dir,4>::tensor_type massless_spinor_factory<Dirac_alg_t,beam_dir,4>::temp2(1,4);
-    template<class Dirac_alg_t,int beam_dir>typename massless_spinor_factory<Dirac_alg_t,beam_dir,4>::tensor_type massless_spinor_factory<Dirac_alg_t,beam_dir,4>::temp3(1,4);
+    template<class Dirac_alg_t,int beam_dir>CAMGEN_THREAD_LOCAL typename massless_spinor_factory<Dirac_alg_t,beam_dir,4>::tensor_type massless_spinor_factory<Dirac_alg_t,beam_dir,4>::temp1(1,4);
+    template<class Dirac_alg_t,int beam_dir>CAMGEN_THREAD_LOCAL typename massless_spinor_factory<Dirac_alg_t,beam_dir,4>::tensor_type massless_spinor_factory<Dirac_alg_t,beam_dir,4>::temp2(1,4);
+    template<class Dirac_alg_t,int beam_dir>CAMGEN_THREAD_LOCAL typename massless_spinor_factory<Dirac_alg_t,beam_dir,4>::tensor_type massless_spinor_factory<Dirac_alg_t,beam_dir,4>::temp3(1,4);
     template<class Dirac_alg_t,int beam_dir>typename massless_spinor_factory<Dirac_alg_t,beam_dir,4>::momentum_type massless_spinor_factory<Dirac_alg_t,beam_dir,4>::k_0;
     template<class Dirac_alg_t,int beam_dir>typename massless_spinor_factory<Dirac_alg_t,beam_dir,4>::momentum_type massless_spinor_factory<Dirac_alg_t,beam_dir,4>::k_1;
     template<class Dirac_alg_t,int beam_dir>typename massless_spinor_factory<Dirac_alg_t,beam_dir,4>::momentum_type massless_spinor_factory<Dirac_alg_t,beam_dir,4>::k_2;
@@ -13,9 +13,13 @@
 #define CAMGEN_STDRAND_H_
 
 #include <cstdlib>
+#include <cstddef>
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * Wrapper class for the standard library random number generator. *
+ * Since the state of rand() is global, instances constructed from *
+ * a stream index use a private minimal-standard Lehmer generator  *
+ * instead, seeded by hashing the seed with the stream index.      *
  *                                                                 *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
@@ -44,9 +48,24 @@ namespace std
 
 	    random();
 
+	    /// Substream constructor, yielding an independent private
+	    /// stream.
+
+	    random(std::size_t stream);
+
 	    /// Throwing operator.
 
 	    result_type operator ()(void);
+
+	private:
+
+	    /* Flag denoting a private stream: */
+
+	    bool local;
+
+	    /* Private stream state: */
+
+	    long state;
     };
 }
 
@@ -8,9 +8,9 @@
 #ifndef CAMGEN_TYPE_HOLDERS_H_
 #define CAMGEN_TYPE_HOLDERS_H_
 
-#include <set>
 #include <Camgen/unused.h>
 #include <Camgen/tensor.h>
+#include <Camgen/iter_set.h>
 #include <Camgen/forward_decs.h>
 #include <Camgen/phase_space.h>
 
@@ -147,7 +147,7 @@ namespace Camgen
 	    typedef typename tensor<value_type>::iterator iterator;
 	    typedef vector<r_value_type,model_t::dimension> momentum_type;
 	public:
-	    typedef void(*vert_func)(const value_type&,const std::vector<const value_type*>&,std::vector<iterator>&,const std::vector<const momentum_type*>&,std::set<iterator>&);	    
+	    typedef void(*vert_func)(const value_type&,const std::vector<const value_type*>&,std::vector<iterator>&,const std::vector<const momentum_type*>&,iterator_set<iterator>&);	    
 	    template<class Feynrule_t>class apply
 	    {
 		public:
@@ -90,6 +90,40 @@ namespace Camgen
 		wsum+=w;
 	    }
 
+	    /// Adds the bin contents of the argument histogram. The histogram
+	    /// with the smaller maximal weight is rebinned to the larger one
+	    /// first, so the merge is exact if both have identical binnings.
+
+	    void merge(const weight_histogrammer<value_t>& other)
+	    {
+		if(other.freqs.size()<2 or freqs.size()<2)
+		{
+		    return;
+		}
+		if(other.maxw>maxw)
+		{
+		    rebin(other.maxw);
+		    maxw=other.maxw;
+		}
+		if(other.maxw==maxw and other.freqs.size()==freqs.size())
+		{
+		    for(size_type i=0;i<freqs.size();++i)
+		    {
+			freqs[i]+=other.freqs[i];
+		    }
+		}
+		else
+		{
+		    weight_histogrammer<value_t>h(other);
+		    h.rebin(maxw,freqs.size());
+		    for(size_type i=0;i<freqs.size();++i)
+		    {
+			freqs[i]+=h.freqs[i];
+		    }
+		}
+		wsum+=other.wsum;
+	    }
+
 	    /* Public readout methods: */
 	    /*-------------------------*/
 
@@ -313,14 +347,22 @@ namespace Camgen
 	     * last bin and the number of bins is not changed. */
 
 	    void rebin(const value_type& w)
+	    {
+		rebin(w,freqs.size());
+	    }
+
+	    /* Rebins such that the new maximal weight w is contained in the
+	     * last of n bins. */
+
+	    void rebin(const value_type& w,size_type n)
 	    {
 		if(w<maxw)
 		{
 		    return;
 		}
 		value_type oldwidth=bin_width();
-		value_type newwidth=w/(freqs.size()-1);
-		std::vector<value_type>newfreqs(freqs.size());
+		value_type newwidth=w/(n-1);
+		std::vector<value_type>newfreqs(n);
 		bin_iterator it(freqs.begin());
 		for(size_type i=0;i<newfreqs.size()-1;++i)
 		{
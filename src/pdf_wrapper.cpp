@@ -7,7 +7,9 @@
 
 #include <cmath>
 #include <limits>
+#include <algorithm>
 #include <config.h>
+#include <Camgen/mt_utils.h>
 #include <Camgen/pdf_wrapper.h>
 
 #if HAVE_LHAPDF_H_
@@ -19,6 +21,64 @@ namespace Camgen
     bool pdf_wrapper::init=false;
     std::string pdf_wrapper::setname;
     int pdf_wrapper::setnr=0;
+    bool pdf_wrapper::use_cache=true;
+    std::vector<double> pdf_wrapper::grid;
+    int pdf_wrapper::nx=0;
+    int pdf_wrapper::nq=0;
+    double pdf_wrapper::vx0=0;
+    double pdf_wrapper::vx1=0;
+    double pdf_wrapper::dvx=0;
+    double pdf_wrapper::lnq0=0;
+    double pdf_wrapper::lnq1=0;
+    double pdf_wrapper::dlnq=0;
+
+    /* Grid node densities per decade in x and Q^2: */
+
+    static const double x_nodes_per_decade=40;
+    static const double q_nodes_per_decade=20;
+
+    /* Linear term in the grid variable of x, refining the nodes at large x: */
+
+    static const double x_stretch=10;
+
+    /* Lock guarding the global LHAPDF state: */
+
+    static mutex LHAPDF_mutex;
+
+    /* Cubic Lagrange weights of the nodes -1,0,1,2 at the argument
+     * position: */
+
+    static void cubic_weights(double t,double* w)
+    {
+	w[0]=-t*(t-1)*(t-2)/6;
+	w[1]=(t+1)*(t-1)*(t-2)/2;
+	w[2]=-(t+1)*t*(t-2)/2;
+	w[3]=(t+1)*t*(t-1)/6;
+    }
+
+    /* Grid variable of the momentum fraction x: */
+
+    static double grid_variable(double x)
+    {
+	return std::log(x)+x_stretch*x;
+    }
+
+    /* Inverse of the grid variable, by Newton iteration: */
+
+    static double grid_point(double v)
+    {
+	double x=std::min(std::exp(v),(double)1);
+	for(int i=0;i<50;++i)
+	{
+	    double dx=x*(std::log(x)+x_stretch*x-v)/((double)1+x_stretch*x);
+	    x=std::max(x-dx,(double)0.5*x);
+	    if(std::abs(dx)<std::numeric_limits<double>::epsilon()*x)
+	    {
+		break;
+	    }
+	}
+	return x;
+    }
 
     void pdf_wrapper::initialise(const char* setname_, int setnr_)
     {
@@ -29,8 +89,13 @@ namespace Camgen
 	    setnr=setnr_;
 	    LHAPDF::initPDFSet(setname.c_str());
 	    LHAPDF::initPDF(setnr);
+	    grid.clear();
 	}
 	init=true;
+	if(use_cache and grid.empty())
+	{
+	    fill_grid();
+	}
     }
 
     void pdf_wrapper::reset()
@@ -38,6 +103,7 @@ namespace Camgen
 	setname.clear();
 	setnr=0;
 	init=false;
+	grid.clear();
     }
 
     double pdf_wrapper::xmin()
@@ -90,30 +156,153 @@ namespace Camgen
 
     double pdf_wrapper::xf(double x,int q,double mu)
     {
-	return init?LHAPDF::xfx(x,mu,q):x;
+	if(!init)
+	{
+	    return x;
+	}
+	double result;
+	evaluate(x,mu,q,q,&result);
+	return result;
     }
 
     double pdf_wrapper::f(double x,int q,double mu)
     {
-	return init?(LHAPDF::xfx(x,mu,q)/x):(double)1;
+	return init?(xf(x,q,mu)/x):(double)1;
     }
 
     double pdf_wrapper::ff(double x1,double x2,int q1,int q2,double mu)
     {
 	if(init)
 	{
-	    double xfx1=LHAPDF::xfx(x1,mu,q1);
-	    double xfx2=LHAPDF::xfx(x2,mu,q2);
+	    double xfx1,xfx2;
+	    evaluate(x1,mu,q1,q1,&xfx1);
+	    evaluate(x2,mu,q2,q2,&xfx2);
 	    double symm=(q1==q2)?double(0.5):double(1);
 	    return (xfx1>(double)0 and xfx2>(double)0)?(symm*xfx1*xfx2/(x1*x2)):(double)0;
 	}
 	return (double)0.5;
     }
 
+    void pdf_wrapper::xf(double x,double mu,double* xfs)
+    {
+	if(!init)
+	{
+	    std::fill(xfs,xfs+n_partons,x);
+	    return;
+	}
+	evaluate(x,mu,-6,6,xfs);
+    }
+
+    void pdf_wrapper::ff(double x1,double x2,const int* q1,const int* q2,std::size_t n,double mu,double* result)
+    {
+	if(!init)
+	{
+	    std::fill(result,result+n,(double)0.5);
+	    return;
+	}
+	double xfx1[n_partons],xfx2[n_partons];
+	evaluate(x1,mu,-6,6,xfx1);
+	evaluate(x2,mu,-6,6,xfx2);
+	for(std::size_t i=0;i<n;++i)
+	{
+	    double f1=xfx1[q1[i]+6];
+	    double f2=xfx2[q2[i]+6];
+	    double symm=(q1[i]==q2[i])?double(0.5):double(1);
+	    result[i]=(f1>(double)0 and f2>(double)0)?(symm*f1*f2/(x1*x2)):(double)0;
+	}
+    }
+
     double pdf_wrapper::alpha_s(double mu)
     {
+	scoped_lock lock(LHAPDF_mutex);
 	return init?LHAPDF::alphasPDF(mu):double(-1);
     }
+
+    void pdf_wrapper::set_cache(bool q)
+    {
+	use_cache=q;
+	if(!use_cache)
+	{
+	    grid.clear();
+	}
+    }
+
+    bool pdf_wrapper::cached()
+    {
+	return !grid.empty();
+    }
+
+    void pdf_wrapper::fill_grid()
+    {
+	vx0=grid_variable(LHAPDF::getXmin(setnr));
+	vx1=grid_variable(LHAPDF::getXmax(setnr));
+	lnq0=std::log(LHAPDF::getQ2min(setnr));
+	lnq1=std::log(LHAPDF::getQ2max(setnr));
+	nx=std::max(4,(int)std::ceil(x_nodes_per_decade*(vx1-vx0)/std::log(10.))+1);
+	nq=std::max(4,(int)std::ceil(q_nodes_per_decade*(lnq1-lnq0)/std::log(10.))+1);
+	dvx=(vx1-vx0)/(nx-1);
+	dlnq=(lnq1-lnq0)/(nq-1);
+	grid.resize(nx*nq*n_partons);
+	std::vector<double>::iterator it=grid.begin();
+	for(int i=0;i<nx;++i)
+	{
+	    double x=std::min(grid_point(vx0+i*dvx),LHAPDF::getXmax(setnr));
+	    for(int j=0;j<nq;++j)
+	    {
+		double mu=std::exp((double)0.5*(lnq0+j*dlnq));
+		std::vector<double>xfs=LHAPDF::xfx(x,mu);
+		it=std::copy(xfs.begin(),xfs.begin()+n_partons,it);
+	    }
+	}
+    }
+
+    bool pdf_wrapper::interpolate(double x,double mu,int qmin,int qmax,double* xfs)
+    {
+	if(grid.empty() or !(x>(double)0) or !(mu>(double)0))
+	{
+	    return false;
+	}
+	double vx=grid_variable(x);
+	double lnq=(double)2*std::log(mu);
+	if(vx<vx0 or vx>vx1 or lnq<lnq0 or lnq>lnq1)
+	{
+	    return false;
+	}
+	double u=(vx-vx0)/dvx;
+	double v=(lnq-lnq0)/dlnq;
+	int i=std::min(std::max((int)u,1),nx-3);
+	int j=std::min(std::max((int)v,1),nq-3);
+	double wx[4],wq[4];
+	cubic_weights(u-i,wx);
+	cubic_weights(v-j,wq);
+	std::fill(xfs,xfs+(qmax-qmin+1),(double)0);
+	for(int k=0;k<4;++k)
+	{
+	    for(int l=0;l<4;++l)
+	    {
+		double w=wx[k]*wq[l];
+		const double* node=&grid[((i+k-1)*nq+(j+l-1))*n_partons+6];
+		for(int q=qmin;q<=qmax;++q)
+		{
+		    xfs[q-qmin]+=w*node[q];
+		}
+	    }
+	}
+	return true;
+    }
+
+    void pdf_wrapper::evaluate(double x,double mu,int qmin,int qmax,double* xfs)
+    {
+	if(interpolate(x,mu,qmin,qmax,xfs))
+	{
+	    return;
+	}
+	scoped_lock lock(LHAPDF_mutex);
+	for(int q=qmin;q<=qmax;++q)
+	{
+	    xfs[q-qmin]=LHAPDF::xfx(x,mu,q);
+	}
+    }
 }
 
 #else
@@ -123,6 +312,7 @@ namespace Camgen
     bool pdf_wrapper::init=true;
     std::string pdf_wrapper::setname;
     int pdf_wrapper::setnr=0;
+    bool pdf_wrapper::use_cache=false;
 
     void pdf_wrapper::initialise(const char* setname_, int setnr_){}
 
@@ -183,10 +373,33 @@ namespace Camgen
 	return (double)1;
     }
 
+    void pdf_wrapper::xf(double x,double mu,double* xfs)
+    {
+	for(int i=0;i<n_partons;++i)
+	{
+	    xfs[i]=x;
+	}
+    }
+
+    void pdf_wrapper::ff(double x1,double x2,const int* q1,const int* q2,std::size_t n,double mu,double* result)
+    {
+	for(std::size_t i=0;i<n;++i)
+	{
+	    result[i]=(double)1;
+	}
+    }
+
     double pdf_wrapper::alpha_s(double mu)
     {
 	return double(-1);
     }
+
+    void pdf_wrapper::set_cache(bool q){}
+
+    bool pdf_wrapper::cached()
+    {
+	return false;
+    }
 }
 
 #endif /*HAVE_LHAPDF_H_*/
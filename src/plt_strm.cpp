@@ -62,6 +62,10 @@ namespace Camgen
     
     int data_wrapper::tempfiles=0;
 
+    /* Number of buffered characters written to the data file at once: */
+
+    static const std::size_t buffer_size=1<<16;
+
     /* Temporary-file mode data wrapper constructor with 2 leafs: */
 
     data_wrapper::data_wrapper(const void* var1,const void* var2):valid(true),tempfile(true),users(0),open(false)
@@ -135,9 +139,14 @@ namespace Camgen
 	{
 	    for(std::vector<const double*>::size_type i=0;i<data.size();++i)
 	    {
-		datastream<<*(data[i])<<"\t";
+		buffer.put_shortest(*(data[i]));
+		buffer.put('\t');
+	    }
+	    buffer.put('\n');
+	    if(buffer.size()>=buffer_size)
+	    {
+		buffer.write(datastream);
 	    }
-	    datastream<<std::endl;
 	}
 	return (valid and open);
     }
@@ -148,6 +157,7 @@ namespace Camgen
     {
 	if(valid and open)
 	{
+	    buffer.write(datastream);
 	    datastream.close();
 	    open=false;
 	    return true;
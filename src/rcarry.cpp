@@ -41,6 +41,23 @@ namespace Camgen
                                            713948,
                                            9223342};
 
+    /* Number of discarded throws after seeding a substream: */
+
+    static const int warmup=240;
+
+    /* Integer hash used for seed splitting: */
+
+    static unsigned long mix(unsigned long x)
+    {
+	x&=0xffffffffUL;
+	x^=(x>>16);
+	x=(x*0x7feb352dUL)&0xffffffffUL;
+	x^=(x>>15);
+	x=(x*0x846ca68bUL)&0xffffffffUL;
+	x^=(x>>16);
+	return x;
+    }
+
     /* Constructor: */
 
     rcarry::rcarry():carry(true)
@@ -51,6 +68,38 @@ namespace Camgen
 	}
     }
 
+    /* Substream constructor: */
+
+    rcarry::rcarry(std::size_t stream)
+    {
+	set_stream(stream);
+    }
+
+    /* Substream initialisation: */
+
+    void rcarry::set_stream(std::size_t stream)
+    {
+	carry=true;
+	if(stream==0)
+	{
+	    for(int i=0;i<24;++i)
+	    {
+		reg[i]=seeds[i];
+	    }
+	    return;
+	}
+	unsigned long s=mix((unsigned long)stream);
+	for(int i=0;i<24;++i)
+	{
+	    s=mix(s+0x9e3779b9UL+(unsigned long)seeds[i]);
+	    reg[i]=(result_type)(s%(unsigned long)max_value);
+	}
+	for(int i=0;i<warmup;++i)
+	{
+	    (*this)();
+	}
+    }
+
     /* Throwing operator: */
 
     rcarry::result_type rcarry::operator()(void)
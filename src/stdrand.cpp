@@ -20,16 +20,41 @@ namespace std
 
     /* Constructor: */
 
-    random::random()
+    random::random():local(false),state(0)
     {
 	srand(seed);
     }
 
+    /* Substream constructor: */
+
+    random::random(std::size_t stream):local(true)
+    {
+	unsigned long x=((unsigned long)seed+0x9e3779b9UL*(unsigned long)(stream+1))&0xffffffffUL;
+	x^=(x>>16);
+	x=(x*0x7feb352dUL)&0xffffffffUL;
+	x^=(x>>15);
+	x=(x*0x846ca68bUL)&0xffffffffUL;
+	x^=(x>>16);
+	state=(long)(x%2147483646UL)+1;
+    }
+
     /* Throwing operator: */
 
     random::result_type random::operator()(void)
     {
-	return rand();
+	if(!local)
+	{
+	    return rand();
+	}
+
+	/* Park-Miller step by Schrage's method: */
+
+	state=48271*(state%44488)-3399*(state/44488);
+	if(state<0)
+	{
+	    state+=2147483647;
+	}
+	return (result_type)((unsigned long)state%((unsigned long)max_value+1));
     }
 }
 
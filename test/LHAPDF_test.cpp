@@ -5,6 +5,7 @@
 // see COPYING for details.
 //
 
+#include <cstdlib>
 #include <config.h>
 #include <Camgen/plt_strm.h>
 #include <Camgen/SM.h>
@@ -146,6 +147,53 @@ int main()
 	std::cerr<<"done, created "<<filename<<fext<<'.'<<std::endl;
     }
 
+    {
+	std::cerr<<"Comparing interpolated pdfs with LHAPDF.........";
+	std::cerr.flush();
+	if(!pdf_wrapper::cached())
+	{
+	    std::cerr<<"pdf interpolation grid was not built"<<std::endl;
+	    return 1;
+	}
+	const std::size_t n=1000;
+	std::vector<double>xs(n),mus(n);
+	std::vector<int>qs(n);
+	std::vector<double>cached(n);
+	for(std::size_t i=0;i<n;++i)
+	{
+	    xs[i]=std::exp(std::log(pdf_wrapper::xmin())*std::rand()/RAND_MAX);
+	    mus[i]=std::exp(std::log(2.)+std::log(5000.)*std::rand()/RAND_MAX);
+	    qs[i]=std::rand()%11-5;
+	    cached[i]=pdf_wrapper::xf(xs[i],qs[i],mus[i]);
+	}
+	int q1[4]={0,1,-2,2};
+	int q2[4]={0,-1,2,2};
+	double lumis[4];
+	pdf_wrapper::ff(0.1,0.02,q1,q2,4,model_type::M_Z,lumis);
+	for(std::size_t i=0;i<4;++i)
+	{
+	    if(!equals(lumis[i],pdf_wrapper::ff(0.1,0.02,q1[i],q2[i],model_type::M_Z)))
+	    {
+		std::cerr<<"batched flux factor "<<lumis[i]<<" differs from "<<pdf_wrapper::ff(0.1,0.02,q1[i],q2[i],model_type::M_Z)<<std::endl;
+		return 1;
+	    }
+	}
+	pdf_wrapper::set_cache(false);
+	for(std::size_t i=0;i<n;++i)
+	{
+	    double direct=pdf_wrapper::xf(xs[i],qs[i],mus[i]);
+	    if(std::abs(cached[i]-direct)>0.01*std::abs(direct)+1e-6)
+	    {
+		std::cerr<<"interpolated pdf "<<cached[i]<<" of parton "<<qs[i]<<" at x = "<<xs[i]<<", mu = "<<mus[i]<<" differs from "<<direct<<std::endl;
+		return 1;
+	    }
+	}
+	pdf_wrapper::set_cache(true);
+	pdf_wrapper::reset();
+	pdf_wrapper::initialise(pdf_name(),pdf_number());
+	std::cerr<<"done."<<std::endl;
+    }
+
     {
 	std::string filename("plots/had_is");
 	std::string fext=have_gp?".eps":".dat/.gp";
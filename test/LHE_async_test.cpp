@@ -0,0 +1,210 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+#include <config.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <Camgen/license_print.h>
+#include <Camgen/evt_gen.h>
+#include <Camgen/LHE_if.h>
+#include <Camgen/stdrand.h>
+#include <Camgen/SM.h>
+#if HAVE_ZLIB_H_
+#include <zlib.h>
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Facility testing the Les-Houches event output: the number formatting must *
+ * agree with the standard library, and the files written by the calling     *
+ * thread, by the background thread and through the compressor must be       *
+ * identical.                                                                *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+using namespace Camgen;
+
+/* Reads the file into the argument string: */
+
+bool read_file(const std::string& filename,std::string& s)
+{
+    std::ifstream ifs(filename.c_str());
+    if(!ifs.is_open())
+    {
+	std::cerr<<"failed to open "<<filename<<std::endl;
+	return false;
+    }
+    std::stringstream ss;
+    ss<<ifs.rdbuf();
+    s=ss.str();
+    return true;
+}
+
+#if HAVE_ZLIB_H_
+
+/* Reads and decompresses the gzip file into the argument string: */
+
+bool read_gzip_file(const std::string& filename,std::string& s)
+{
+    gzFile f=gzopen(filename.c_str(),"rb");
+    if(f==NULL)
+    {
+	std::cerr<<"failed to open "<<filename<<std::endl;
+	return false;
+    }
+    s.clear();
+    char buf[65536];
+    int n;
+    while((n=gzread(f,buf,sizeof(buf)))>0)
+    {
+	s.append(buf,n);
+    }
+    gzclose(f);
+    return n==0;
+}
+
+#endif /*HAVE_ZLIB_H_*/
+
+int main()
+{
+    typedef SM model_type;
+    typedef model_type::value_type value_type;
+    typedef event_generator<model_type,2,2,std::random> generator_type;
+
+    license_print::disable();
+
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+    std::cout<<"testing Les-Houches event output........................................."<<std::endl;
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+
+    std::cerr<<"Checking number formatting..........";
+    std::cerr.flush();
+    std::size_t n_mismatch=0;
+    for(std::size_t i=0;i<100000;++i)
+    {
+	double x=(std::rand()/(double)RAND_MAX-0.5)*std::pow(10.0,(int)(i%60)-30);
+	char s1[48],s2[48];
+	s1[format_buffer::format_scientific(s1,x,10)]='\0';
+	std::sprintf(s2,"%.10e",x);
+	if(std::string(s1)!=std::string(s2))
+	{
+	    if(std::abs(std::atof(s1)-x)>1e-10*std::abs(x))
+	    {
+		std::cerr<<"formatted number "<<s1<<" differs from "<<s2<<std::endl;
+		return 1;
+	    }
+	    ++n_mismatch;
+	}
+	s1[format_buffer::format_int(s1,(long)(x*1e10))]='\0';
+	std::sprintf(s2,"%ld",(long)(x*1e10));
+	if(std::string(s1)!=std::string(s2))
+	{
+	    std::cerr<<"formatted integer "<<s1<<" differs from "<<s2<<std::endl;
+	    return 1;
+	}
+    }
+    if(n_mismatch>10)
+    {
+	std::cerr<<n_mismatch<<" formatted numbers differ in the last digit"<<std::endl;
+	return 1;
+    }
+    std::cerr<<"..........done."<<std::endl;
+
+    value_type Ecm=200;
+    std::size_t N_events=20000;
+    std::string process("q,qbar > e+,e-");
+
+    set_initial_state_type(initial_states::partonic);
+    set_phase_space_generator_type(phase_space_generators::uniform);
+    set_helicity_generator_type(helicity_generators::uniform);
+    set_colour_generator_type(colour_generators::flow_sampling);
+    set_beam_energy(1,0.5*Ecm);
+    set_beam_energy(2,0.5*Ecm);
+
+    CM_algorithm<model_type,2,2>algo(process);
+    algo.load();
+    algo.construct_trees();
+
+    std::cerr<<"Checking asynchronous output for "<<process<<"..........";
+    std::cerr.flush();
+    generator_type gen(algo);
+    gen.generate();
+    LHE_interface<model_type>* lhe1=new LHE_interface<model_type>(&gen,"test_LHE_sync",4);
+    LHE_interface<model_type>* lhe2=new LHE_interface<model_type>(&gen,"test_LHE_async",4);
+    if(lhe2->set_async()!=threads_enabled())
+    {
+	std::cerr<<"asynchronous mode not available"<<std::endl;
+	return 1;
+    }
+    LHE_interface<model_type>* lhe3=new LHE_interface<model_type>(&gen,"test_LHE_gz",4);
+    lhe3->set_async();
+#if HAVE_ZLIB_H_
+    if(!lhe3->set_compression(6,2) or !lhe3->compressed())
+    {
+	std::cerr<<"failed to switch on compression"<<std::endl;
+	return 1;
+    }
+#endif
+    for(std::size_t i=0;i<N_events;++i)
+    {
+	gen.generate();
+	lhe1->fill();
+	lhe2->fill();
+	lhe3->fill();
+    }
+    if(lhe1->output_events()==0 or lhe1->output_events()!=lhe2->output_events())
+    {
+	std::cerr<<lhe1->output_events()<<" and "<<lhe2->output_events()<<" events written"<<std::endl;
+	return 1;
+    }
+    delete lhe1;
+    delete lhe2;
+    delete lhe3;
+    std::string s1,s2,s3;
+    if(!read_file("test_LHE_sync.LHE",s1) or !read_file("test_LHE_async.LHE",s2))
+    {
+	return 1;
+    }
+    std::remove("test_LHE_sync.LHE");
+    std::remove("test_LHE_async.LHE");
+    if(s1!=s2)
+    {
+	std::cerr<<"synchronous and asynchronous event files differ"<<std::endl;
+	return 1;
+    }
+#if HAVE_ZLIB_H_
+    if(!read_gzip_file("test_LHE_gz.LHE.gz",s3))
+    {
+	return 1;
+    }
+    std::remove("test_LHE_gz.LHE.gz");
+#else
+    if(!read_file("test_LHE_gz.LHE",s3))
+    {
+	return 1;
+    }
+    std::remove("test_LHE_gz.LHE");
+#endif
+    if(s1!=s3)
+    {
+	std::cerr<<"uncompressed and compressed event files differ"<<std::endl;
+	return 1;
+    }
+    std::size_t n=0;
+    for(std::size_t pos=s1.find("</event>");pos!=std::string::npos;pos=s1.find("</event>",pos+1))
+    {
+	++n;
+    }
+    if(n!=N_events)
+    {
+	std::cerr<<n<<" events encountered in file, "<<N_events<<" expected"<<std::endl;
+	return 1;
+    }
+    std::cerr<<"..........done."<<std::endl;
+    return 0;
+}
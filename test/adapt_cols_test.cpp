@@ -0,0 +1,109 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+#include <sstream>
+#include <Camgen/license_print.h>
+#include <Camgen/CM_algo.h>
+#include <Camgen/stdrand.h>
+#include <Camgen/uni_hels.h>
+#include <Camgen/part_is.h>
+#include <Camgen/rambo.h>
+#include <Camgen/adapt_cols.h>
+#include <QCDPbdhcfdc.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Facility testing the adaptive colour flow generator: at a fixed phase     *
+ * space point and helicity configuration, the Monte Carlo sum over colours  *
+ * must reproduce the explicit colour sum, and the adapted flow              *
+ * probabilities must survive a save/load cycle.                             *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+using namespace Camgen;
+
+int main()
+{
+    typedef QCDPbdhcfdc model_type;
+    typedef model_type::value_type value_type;
+    typedef rambo<model_type,2,3,std::random> psgen_type;
+    typedef partonic_is<model_type,2> init_state;
+    typedef uniform_helicities<value_type,2,3,std::random,model_type::continuous_helicities> helgen_type;
+    typedef adaptive_colour_flows<value_type,2,3,3,std::random,false> colgen_type;
+    license_print::disable();
+
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+    std::cout<<"testing adaptive colour flow generator..................................."<<std::endl;
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+
+    std::size_t N_events=50000;
+    std::size_t N_batch=5000;
+    value_type Ecm=100;
+
+    std::string process("g,g > g,g,g");
+    std::cerr<<"Checking adaptive colour flow sampling for "<<process<<"..........";
+    std::cerr.flush();
+    CM_algorithm<model_type,2,3>algo(process);
+    algo.load();
+    algo.construct();
+    ps_generator<model_type,2,3>* psgen=psgen_type::create_instance(algo.get_tree_iterator(),new init_state(Ecm,Ecm));
+    psgen->generate();
+    helicity_generator<value_type,2,3,model_type::continuous_helicities>* helgen=helgen_type::create_instance<model_type>(algo.get_tree_iterator());
+    helgen->generate();
+    value_type exact=algo.evaluate_colour_sum();
+    colgen_type* colgen=colgen_type::create_instance<model_type>(algo.get_tree_iterator());
+    if(colgen->flows()!=120)
+    {
+	std::cerr<<"Incorrect number of colour flows "<<colgen->flows()<<" encountered"<<std::endl;
+	return 1;
+    }
+    for(std::size_t i=0;i<N_events;++i)
+    {
+	colgen->generate();
+	value_type w=colgen->weight();
+	if(!colgen->evaluate_weight() or !equals(colgen->weight(),w))
+	{
+	    std::cerr<<"Weight evaluation does not reproduce generated weight "<<w<<std::endl;
+	    return 1;
+	}
+	colgen->integrand()=algo.evaluate2();
+	colgen->refresh_cross_section();
+	colgen->update();
+	if((i+1)%N_batch==0)
+	{
+	    colgen->adapt();
+	}
+    }
+    MC_integral<value_type>I=colgen->cross_section();
+    if(std::abs(I.value-exact)>5*I.error)
+    {
+	std::cerr<<"Adaptive colour integral "<<I.value<<" +/- "<<I.error<<" does not match colour sum "<<exact<<std::endl;
+	return 1;
+    }
+    std::cerr<<"..........done."<<std::endl;
+
+    std::cerr<<"Checking adaptive colour flow serialization..........";
+    std::cerr.flush();
+    std::stringstream ss;
+    colgen->save(ss);
+    colgen_type* colgen2=colgen_type::create_instance<model_type>(algo.get_tree_iterator());
+    colgen2->load(ss);
+    for(std::size_t k=0;k<colgen->flows();++k)
+    {
+	if(!equals(colgen->probability(k),colgen2->probability(k)) or colgen->is_discarded(k)!=colgen2->is_discarded(k))
+	{
+	    std::cerr<<"Loaded probability "<<colgen2->probability(k)<<" of flow "<<k<<" does not match "<<colgen->probability(k)<<std::endl;
+	    return 1;
+	}
+    }
+    std::cerr<<"..........done."<<std::endl;
+    delete colgen;
+    delete colgen2;
+    delete helgen;
+    delete psgen;
+    return 0;
+}
+
@@ -0,0 +1,132 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+#include <sstream>
+#include <Camgen/license_print.h>
+#include <Camgen/stdrand.h>
+#include <Camgen/adapt_hels.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Facility testing the adaptive helicity generator on a synthetic integrand *
+ * over the configurations of two fermions and two massive vector bosons.    *
+ * Vanishing configurations must be discarded, the weighted integrand must   *
+ * reproduce the configuration sum, and the adapted state must survive a     *
+ * save/load cycle.                                                          *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+using namespace Camgen;
+
+namespace
+{
+    /* Synthetic integrand, vanishing unless the fermions have opposite
+     * helicities: */
+
+    double integrand(int h0,int h1,int h2,int h3)
+    {
+	if(h0==h1)
+	{
+	    return 0;
+	}
+	return 1+h2*h2+0.5*h3+(h0>0?4:0);
+    }
+}
+
+int main()
+{
+    typedef double value_type;
+    typedef adaptive_helicities<value_type,2,2,std::random,false> generator_type;
+    license_print::disable();
+
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+    std::cout<<"testing adaptive helicity generator......................................"<<std::endl;
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+
+    std::size_t N_events=100000;
+    std::size_t N_batch=10000;
+
+    vector<int,4>max_hels;
+    max_hels[0]=1;
+    max_hels[1]=1;
+    max_hels[2]=1;
+    max_hels[3]=1;
+    std::bitset<4>zero_hels;
+    zero_hels[2]=true;
+    zero_hels[3]=true;
+
+    value_type exact=0;
+    for(int h0=-1;h0<2;h0+=2)
+    {
+	for(int h1=-1;h1<2;h1+=2)
+	{
+	    for(int h2=-1;h2<2;++h2)
+	    {
+		for(int h3=-1;h3<2;++h3)
+		{
+		    exact+=integrand(h0,h1,h2,h3);
+		}
+	    }
+	}
+    }
+
+    std::cerr<<"Checking adaptive helicity sampling.........";
+    std::cerr.flush();
+    generator_type gen(max_hels,zero_hels);
+    if(gen.configurations()!=36)
+    {
+	std::cerr<<"Incorrect number of helicity configurations "<<gen.configurations()<<" encountered"<<std::endl;
+	return 1;
+    }
+    for(std::size_t i=0;i<N_events;++i)
+    {
+	gen.generate();
+	int h0=gen.helicity(0),h1=gen.helicity(1),h2=gen.helicity(2),h3=gen.helicity(3);
+	value_type w=gen.weight();
+	if(!gen.evaluate_weight() or gen.weight()!=w)
+	{
+	    std::cerr<<"Weight evaluation does not reproduce generated weight "<<w<<std::endl;
+	    return 1;
+	}
+	gen.integrand()=integrand(h0,h1,h2,h3);
+	gen.refresh_cross_section();
+	gen.update();
+	if((i+1)%N_batch==0)
+	{
+	    gen.adapt();
+	}
+    }
+    if(gen.discarded_configurations()!=18)
+    {
+	std::cerr<<gen.discarded_configurations()<<" discarded configurations encountered, 18 expected"<<std::endl;
+	return 1;
+    }
+    MC_integral<value_type>I=gen.cross_section();
+    if(std::abs(I.value-exact)>5*I.error)
+    {
+	std::cerr<<"Adaptive helicity integral "<<I.value<<" +/- "<<I.error<<" does not match exact sum "<<exact<<std::endl;
+	return 1;
+    }
+    std::cerr<<".........done."<<std::endl;
+
+    std::cerr<<"Checking adaptive helicity serialization.........";
+    std::cerr.flush();
+    std::stringstream ss;
+    gen.save(ss);
+    generator_type gen2(max_hels,zero_hels);
+    gen2.load(ss);
+    for(std::size_t k=0;k<gen.configurations();++k)
+    {
+	if(!equals(gen.probability(k),gen2.probability(k)) or gen.is_discarded(k)!=gen2.is_discarded(k))
+	{
+	    std::cerr<<"Loaded probability "<<gen2.probability(k)<<" of configuration "<<k<<" does not match "<<gen.probability(k)<<std::endl;
+	    return 1;
+	}
+    }
+    std::cerr<<".........done."<<std::endl;
+    return 0;
+}
+
@@ -0,0 +1,101 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+* Testing facility for alias-table sampling: the frequencies of the drawn        *
+* indices over a uniform grid of random numbers must reproduce the normalised    *
+* weights, and entries with vanishing weight must never be drawn.                *
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <Camgen/alias_table.h>
+
+using namespace Camgen;
+
+bool check_table(const std::vector<double>& weights)
+{
+    const std::size_t n_throws=1000000;
+
+    alias_table<double>table;
+    if(!table.build(weights) or table.size()!=weights.size())
+    {
+	std::cout<<"table construction failed"<<std::endl;
+	return false;
+    }
+    double norm=0;
+    for(std::size_t i=0;i<weights.size();++i)
+    {
+	norm+=weights[i];
+    }
+    std::vector<std::size_t>counts(weights.size(),0);
+    for(std::size_t k=0;k<n_throws;++k)
+    {
+	++counts[table.sample((k+0.5)/n_throws)];
+    }
+    for(std::size_t i=0;i<weights.size();++i)
+    {
+	if(weights[i]==0 and counts[i]!=0)
+	{
+	    std::cout<<"entry "<<i<<" with zero weight drawn "<<counts[i]<<" times"<<std::endl;
+	    return false;
+	}
+	double f=(double)counts[i]/n_throws;
+	if(std::abs(f-weights[i]/norm)>2.0*weights.size()/n_throws)
+	{
+	    std::cout<<"entry "<<i<<" drawn with frequency "<<f<<", "<<weights[i]/norm<<" expected"<<std::endl;
+	    return false;
+	}
+    }
+    return true;
+}
+
+int main()
+{
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+    std::cout<<"testing alias tables....................................................."<<std::endl;
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+
+    std::cout<<"Checking alias table sampling..........";
+    std::cout.flush();
+
+    std::vector<double>weights(1,1);
+    if(!check_table(weights))
+    {
+	return 1;
+    }
+    weights.clear();
+    weights.push_back(0.5);
+    weights.push_back(0);
+    weights.push_back(0.2);
+    weights.push_back(0.3);
+    weights.push_back(0);
+    weights.push_back(0.001);
+    if(!check_table(weights))
+    {
+	return 1;
+    }
+    weights.clear();
+    for(std::size_t i=0;i<1000;++i)
+    {
+	weights.push_back((i%7==0)?0:std::exp(-0.01*i));
+    }
+    if(!check_table(weights))
+    {
+	return 1;
+    }
+    alias_table<double>table;
+    if(table.build(std::vector<double>(3,0)) or !table.empty())
+    {
+	std::cout<<"table built from vanishing weights"<<std::endl;
+	return 1;
+    }
+    std::cout<<"..........done."<<std::endl;
+    return 0;
+}
+
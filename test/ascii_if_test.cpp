@@ -0,0 +1,179 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <Camgen/license_print.h>
+#include <Camgen/ascii_if.h>
+#include <Camgen/plt_strm.h>
+#include <Camgen/SM.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Facility testing the buffered ascii output: numbers in the shortest        *
+ * round-trip notation must read back exactly, and the rows written by the    *
+ * buffered ascii interface and the plot data files must reproduce the        *
+ * filled values.                                                             *
+ *                                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+using namespace Camgen;
+
+typedef SM model_type;
+typedef model_type::value_type value_type;
+typedef vector<value_type,model_type::dimension> momentum_type;
+
+/* Returns a random number with a random exponent: */
+
+double random_number(std::size_t i)
+{
+    return (std::rand()/(double)RAND_MAX-0.5)*std::pow(10.0,(int)(i%60)-30);
+}
+
+/* Reads the rows of the file, skipping lines starting with '#': */
+
+bool read_rows(const std::string& filename,std::vector<std::vector<double> >& rows)
+{
+    std::ifstream ifs(filename.c_str());
+    if(!ifs.is_open())
+    {
+	std::cerr<<"failed to open "<<filename<<std::endl;
+	return false;
+    }
+    rows.clear();
+    std::string line;
+    while(std::getline(ifs,line))
+    {
+	if(line.size()!=0 and line[0]=='#')
+	{
+	    continue;
+	}
+	std::istringstream iss(line);
+	std::vector<double>row;
+	std::string s;
+	while(iss>>s)
+	{
+	    row.push_back(std::strtod(s.c_str(),NULL));
+	}
+	rows.push_back(row);
+    }
+    return true;
+}
+
+int main()
+{
+    license_print::disable();
+
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+    std::cout<<"testing buffered ascii output............................................"<<std::endl;
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+
+    std::cerr<<"Checking shortest number formatting..........";
+    std::cerr.flush();
+    for(std::size_t i=0;i<100000;++i)
+    {
+	double x=random_number(i);
+	char s[32];
+	std::size_t n=format_buffer::format_shortest(s,x);
+	s[n]='\0';
+	if(std::strtod(s,NULL)!=x or n>24)
+	{
+	    std::cerr<<"formatted number "<<s<<" does not reproduce "<<x<<std::endl;
+	    return 1;
+	}
+    }
+    char s[32];
+    s[format_buffer::format_shortest(s,0.1)]='\0';
+    if(std::string(s)!="0.1")
+    {
+	std::cerr<<"number 0.1 formatted as "<<s<<std::endl;
+	return 1;
+    }
+    std::cerr<<"..........done."<<std::endl;
+
+    std::size_t N_rows=20000;
+
+    std::cerr<<"Checking buffered ascii interface..........";
+    std::cerr.flush();
+    momentum_type p;
+    value_type x;
+    int n;
+    bool b;
+    ascii_file<model_type>* output=new ascii_file<model_type>("test_ascii");
+    if(!output->set_buffered(1000) or !output->buffered())
+    {
+	std::cerr<<"failed to switch on buffered output"<<std::endl;
+	return 1;
+    }
+    output->open_file();
+    output->branch(&p,"p");
+    output->branch(&x,"x");
+    output->branch(&n,"n");
+    output->branch(&b,"b");
+    std::vector<std::vector<double> >filled;
+    for(std::size_t i=0;i<N_rows;++i)
+    {
+	std::vector<double>row;
+	for(std::size_t mu=0;mu<model_type::dimension;++mu)
+	{
+	    p[mu]=random_number(i+mu);
+	    row.push_back(p[mu]);
+	}
+	x=random_number(i);
+	n=(int)i-(int)N_rows/2;
+	b=(i%3==0);
+	row.push_back(x);
+	row.push_back(n);
+	row.push_back(b?1:0);
+	filled.push_back(row);
+	output->write_event();
+    }
+    delete output;
+    std::vector<std::vector<double> >rows;
+    if(!read_rows("test_ascii.dat",rows))
+    {
+	return 1;
+    }
+    std::remove("test_ascii.dat");
+    if(rows!=filled)
+    {
+	std::cerr<<"rows read from the ascii file differ from the filled values"<<std::endl;
+	return 1;
+    }
+    std::cerr<<"..........done."<<std::endl;
+
+    std::cerr<<"Checking buffered plot data file..........";
+    std::cerr.flush();
+    double y1,y2;
+    data_wrapper* data=new data_wrapper(std::string("test_plot_data.dat"),&y1,&y2);
+    filled.clear();
+    for(std::size_t i=0;i<N_rows;++i)
+    {
+	y1=random_number(i);
+	y2=random_number(i+1);
+	std::vector<double>row(2);
+	row[0]=y1;
+	row[1]=y2;
+	filled.push_back(row);
+	data->fill();
+    }
+    data->write();
+    delete data;
+    if(!read_rows("test_plot_data.dat",rows))
+    {
+	return 1;
+    }
+    std::remove("test_plot_data.dat");
+    if(rows!=filled)
+    {
+	std::cerr<<"rows read from the plot data file differ from the filled values"<<std::endl;
+	return 1;
+    }
+    std::cerr<<"..........done."<<std::endl;
+    return 0;
+}
+
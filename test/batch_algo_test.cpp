@@ -0,0 +1,89 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+#include <ctime>
+#include <QCDPbdhcfcc.h>
+#include <test_gen.h>
+#include <Camgen/license_print.h>
+#include <Camgen/batch_algo.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Facility testing the batched amplitude evaluation: the amplitudes of all  *
+ * lanes must coincide with the ones obtained by evaluating every lane       *
+ * separately.                                                               *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+using namespace Camgen;
+
+int main()
+{
+    typedef QCDPbdhcfcc model_type;
+    typedef model_type::value_type value_type;
+    typedef std::complex<value_type> amplitude_type;
+    typedef CM_algorithm<model_type,2,3> algorithm_type;
+    typedef batch_algorithm<model_type,2,3> batch_type;
+    typedef process_generator<model_type,2,3,std::random> generator_type;
+    license_print::disable();
+
+    std::size_t N_events=100;
+    std::size_t N_lanes=8;
+    value_type Ecm=500;
+
+    std::cout<<"----------------------------------------------------------------------------------"<<std::endl;
+    std::cout<<"testing batched amplitude evaluation............................................."<<std::endl;
+    std::cout<<"----------------------------------------------------------------------------------"<<std::endl;
+
+    std::string process="g,g > g,g,g";
+    algorithm_type algo(process);
+    algo.load();
+    algo.construct();
+    batch_type batch(algo,N_lanes);
+
+    std::vector<generator_type*>gens(N_lanes);
+    for(std::size_t b=0;b<N_lanes;++b)
+    {
+	gens[b]=test_utils::test_generator_builder<model_type,2,3>::create_generator(batch.lane(b).get_tree_iterator(),Ecm);
+    }
+
+    std::cout<<"Checking batched amplitudes for "<<process<<"..........";
+    std::cout.flush();
+    std::vector<amplitude_type>amps(N_lanes);
+    std::clock_t t_batch=0,t_serial=0;
+    for(std::size_t i=0;i<N_events;++i)
+    {
+	for(std::size_t b=0;b<N_lanes;++b)
+	{
+	    gens[b]->generate();
+	}
+	std::clock_t t0=std::clock();
+	const std::vector<amplitude_type>& batch_amps=batch.evaluate();
+	std::clock_t t1=std::clock();
+	for(std::size_t b=0;b<N_lanes;++b)
+	{
+	    amps[b]=batch.lane(b).evaluate();
+	}
+	std::clock_t t2=std::clock();
+	t_batch+=(t1-t0);
+	t_serial+=(t2-t1);
+	for(std::size_t b=0;b<N_lanes;++b)
+	{
+	    if(batch_amps[b]!=amps[b])
+	    {
+		std::cout<<"event "<<i<<", lane "<<b<<": batched amplitude "<<batch_amps[b]<<" differs from "<<amps[b]<<std::endl;
+		return 1;
+	    }
+	}
+    }
+    for(std::size_t b=0;b<N_lanes;++b)
+    {
+	delete gens[b];
+    }
+    std::cout<<"done."<<std::endl;
+    std::cout<<"Serial evaluation: "<<(double)t_serial/CLOCKS_PER_SEC<<" s, batched evaluation: "<<(double)t_batch/CLOCKS_PER_SEC<<" s"<<std::endl;
+    return 0;
+}
@@ -0,0 +1,121 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+#include <cstdio>
+#include <Camgen/license_print.h>
+#include <Camgen/evt_gen.h>
+#include <Camgen/gen_if.h>
+#include <Camgen/bin_if.h>
+#include <Camgen/stdrand.h>
+#include <Camgen/SM.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Facility testing the binary event file output: the events read back from  *
+ * the memory-mapped file must reproduce the generated event records, both by *
+ * random access and through the column data of the blocks.                  *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+using namespace Camgen;
+
+int main()
+{
+    typedef SM model_type;
+    typedef model_type::value_type value_type;
+    typedef event_generator<model_type,2,2,std::random> generator_type;
+
+    license_print::disable();
+
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+    std::cout<<"testing binary event output.............................................."<<std::endl;
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+
+    value_type Ecm=200;
+    std::size_t N_events=2500,block_size=1000;
+    std::string process("q,qbar > e+,e-");
+
+    set_initial_state_type(initial_states::partonic);
+    set_phase_space_generator_type(phase_space_generators::uniform);
+    set_helicity_generator_type(helicity_generators::uniform);
+    set_colour_generator_type(colour_generators::flow_sampling);
+    set_beam_energy(1,0.5*Ecm);
+    set_beam_energy(2,0.5*Ecm);
+
+    CM_algorithm<model_type,2,2>algo(process);
+    algo.load();
+    algo.construct_trees();
+
+    std::cerr<<"Checking binary event file for "<<process<<"..........";
+    std::cerr.flush();
+    generator_type gen(algo);
+    generator_interface<model_type>* output=new generator_interface<model_type>(&gen,new binary_file<model_type>("test_bin",block_size));
+    std::vector<value_type>weights,energies;
+    std::vector<int>ids,colours;
+    std::vector<int>c,cbar;
+    for(std::size_t i=0;i<N_events;++i)
+    {
+	gen.generate();
+	if(!output->fill())
+	{
+	    continue;
+	}
+	weights.push_back(gen.w());
+	energies.push_back(gen.p_out(1)[0]);
+	ids.push_back(gen.id_in(0));
+	gen.fill_colours(c,cbar);
+	colours.push_back(c[0]);
+    }
+    output->write();
+    delete output;
+
+    binary_file_reader reader("test_bin.bin");
+    if(!reader.is_open())
+    {
+	std::cerr<<"failed to read binary event file"<<std::endl;
+	return 1;
+    }
+    if(reader.events()!=weights.size() or reader.n_incoming()!=2 or reader.n_outgoing()!=2 or reader.blocks()!=(weights.size()+block_size-1)/block_size)
+    {
+	std::cerr<<reader.events()<<" events in "<<reader.blocks()<<" blocks read, "<<weights.size()<<" expected"<<std::endl;
+	return 1;
+    }
+    for(std::size_t i=0;i<reader.events();++i)
+    {
+	if(reader.weight(i)!=weights[i] or reader.p(i,3,0)!=energies[i] or reader.id(i,0)!=ids[i] or reader.c(i,0)!=colours[i])
+	{
+	    std::cerr<<"event "<<i<<" differs from the generated event"<<std::endl;
+	    return 1;
+	}
+    }
+    int w_col=reader.find_column("weight");
+    if(w_col<0 or reader.find_column("proc_id")<0)
+    {
+	std::cerr<<"event record columns not found"<<std::endl;
+	return 1;
+    }
+    if(little_endian_host())
+    {
+	std::size_t i=0;
+	for(std::size_t b=0;b<reader.blocks();++b)
+	{
+	    const double* w=reader.column<double>(w_col,b);
+	    for(std::size_t j=0;j<reader.block_events(b);++j)
+	    {
+		if(w==NULL or w[j]!=weights[i++])
+		{
+		    std::cerr<<"weight column of block "<<b<<" differs from the generated weights"<<std::endl;
+		    return 1;
+		}
+	    }
+	}
+    }
+    reader.close();
+    std::remove("test_bin.bin");
+    std::cerr<<"..........done."<<std::endl;
+    return 0;
+}
+
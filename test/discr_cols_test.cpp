@@ -276,7 +276,7 @@ namespace Camgen
 
 			/* First recursive relation check: */
 
-			std::set<typename discr_eval_type::iterator>iterset;
+			iterator_set<typename discr_eval_type::iterator>iterset;
 			for(;discr_iters[1]!=discr_tens[1].end();discr_iters[1]+=st_sizes[1])
 			{
 			    fill(1);
@@ -369,7 +369,7 @@ namespace Camgen
 
 			/* First recursive relation check: */
 
-			std::set<typename discr_eval_type::iterator>iterset;
+			iterator_set<typename discr_eval_type::iterator>iterset;
 			for(;discr_iters[1]!=discr_tens[1].end();discr_iters[1]+=st_sizes[1])
 			{
 			    fill(1);
@@ -0,0 +1,168 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+#include <Camgen/license_print.h>
+#include <Camgen/CM_algo.h>
+#include <Camgen/evt_gen.h>
+#include <Camgen/stdrand.h>
+#include <Camgen/part_is.h>
+#include <Camgen/rambo.h>
+#include <QCDPbdhcfdc.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Facility testing the sharing of vertex trees between subprocesses that    *
+ * only differ by equivalent flavours: the massless quark subprocesses must  *
+ * share a single tree yielding unchanged amplitudes, and the event          *
+ * generator must produce their events with a single process generator.      *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+using namespace Camgen;
+
+int main()
+{
+    typedef QCDPbdhcfdc model_type;
+    typedef model_type::value_type value_type;
+    typedef vector<value_type,4> momentum_type;
+    typedef rambo<model_type,2,2,std::random> psgen_type;
+    typedef partonic_is<model_type,2> init_state;
+    typedef event_generator<model_type,2,2,std::random> generator_type;
+    license_print::disable();
+
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+    std::cout<<"testing equivalent subprocess trees......................................"<<std::endl;
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+
+    value_type Ecm=100;
+    std::size_t N_events=30000;
+    std::string process("q,qbar > g,g");
+
+    std::cerr<<"Checking shared trees for "<<process<<"..........";
+    std::cerr.flush();
+    CM_algorithm<model_type,2,2>algo(process);
+    algo.load();
+    algo.construct_trees();
+    algo.sum_spins();
+    algo.sum_colours();
+    if(algo.n_trees()!=16 or algo.count_nonempty_processes()!=4)
+    {
+	std::cerr<<algo.count_nonempty_processes()<<" nonempty subprocesses out of "<<algo.n_trees()<<" trees encountered, 4 out of 16 expected"<<std::endl;
+	return 1;
+    }
+
+    /* Evaluate the nonempty subprocesses at a common phase space point: */
+
+    algo.reset_process();
+    while(algo.get_tree_iterator()->is_empty())
+    {
+	algo.next_process();
+    }
+    psgen_type* psgen=psgen_type::create_instance(algo.get_tree_iterator(),new init_state(0.5*Ecm,0.5*Ecm));
+    psgen->generate();
+    std::vector<momentum_type>p(4);
+    for(std::size_t i=0;i<4;++i)
+    {
+	p[i]=algo.get_phase_space(i)->momentum();
+    }
+    std::vector<value_type>M;
+    algo.reset_process();
+    do
+    {
+	if(!algo.get_tree_iterator()->is_empty())
+	{
+	    for(std::size_t i=0;i<4;++i)
+	    {
+		algo.get_phase_space(i)->momentum()=p[i];
+	    }
+	    M.push_back(algo.evaluate_sum());
+	}
+    }
+    while(algo.next_process());
+
+    /* The u, d and s subprocesses share a tree, the massive c-quark
+     * subprocess does not: */
+
+    std::size_t n=algo.share_equivalent_trees();
+    if(n!=2 or algo.n_trees()!=14 or algo.n_processes()!=16 or algo.count_nonempty_processes()!=4)
+    {
+	std::cerr<<n<<" trees removed, "<<algo.n_trees()<<" trees left, 2 and 14 expected"<<std::endl;
+	return 1;
+    }
+    std::size_t k=0;
+    algo.reset_process();
+    do
+    {
+	if(!algo.get_tree_iterator()->is_empty())
+	{
+	    for(std::size_t i=0;i<4;++i)
+	    {
+		algo.get_phase_space(i)->momentum()=p[i];
+	    }
+	    value_type M2=algo.evaluate_sum();
+	    if(!equals(M[k],M2))
+	    {
+		std::cerr<<"shared tree amplitude "<<M2<<" does not match "<<M[k]<<" for ";
+		algo.get_process_iterator()->print(std::cerr);
+		std::cerr<<std::endl;
+		return 1;
+	    }
+	    ++k;
+	}
+    }
+    while(algo.next_process());
+    std::cerr<<"..........done."<<std::endl;
+
+    std::cerr<<"Checking flavour selection for "<<process<<"..........";
+    std::cerr.flush();
+    set_initial_state_type(initial_states::partonic);
+    set_phase_space_generator_type(phase_space_generators::uniform);
+    set_helicity_generator_type(helicity_generators::uniform);
+    set_colour_generator_type(colour_generators::uniform);
+    set_beam_energy(1,0.5*Ecm);
+    set_beam_energy(2,0.5*Ecm);
+    generator_type gen(algo);
+    if(gen.processes()!=2)
+    {
+	std::cerr<<gen.processes()<<" process generators encountered, 2 expected"<<std::endl;
+	return 1;
+    }
+    generator_type::process_generator_type* proc=gen.process(0);
+    if(proc->n_equivalent_processes()==1)
+    {
+	proc=gen.process(1);
+    }
+    if(proc->n_equivalent_processes()!=3)
+    {
+	std::cerr<<proc->n_equivalent_processes()<<" equivalent subprocesses encountered, 3 expected"<<std::endl;
+	return 1;
+    }
+    std::vector<std::size_t>counts(4,0);
+    for(std::size_t i=0;i<N_events;++i)
+    {
+	proc->generate();
+	int q=proc->id_in(0);
+	if(q<1 or q>3 or proc->id_in(1)!=-q)
+	{
+	    std::cerr<<"invalid incoming partons "<<q<<","<<proc->id_in(1)<<" encountered"<<std::endl;
+	    return 1;
+	}
+	++counts[q];
+    }
+    for(int q=1;q<4;++q)
+    {
+	value_type f=(value_type)counts[q]/(value_type)N_events;
+	if(std::abs(f-(value_type)1/(value_type)3)>(value_type)0.02)
+	{
+	    std::cerr<<"fraction "<<f<<" of flavour "<<q<<" incompatible with 1/3"<<std::endl;
+	    return 1;
+	}
+    }
+    std::cerr<<"..........done."<<std::endl;
+    delete psgen;
+    return 0;
+}
+
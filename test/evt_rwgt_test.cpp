@@ -0,0 +1,227 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+#include <config.h>
+#include <cstdio>
+#include <Camgen/license_print.h>
+#include <Camgen/evt_gen.h>
+#include <Camgen/gen_if.h>
+#include <Camgen/bin_if.h>
+#include <Camgen/LHE_if.h>
+#include <Camgen/evt_rwgt.h>
+#include <Camgen/stdrand.h>
+#include <Camgen/SM.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Facility testing the reweighting of event samples: the squared amplitudes *
+ * evaluated by the reweighter must agree with a serial evaluation, the      *
+ * reweighted event weights must scale with the squared amplitudes after a   *
+ * coupling change, and the weight columns and rwgt-blocks written to the    *
+ * binary and Les-Houches event files must read back correctly.              *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+using namespace Camgen;
+
+typedef SM model_type;
+typedef model_type::value_type value_type;
+typedef event_generator<model_type,2,2,std::random> generator_type;
+typedef CM_algorithm<model_type,2,2> algorithm_type;
+
+/* Compares the relative difference of the arguments: */
+
+bool equals(double x,double y,double eps)
+{
+    return std::abs(x-y)<=eps*std::max(std::abs(x),std::abs(y));
+}
+
+/* Checks the squared amplitudes of the reweighter against a serial
+ * evaluation by a copy of the algorithm: */
+
+template<class reader_t>bool check_amplitudes(const algorithm_type& algo,const reader_t& reader,const std::vector<double>& me2)
+{
+    algorithm_type algo2(algo);
+    algo2.sum_spins();
+    algo2.sum_colours();
+    for(std::size_t i=0;i<reader.events();i+=7)
+    {
+	vector<int,4>ids;
+	for(std::size_t k=0;k<4;++k)
+	{
+	    ids[k]=reader.id(i,k);
+	}
+	algo2.set_process_pdg_ids(ids);
+	for(std::size_t k=0;k<4;++k)
+	{
+	    for(std::size_t mu=0;mu<4;++mu)
+	    {
+		algo2.get_phase_space(k)->momentum()[mu]=reader.p(i,k,mu);
+	    }
+	}
+	double m=algo2.evaluate_sum();
+	if(m<=0 or !equals(m,me2[i],1.0e-12))
+	{
+	    std::cerr<<"squared amplitude "<<me2[i]<<" of event "<<i<<" differs from serial result "<<m<<std::endl;
+	    return false;
+	}
+    }
+    return true;
+}
+
+int main()
+{
+    license_print::disable();
+
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+    std::cout<<"testing event sample reweighting........................................."<<std::endl;
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+
+    value_type Ecm=200;
+    std::size_t N_events=2000;
+    std::string process("q,qbar > e+,e-");
+    value_type alpha=model_type::alpha;
+
+    set_initial_state_type(initial_states::partonic);
+    set_phase_space_generator_type(phase_space_generators::uniform);
+    set_helicity_generator_type(helicity_generators::uniform);
+    set_colour_generator_type(colour_generators::flow_sampling);
+    set_beam_energy(1,0.5*Ecm);
+    set_beam_energy(2,0.5*Ecm);
+
+    algorithm_type algo(process);
+    algo.load();
+    algo.construct_trees();
+
+    generator_type gen(algo);
+    gen.generate();
+    generator_interface<model_type>* output=new generator_interface<model_type>(&gen,new binary_file<model_type>("test_rwgt",500));
+    LHE_interface<model_type>* lhe=new LHE_interface<model_type>(&gen,"test_rwgt",4);
+    for(std::size_t i=0;i<N_events;++i)
+    {
+	gen.generate();
+	if(output->fill())
+	{
+	    lhe->fill();
+	}
+    }
+    output->write();
+    delete output;
+    lhe->write();
+    delete lhe;
+
+    std::cerr<<"Checking reweighting of binary event file..........";
+    std::cerr.flush();
+    binary_file_reader reader("test_rwgt.bin");
+    event_reweighter<model_type,2,2>rw(algo,reader,3);
+    if(rw.events()!=reader.events() or rw.events()==0)
+    {
+	std::cerr<<"reweighter holds "<<rw.events()<<" events, "<<reader.events()<<" expected"<<std::endl;
+	return 1;
+    }
+    rw.set_reference();
+    if(!check_amplitudes(algo,reader,rw.reference_amplitudes()))
+    {
+	return 1;
+    }
+    rw.add_weight("nominal");
+    model_type::set_alpha(2*alpha);
+    std::vector<double>me2;
+    rw.evaluate(me2);
+    if(!check_amplitudes(algo,reader,me2))
+    {
+	return 1;
+    }
+    rw.add_weight("alpha2");
+    model_type::set_alpha(alpha);
+    for(std::size_t i=0;i<rw.events();++i)
+    {
+	double w=reader.weight(i);
+	if(!equals(rw.weight(0,i),w,1.0e-12) or !equals(rw.weight(1,i),w*me2[i]/rw.reference_amplitudes()[i],1.0e-12) or equals(rw.weight(1,i),w,1.0e-3))
+	{
+	    std::cerr<<"reweighted weights "<<rw.weight(0,i)<<", "<<rw.weight(1,i)<<" of event "<<i<<" are incorrect"<<std::endl;
+	    return 1;
+	}
+    }
+    if(!rw.write("test_rwgt_out.bin"))
+    {
+	std::cerr<<"failed to write reweighted binary event file"<<std::endl;
+	return 1;
+    }
+    binary_file_reader reader2("test_rwgt_out.bin");
+    int c1=reader2.find_column("nominal"),c2=reader2.find_column("alpha2");
+    if(!reader2.is_open() or reader2.events()!=reader.events() or reader2.columns()!=reader.columns()+2 or c1<0 or c2<0)
+    {
+	std::cerr<<"failed to read reweighted binary event file"<<std::endl;
+	return 1;
+    }
+    for(std::size_t i=0;i<reader2.events();++i)
+    {
+	if(reader2.weight(i)!=reader.weight(i) or reader2.p(i,2,3)!=reader.p(i,2,3) or reader2.value<double>(c1,i)!=rw.weight(0,i) or reader2.value<double>(c2,i)!=rw.weight(1,i))
+	{
+	    std::cerr<<"event "<<i<<" of the reweighted binary event file is incorrect"<<std::endl;
+	    return 1;
+	}
+    }
+    reader2.close();
+    std::remove("test_rwgt_out.bin");
+    std::cerr<<"..........done."<<std::endl;
+
+    std::cerr<<"Checking reweighting of Les-Houches event file..........";
+    std::cerr.flush();
+    LHE_file_reader lhe_reader("test_rwgt.LHE");
+    if(!lhe_reader.is_open() or lhe_reader.events()!=reader.events() or lhe_reader.n_incoming()!=2 or lhe_reader.n_outgoing()!=2)
+    {
+	std::cerr<<"failed to read Les-Houches event file"<<std::endl;
+	return 1;
+    }
+    for(std::size_t i=0;i<lhe_reader.events();++i)
+    {
+	if(lhe_reader.id(i,0)!=reader.id(i,0) or lhe_reader.id(i,3)!=reader.id(i,3) or !equals(lhe_reader.p(i,3,1),reader.p(i,3,1),1.0e-9) or !equals(lhe_reader.weight(i),reader.weight(i),1.0e-9))
+	{
+	    std::cerr<<"event "<<i<<" of the Les-Houches file differs from the binary file"<<std::endl;
+	    return 1;
+	}
+    }
+    event_reweighter<model_type,2,2,LHE_file_reader>lhe_rw(algo,lhe_reader,2);
+    lhe_rw.set_reference();
+    model_type::set_alpha(2*alpha);
+    lhe_rw.add_weight("alpha2");
+    model_type::set_alpha(alpha);
+    for(std::size_t i=0;i<lhe_rw.events();++i)
+    {
+	if(!equals(lhe_rw.weight(0,i),rw.weight(1,i),1.0e-8))
+	{
+	    std::cerr<<"reweighted weight "<<lhe_rw.weight(0,i)<<" of event "<<i<<" differs from binary result "<<rw.weight(1,i)<<std::endl;
+	    return 1;
+	}
+    }
+    if(!lhe_rw.write("test_rwgt_out.LHE"))
+    {
+	std::cerr<<"failed to write reweighted Les-Houches event file"<<std::endl;
+	return 1;
+    }
+    LHE_file_reader lhe_reader2("test_rwgt_out.LHE");
+    if(!lhe_reader2.is_open() or lhe_reader2.events()!=lhe_reader.events() or lhe_reader2.weights()!=1 or lhe_reader2.weight_id(0)!="alpha2")
+    {
+	std::cerr<<"failed to read reweighted Les-Houches event file"<<std::endl;
+	return 1;
+    }
+    for(std::size_t i=0;i<lhe_reader2.events();++i)
+    {
+	if(lhe_reader2.weight(i)!=lhe_reader.weight(i) or !equals(lhe_reader2.weight(i,0),lhe_rw.weight(0,i),1.0e-9))
+	{
+	    std::cerr<<"event "<<i<<" of the reweighted Les-Houches file is incorrect"<<std::endl;
+	    return 1;
+	}
+    }
+    std::remove("test_rwgt_out.LHE");
+    std::remove("test_rwgt.LHE");
+    std::remove("test_rwgt.bin");
+    std::cerr<<"..........done."<<std::endl;
+    return 0;
+}
+
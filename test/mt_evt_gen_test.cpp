@@ -0,0 +1,217 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+* Testing facility for the multithreaded event generation driver.                *
+*                                                                                *
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <Camgen/mt_evt_gen.h>
+#include <Camgen/parni.h>
+#include <Camgen/rcarry.h>
+#include <QEDPbdh.h>
+
+using namespace Camgen;
+
+/* Event sink counting the events passed to it: */
+
+class counting_sink
+{
+    public:
+
+	counting_sink():n(0){}
+
+	template<class generator_t>void operator()(generator_t& gen)
+	{
+	    ++n;
+	}
+
+	std::size_t n;
+};
+
+/* Checks that merging the statistics of two copies of a grid, each updated
+ * with half of the points, is equivalent to updating a single grid: */
+
+bool check_parni_merge()
+{
+    typedef parni<double,2,rcarry> grid_type;
+    typedef grid_type::point_type point_type;
+
+    std::cout<<"Checking merged 2D parni statistics..........";
+    std::cout.flush();
+
+    point_type x,x0,x1,x2,x3;
+    point_type xmin,xmax;
+    xmin.assign(-1);
+    xmax.assign(1);
+    grid_type grid(&x,xmin,xmax,200,grid_modes::variance_weights);
+    for(std::size_t n=1;n<=5000;++n)
+    {
+	grid.generate();
+	grid.integrand()=std::exp(-4*(x[0]*x[0]+x[1]*x[1]));
+	grid.update();
+	if(n%100==0)
+	{
+	    grid.adapt();
+	}
+    }
+    std::stringstream ss;
+    grid.save(ss);
+    std::string state=ss.str();
+    std::istringstream is0(state),is1(state),is2(state),is3(state);
+    grid_type* ref=grid_type::create_instance(&x0,is0);
+    grid_type* copy=grid_type::create_instance(&x1,is1);
+    grid_type* half1=grid_type::create_instance(&x2,is2);
+    grid_type* half2=grid_type::create_instance(&x3,is3);
+    half1->reset_statistics();
+    half2->reset_statistics();
+    for(std::size_t n=0;n<2000;++n)
+    {
+	grid.generate();
+	grid.integrand()=std::exp(-4*(x[0]*x[0]+x[1]*x[1]));
+	x0=x;
+	ref->evaluate_weight();
+	ref->integrand()=grid.integrand();
+	ref->update();
+	grid_type* half=(n%2==0)?half1:half2;
+	point_type& y=(n%2==0)?x2:x3;
+	y=x;
+	half->evaluate_weight();
+	half->integrand()=grid.integrand();
+	half->update();
+    }
+    bool q=copy->merge_statistics(*half1) and copy->merge_statistics(*half2);
+    if(!q)
+    {
+	std::cout<<"grid copies could not be merged"<<std::endl;
+    }
+    ref->adapt();
+    copy->adapt();
+    grid_type::leaf_iterator it2=copy->begin_leaves();
+    for(grid_type::leaf_iterator it=ref->begin_leaves();it!=ref->end_leaves() and q;++it)
+    {
+	if(it2==copy->end_leaves() or std::abs((*it)->weight()-(*it2)->weight())>1e-10*std::abs((*it)->weight()))
+	{
+	    std::cout<<"merged grid weights differ from the original grid"<<std::endl;
+	    q=false;
+	}
+	++it2;
+    }
+    delete ref;
+    delete copy;
+    delete half1;
+    delete half2;
+    if(q)
+    {
+	std::cout<<"done."<<std::endl;
+    }
+    return q;
+}
+
+int main()
+{
+    license_print::disable();
+
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+    std::cout<<"testing multithreaded event generation..................................."<<std::endl;
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+
+    typedef QEDPbdh model_type;
+    typedef model_type::value_type value_type;
+    typedef event_generator<model_type,2,2,rcarry> generator_type;
+    typedef parallel_event_generator<model_type,2,2,rcarry> parallel_generator_type;
+
+    value_type Ecm=500;
+    std::size_t n_evts=20000;
+    std::size_t chunk=1000;
+    std::string process("e+,e- > mu+,mu-");
+
+    set_initial_state_type(initial_states::partonic);
+    set_phase_space_generator_type(phase_space_generators::uniform);
+    set_helicity_generator_type(helicity_generators::uniform);
+    set_beam_energy(1,0.5*Ecm);
+    set_beam_energy(2,0.5*Ecm);
+
+    CM_algorithm<model_type,2,2>algo(process);
+    algo.load();
+    algo.construct();
+
+    if(!check_parni_merge())
+    {
+	return 1;
+    }
+
+    std::cout<<"Checking reproducibility of "<<process<<" cross section..........";
+    std::cout.flush();
+
+    generator_type gen1(algo);
+    generator_type gen2(algo);
+    {
+	parallel_generator_type pgen1(gen1,algo,1,chunk);
+	parallel_generator_type pgen2(gen2,algo,3,chunk);
+	pgen1.generate(n_evts);
+	counting_sink sink;
+	pgen2.generate(n_evts,sink);
+	if(sink.n!=n_evts)
+	{
+	    std::cout<<"sink received "<<sink.n<<" instead of "<<n_evts<<" events"<<std::endl;
+	    return 1;
+	}
+    }
+    MC_integral<value_type>sigma1=gen1.cross_section();
+    MC_integral<value_type>sigma2=gen2.cross_section();
+    if(gen1.process(0)->calls()!=gen2.process(0)->calls() or sigma1.value!=sigma2.value or sigma1.error!=sigma2.error)
+    {
+	std::cout<<"cross sections "<<sigma1<<" and "<<sigma2<<" differ for 1 and 3 threads"<<std::endl;
+	return 1;
+    }
+    std::cout<<"done."<<std::endl;
+
+    /* Comparison with the analytic result 4 pi alpha^2/3s: */
+
+    std::cout<<"Checking "<<process<<" cross section value..........";
+    std::cout.flush();
+    value_type alpha=model_type::alpha;
+    value_type sigma=(value_type)4*std::acos(-(value_type)1)*alpha*alpha/((value_type)3*Ecm*Ecm)*generator_type::process_generator_type::pb_conversion;
+    if(!(sigma1.error<(value_type)0.05*sigma) or std::abs(sigma1.value-sigma)>(value_type)5*sigma1.error)
+    {
+	std::cout<<"cross section "<<sigma1<<" incompatible with analytic result "<<sigma<<std::endl;
+	return 1;
+    }
+    std::cout<<"done."<<std::endl;
+
+    /* Parallel initialisation with the recursive phase space generator: */
+
+    std::cout<<"Checking parallel initialisation for "<<process<<"..........";
+    std::cout.flush();
+    set_phase_space_generator_type(phase_space_generators::recursive);
+    generator_type gen3(algo);
+    {
+	parallel_generator_type pgen3(gen3,algo,3,chunk);
+	pgen3.initialise(5,1000,5,1000,5000);
+	if(gen3.process(0)->calls()!=5000)
+	{
+	    std::cout<<"cross section estimated with "<<gen3.process(0)->calls()<<" instead of 5000 events"<<std::endl;
+	    return 1;
+	}
+	if(gen3.process(0)->updates()<15000)
+	{
+	    std::cout<<"only "<<gen3.process(0)->updates()<<" worker updates merged into the generator"<<std::endl;
+	    return 1;
+	}
+	pgen3.generate(n_evts);
+    }
+    MC_integral<value_type>sigma3=gen3.cross_section();
+    if(!(sigma3.error<(value_type)0.05*sigma) or std::abs(sigma3.value-sigma)>(value_type)5*sigma3.error)
+    {
+	std::cout<<"cross section "<<sigma3<<" incompatible with analytic result "<<sigma<<std::endl;
+	return 1;
+    }
+    std::cout<<"done."<<std::endl;
+    return 0;
+}
+
@@ -0,0 +1,187 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+#include <Camgen/mt_utils.h>
+#include <Camgen/CM_algo.h>
+#include <test_gen.h>
+#include <QCDPbchabcc.h>
+#include <QCDPbchcfdc.h>
+#include <QCDPbdhcfdc.h>
+
+using namespace Camgen;
+
+/* Job class evaluating a number of events on an instance-local copy of an
+ * algorithm. The generation of the phase space points is serialised, since
+ * the test generators share their random number generator: */
+
+template<class model_t,std::size_t N_out>class evaluation_job
+{
+    public:
+
+	typedef typename model_t::value_type value_type;
+	typedef CM_algorithm<model_t,2,N_out> algorithm_type;
+
+	evaluation_job(const algorithm_type& algo_,const value_type& E,std::size_t n):algo(algo_),n_evts(n),last_me(0)
+	{
+	    gen=test_utils::test_generator_builder<model_t,2,N_out>::create_generator(algo.get_tree_iterator(),E);
+	}
+
+	~evaluation_job()
+	{
+	    delete gen;
+	}
+
+	void operator()()
+	{
+	    for(std::size_t i=0;i<n_evts;++i)
+	    {
+		{
+		    scoped_lock lock(gen_mutex);
+		    gen->generate();
+		}
+		last_me=algo.evaluate2();
+	    }
+	}
+
+	/* Re-evaluates the last phase space point and compares with the value
+	 * obtained during the concurrent run: */
+
+	bool check()
+	{
+	    return (algo.evaluate2()==last_me);
+	}
+
+    private:
+
+	algorithm_type algo;
+	process_generator<model_t,2,N_out,std::random>* gen;
+	std::size_t n_evts;
+	value_type last_me;
+	static mutex gen_mutex;
+};
+template<class model_t,std::size_t N_out>mutex evaluation_job<model_t,N_out>::gen_mutex;
+
+template<class model_t,std::size_t N_out>bool run_test(const std::string& process,const std::string& name,std::size_t n_evts)
+{
+    typedef typename model_t::value_type value_type;
+    typedef evaluation_job<model_t,N_out> job_type;
+
+    value_type Ecm=500;
+
+    CM_algorithm<model_t,2,N_out>algo(process);
+    algo.load();
+    algo.construct();
+
+    /* Serial warm-up, initialising the lazily computed static data: */
+
+    test_utils::test_generator_builder<model_t,2,N_out>::fill(algo,Ecm);
+    algo.evaluate();
+
+    std::size_t n_max=std::max(hardware_threads(),(std::size_t)2);
+    value_type rate1(0);
+    for(std::size_t n=1;n<=n_max;++n)
+    {
+	std::cout<<"Timing "<<name<<" for "<<process<<" on "<<n<<" thread(s)......";
+	std::cout.flush();
+	std::vector<job_type*>jobs(n);
+	for(std::size_t i=0;i<n;++i)
+	{
+	    jobs[i]=new job_type(algo,Ecm,n_evts);
+	}
+	double t=wall_clock();
+	run_parallel(jobs);
+	t=wall_clock()-t;
+	bool q=true;
+	for(std::size_t i=0;i<n;++i)
+	{
+	    q&=jobs[i]->check();
+	    delete jobs[i];
+	}
+	if(!q)
+	{
+	    std::cout<<"failed."<<std::endl;
+	    std::cerr<<"concurrent evaluation does not reproduce the serial result"<<std::endl;
+	    return false;
+	}
+	value_type rate=(value_type)(n*n_evts)/(value_type)t;
+	if(n==1)
+	{
+	    rate1=rate;
+	}
+	std::cout<<"done. Events/sec: "<<rate<<", speedup: "<<rate/rate1<<std::endl;
+    }
+    return true;
+}
+
+/* Times the construction of the subprocess trees on increasing numbers of
+ * threads and compares the diagram counts with the serial construction: */
+
+template<class model_t,std::size_t N_out>bool run_construction_test(const std::string& process,const std::string& name)
+{
+    std::size_t n_max=std::max(hardware_threads(),(std::size_t)2);
+    std::vector<long long unsigned>diagrams;
+    double t1=0;
+    for(std::size_t n=1;n<=n_max;++n)
+    {
+	std::cout<<"Timing "<<name<<" tree construction for "<<process<<" on "<<n<<" thread(s)......";
+	std::cout.flush();
+	CM_algorithm<model_t,2,N_out>algo(process);
+	algo.load();
+	double t=wall_clock();
+	algo.construct_trees(n);
+	t=wall_clock()-t;
+	std::vector<long long unsigned>d;
+	algo.reset_process();
+	do
+	{
+	    d.push_back(algo.count_diagrams());
+	}
+	while(algo.next_process());
+	if(n==1)
+	{
+	    diagrams=d;
+	    t1=t;
+	}
+	else if(d!=diagrams)
+	{
+	    std::cout<<"failed."<<std::endl;
+	    std::cerr<<"concurrent construction does not reproduce the serial diagrams"<<std::endl;
+	    return false;
+	}
+	std::cout<<"done. Seconds: "<<t<<", speedup: "<<t1/t<<std::endl;
+    }
+    return true;
+}
+
+int main()
+{
+    license_print::disable();
+
+    std::cout<<"-----------------------------------------------------"<<std::endl;
+    std::cout<<"testing multithreaded multi-gluon performance........"<<std::endl;
+    std::cout<<"-----------------------------------------------------"<<std::endl;
+
+    if(!threads_enabled())
+    {
+	std::cout<<"Camgen compiled without thread support, jobs will run serially"<<std::endl;
+    }
+
+    if(!run_test<QCDPbchabcc,4>("g,g > g,g,g,g","adjoint QCD",200))
+    {
+	return 1;
+    }
+    if(!run_test<QCDPbchcfdc,4>("g,g > g,g,g,g","colour-flow decomposed QCD",1000))
+    {
+	return 1;
+    }
+    if(!run_construction_test<QCDPbdhcfdc,4>("q,qbar > q,qbar,g,g","colour-flow decomposed QCD"))
+    {
+	return 1;
+    }
+    return 0;
+}
+
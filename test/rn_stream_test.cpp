@@ -0,0 +1,154 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+* Testing facility for random number substreams.                                 *
+*                                                                                *
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <iostream>
+#include <vector>
+#include <Camgen/mt_utils.h>
+#include <Camgen/rn_strm.h>
+#include <Camgen/rcarry.h>
+#include <Camgen/stdrand.h>
+
+using namespace Camgen;
+
+/* Job filling a vector with numbers thrown from a substream of the calling
+ * thread's engine: */
+
+template<class rng_t>class stream_job
+{
+    public:
+
+	typedef random_number_stream<double,rng_t> rn_stream;
+
+	stream_job(std::size_t stream_,std::size_t n):stream(stream_),numbers(n){}
+
+	void operator()()
+	{
+	    rn_stream::set_stream(stream);
+	    for(std::size_t i=0;i<numbers.size();++i)
+	    {
+		numbers[i]=rn_stream::throw_number();
+	    }
+	}
+
+	std::size_t stream;
+	std::vector<double>numbers;
+};
+
+template<class rng_t>bool check_streams(const std::string& name)
+{
+    typedef stream_job<rng_t> job_type;
+
+    const std::size_t n_streams=4;
+    const std::size_t n_throws=10000;
+
+    std::cout<<"Checking substreams of "<<name<<"..........";
+    std::cout.flush();
+
+    /* Serial reference run: */
+
+    std::vector<job_type*>ref(n_streams);
+    for(std::size_t i=0;i<n_streams;++i)
+    {
+	ref[i]=new job_type(i,n_throws);
+	(*ref[i])();
+    }
+
+    /* Concurrent run in reverse stream order: */
+
+    std::vector<job_type*>jobs(n_streams);
+    for(std::size_t i=0;i<n_streams;++i)
+    {
+	jobs[i]=new job_type(n_streams-i-1,n_throws);
+    }
+    run_parallel(jobs);
+
+    bool q=true;
+    for(std::size_t i=0;i<n_streams and q;++i)
+    {
+	const job_type* job=jobs[n_streams-i-1];
+	if(job->numbers!=ref[i]->numbers)
+	{
+	    std::cout<<"stream "<<i<<" is not reproduced in concurrent run"<<std::endl;
+	    q=false;
+	}
+	for(std::size_t j=0;j<i and q;++j)
+	{
+	    std::size_t n_equal=0;
+	    for(std::size_t k=0;k<n_throws;++k)
+	    {
+		if(ref[i]->numbers[k]==ref[j]->numbers[k])
+		{
+		    ++n_equal;
+		}
+	    }
+	    if(n_equal>n_throws/100)
+	    {
+		std::cout<<"streams "<<j<<" and "<<i<<" coincide in "<<n_equal<<" throws"<<std::endl;
+		q=false;
+	    }
+	}
+	double mean=0;
+	for(std::size_t k=0;k<n_throws;++k)
+	{
+	    mean+=ref[i]->numbers[k];
+	}
+	mean/=n_throws;
+	if(q and std::abs(mean-0.5)>0.02)
+	{
+	    std::cout<<"stream "<<i<<" has mean "<<mean<<std::endl;
+	    q=false;
+	}
+    }
+    for(std::size_t i=0;i<n_streams;++i)
+    {
+	delete ref[i];
+	delete jobs[i];
+    }
+    if(q)
+    {
+	std::cout<<"done."<<std::endl;
+    }
+    return q;
+}
+
+int main()
+{
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+    std::cout<<"testing random number substreams........................................."<<std::endl;
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+
+    if(!check_streams<rcarry>("rcarry"))
+    {
+	return 1;
+    }
+    if(!check_streams<std::random>("std::random"))
+    {
+	return 1;
+    }
+
+    /* The default stream of rcarry coincides with substream 0: */
+
+    std::cout<<"Checking rcarry default stream..........";
+    std::cout.flush();
+    rcarry r1,r2(0);
+    for(int i=0;i<1000;++i)
+    {
+	if(r1()!=r2())
+	{
+	    std::cout<<"substream 0 differs from default stream"<<std::endl;
+	    return 1;
+	}
+    }
+    std::cout<<"done."<<std::endl;
+    return 0;
+}
+
@@ -0,0 +1,121 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+#include <Camgen/license_print.h>
+#include <Camgen/CM_algo.h>
+#include <Camgen/evt_gen.h>
+#include <Camgen/stdrand.h>
+#include <Camgen/SM.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Facility testing the summation of compatible subprocesses at common phase  *
+ * space points: the massless quark subprocesses must be evaluated by a single *
+ * process generator, reproducing the cross section and the flavour content  *
+ * of the generator sampling all subprocesses separately.                     *
+ *                                                                             *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+using namespace Camgen;
+
+typedef SM model_type;
+typedef model_type::value_type value_type;
+typedef event_generator<model_type,2,2,std::random> generator_type;
+
+/* Generates the events and accumulates the weights per incoming quark
+ * flavour: */
+
+bool fill_flavours(generator_type& gen,std::size_t n,std::vector<value_type>& w)
+{
+    w.assign(5,(value_type)0);
+    for(std::size_t i=0;i<n;++i)
+    {
+	gen.generate();
+	int q=gen.id_in(0);
+	if(q<-4 or q>4 or q==0 or gen.id_in(1)!=-q)
+	{
+	    std::cerr<<"invalid incoming partons "<<q<<","<<gen.id_in(1)<<" encountered"<<std::endl;
+	    return false;
+	}
+	w[std::abs(q)]+=gen.weight()*gen.integrand();
+    }
+    return true;
+}
+
+int main()
+{
+    license_print::disable();
+
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+    std::cout<<"testing summed subprocesses.............................................."<<std::endl;
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+
+    value_type Ecm=200;
+    std::size_t N_events=50000;
+    std::string process("q,qbar > e+,e-");
+
+    set_initial_state_type(initial_states::partonic);
+    set_phase_space_generator_type(phase_space_generators::uniform);
+    set_helicity_generator_type(helicity_generators::uniform);
+    set_colour_generator_type(colour_generators::uniform);
+    set_beam_energy(1,0.5*Ecm);
+    set_beam_energy(2,0.5*Ecm);
+
+    CM_algorithm<model_type,2,2>algo(process);
+    algo.load();
+    algo.construct_trees();
+
+    std::cerr<<"Checking summed subprocesses for "<<process<<"..........";
+    std::cerr.flush();
+    generator_type gen1(algo);
+    generator_type gen2(algo);
+    std::size_t n=gen1.processes();
+    if(gen2.sum_compatible_processes()!=2 or gen2.summed_processes()!=n-2)
+    {
+	std::cerr<<gen2.processes()<<" process generators and "<<gen2.summed_processes()<<" summed subprocesses encountered, 2 and "<<n-2<<" expected"<<std::endl;
+	return 1;
+    }
+    std::vector<value_type>w1,w2;
+    if(!fill_flavours(gen1,N_events,w1) or !fill_flavours(gen2,N_events,w2))
+    {
+	return 1;
+    }
+    MC_integral<value_type>sigma1=gen1.cross_section();
+    MC_integral<value_type>sigma2=gen2.cross_section();
+    value_type err=std::sqrt(sigma1.error*sigma1.error+sigma2.error*sigma2.error);
+    if(std::abs(sigma1.value-sigma2.value)>(value_type)5*err)
+    {
+	std::cerr<<"summed cross section "<<sigma2<<" incompatible with "<<sigma1<<std::endl;
+	return 1;
+    }
+    if(!(sigma2.error<sigma1.error))
+    {
+	std::cerr<<"summed cross section error "<<sigma2.error<<" not below "<<sigma1.error<<std::endl;
+	return 1;
+    }
+    value_type W1=w1[1]+w1[2]+w1[3]+w1[4];
+    value_type W2=w2[1]+w2[2]+w2[3]+w2[4];
+    for(int q=1;q<5;++q)
+    {
+	value_type f1=w1[q]/W1,f2=w2[q]/W2;
+	if(!(f2>(value_type)0) or std::abs(f1-f2)>(value_type)0.03)
+	{
+	    std::cerr<<"fraction "<<f2<<" of flavour "<<q<<" incompatible with "<<f1<<std::endl;
+	    return 1;
+	}
+    }
+    std::stringstream ss;
+    gen2.save(ss);
+    generator_type* gen3=generator_type::read(algo,ss);
+    if(gen3==NULL or gen3->processes()!=2 or gen3->summed_processes()!=n-2)
+    {
+	std::cerr<<"summed subprocesses not restored by reading the generator"<<std::endl;
+	return 1;
+    }
+    delete gen3;
+    std::cerr<<"..........done."<<std::endl;
+    return 0;
+}
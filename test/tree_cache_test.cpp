@@ -0,0 +1,175 @@
+//
+// This file is part of the CAMGEN library.
+// Copyright (C) 2013 Gijs van den Oord.
+// CAMGEN is licensed under the GNU GPL, version 2,
+// see COPYING for details.
+//
+
+#include <cstdio>
+#include <Camgen/license_print.h>
+#include <Camgen/CM_algo.h>
+#include <Camgen/stdrand.h>
+#include <Camgen/part_is.h>
+#include <Camgen/rambo.h>
+#include <QCDPbdhcfdc.h>
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Facility testing the binary cache of constructed vertex trees: trees read *
+ * from the cache must yield the same diagrams and amplitudes as the         *
+ * constructed ones, shared trees must remain shared, and caches written for *
+ * other subprocess lists must be rejected.                                  *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+using namespace Camgen;
+
+/* Compares the diagram counts and amplitudes of all subprocesses of the
+ * argument algorithms at a common phase space point: */
+
+template<std::size_t N_out>bool compare_trees(CM_algorithm<QCDPbdhcfdc,2,N_out>& algo1,CM_algorithm<QCDPbdhcfdc,2,N_out>& algo2)
+{
+    typedef QCDPbdhcfdc model_type;
+    typedef model_type::value_type value_type;
+    typedef vector<value_type,4> momentum_type;
+    typedef rambo<model_type,2,N_out,std::random> psgen_type;
+    typedef partonic_is<model_type,2> init_state;
+
+    if(algo1.n_processes()!=algo2.n_processes() or algo1.n_trees()!=algo2.n_trees() or algo1.count_nonempty_processes()!=algo2.count_nonempty_processes())
+    {
+	std::cerr<<algo2.n_processes()<<" subprocesses and "<<algo2.n_trees()<<" trees read, "<<algo1.n_processes()<<" and "<<algo1.n_trees()<<" expected"<<std::endl;
+	return false;
+    }
+    algo1.reset_process();
+    while(algo1.get_tree_iterator()->is_empty())
+    {
+	algo1.next_process();
+    }
+    psgen_type* psgen=psgen_type::create_instance(algo1.get_tree_iterator(),new init_state(50,50));
+    psgen->generate();
+    std::vector<momentum_type>p(N_out+2);
+    for(std::size_t i=0;i<N_out+2;++i)
+    {
+	p[i]=algo1.get_phase_space(i)->momentum();
+    }
+    delete psgen;
+    algo1.reset_process();
+    algo2.reset_process();
+    do
+    {
+	if(algo1.get_process_iterator()->get_flavours()!=algo2.get_process_iterator()->get_flavours())
+	{
+	    std::cerr<<"subprocess order differs"<<std::endl;
+	    return false;
+	}
+	if(algo1.get_tree_iterator()->is_empty())
+	{
+	    if(!algo2.get_tree_iterator()->is_empty())
+	    {
+		std::cerr<<"cached tree nonempty for empty subprocess"<<std::endl;
+		return false;
+	    }
+	    continue;
+	}
+	if(algo1.count_diagrams()!=algo2.count_diagrams())
+	{
+	    std::cerr<<algo2.count_diagrams()<<" diagrams read, "<<algo1.count_diagrams()<<" expected"<<std::endl;
+	    return false;
+	}
+	for(std::size_t i=0;i<N_out+2;++i)
+	{
+	    algo1.get_phase_space(i)->momentum()=p[i];
+	    algo2.get_phase_space(i)->momentum()=p[i];
+	}
+	value_type M1=algo1.evaluate_sum();
+	value_type M2=algo2.evaluate_sum();
+	if(!equals(M1,M2))
+	{
+	    std::cerr<<"cached tree amplitude "<<M2<<" does not match "<<M1<<" for ";
+	    algo1.get_process_iterator()->print(std::cerr);
+	    std::cerr<<std::endl;
+	    return false;
+	}
+    }
+    while(algo1.next_process() and algo2.next_process());
+    return true;
+}
+
+int main()
+{
+    license_print::disable();
+
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+    std::cout<<"testing vertex tree cache................................................"<<std::endl;
+    std::cout<<"-------------------------------------------------------------------------"<<std::endl;
+
+    std::string filename("tree_cache.dat");
+    {
+	std::string process("q,qbar > g,g");
+	std::cerr<<"Checking cached trees for "<<process<<"..........";
+	std::cerr.flush();
+	CM_algorithm<QCDPbdhcfdc,2,2>algo1(process);
+	algo1.load();
+	algo1.construct_trees();
+	algo1.share_equivalent_trees();
+	algo1.sum_spins();
+	algo1.sum_colours();
+	if(!algo1.save_trees(filename))
+	{
+	    std::cerr<<"could not write "<<filename<<std::endl;
+	    return 1;
+	}
+	CM_algorithm<QCDPbdhcfdc,2,2>algo2(process);
+	algo2.load();
+	if(!algo2.load_trees(filename))
+	{
+	    std::cerr<<"could not read "<<filename<<std::endl;
+	    return 1;
+	}
+	algo2.sum_spins();
+	algo2.sum_colours();
+	if(!compare_trees(algo1,algo2))
+	{
+	    return 1;
+	}
+	CM_algorithm<QCDPbdhcfdc,2,2>algo3("u,ubar > g,g");
+	algo3.load();
+	if(algo3.load_trees(filename))
+	{
+	    std::cerr<<"cache accepted for different subprocesses"<<std::endl;
+	    return 1;
+	}
+	std::cerr<<"..........done."<<std::endl;
+    }
+    {
+	std::string process("g,g > g,g,g");
+	std::cerr<<"Checking cached trees for "<<process<<"..........";
+	std::cerr.flush();
+	std::remove(filename.c_str());
+	CM_algorithm<QCDPbdhcfdc,2,3>algo1(process);
+	algo1.load();
+	if(algo1.construct_trees(filename))
+	{
+	    std::cerr<<"trees read from nonexistent cache"<<std::endl;
+	    return 1;
+	}
+	algo1.sum_spins();
+	algo1.sum_colours();
+	CM_algorithm<QCDPbdhcfdc,2,3>algo2(process);
+	algo2.load();
+	if(!algo2.construct_trees(filename))
+	{
+	    std::cerr<<"trees not read from "<<filename<<std::endl;
+	    return 1;
+	}
+	algo2.sum_spins();
+	algo2.sum_colours();
+	if(!compare_trees(algo1,algo2))
+	{
+	    return 1;
+	}
+	std::cerr<<"..........done."<<std::endl;
+    }
+    std::remove(filename.c_str());
+    return 0;
+}
+